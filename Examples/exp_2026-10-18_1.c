@@ -0,0 +1,104 @@
+//
+//  exp_2026-10-18_1.c
+//  A regression check of paged B-plus trees that removes keys until leaves become empty.
+//  Created by cosh.cage#hotmail.com on 10/18/26.
+//  License:  LGPLv3
+//  Platform: Cross Platform
+//  Copyright (C) 2026 John Cage
+//
+// This file is part of StoneValley.
+//
+// StoneValley is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free Software Foundation,
+// either version 3 of the License, or (at your option) any later version.
+//
+// StoneValley is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License along with StoneValley.
+// If not, see <https://www.gnu.org/licenses/>.
+//
+// Tips of use:
+// Put this C source file with StoneValley/src/*.* together and run:
+// $ cc *.c
+// $ ./a.out
+// Small pages and the least buffer pool make the tree much deeper than the pool,
+// so that parents of emptied leaves are evicted before they are unlinked.
+// The program prints PASS and returns 0 if every key survives a commit and a reopen.
+//
+#include <stdio.h>
+#include "svtree.h"
+
+#define FILE_NAME "exp_2026-10-18_1.bpt"
+#define PAGE_SIZE 72
+#define FRAMES    8
+#define KEYS      200000
+#define MORE      100000
+
+// Function: cbfcmp
+// Desc:     Compare two integers.
+// Return:   Please refer to the definition of callback function CBF_COMPARE.
+int cbfcmp(const void * px, const void * py)
+{
+	if (*(int *)px > *(int *)py) return CBF_CMP_GT;
+	if (*(int *)px < *(int *)py) return CBF_CMP_LT;
+	return CBF_CMP_EQUAL;
+}
+
+// Function: cbftvs
+// Desc:     Count keys and check their order.
+// Param:    pitem: Pointer to a key. param: Pointer to an array of a counter and the previous key.
+// Return:   CBF_CONTINUE only.
+int cbftvs(void * pitem, size_t param)
+{
+	long * p = (long *)param;
+	if (p[0] > 0 && *(int *)pitem <= p[1])
+		p[2] = 1; // Out of order.
+	p[1] = *(int *)pitem;
+	++p[0];
+	return CBF_CONTINUE;
+}
+
+// Function: main
+// Desc:     Program entry.
+// Return:   0: Passed. 1: Failed.
+int main(void)
+{
+	BPT_P bpt;
+	int i;
+	long cnt[3] = { 0 };
+	size_t num;
+
+	remove(FILE_NAME);
+	if (! treOpenBPTP(&bpt, FILE_NAME, sizeof(int), PAGE_SIZE, FRAMES))
+		return 1;
+	for (i = 0; i < KEYS; ++i)
+		treInsertBPTP(&bpt, &i, cbfcmp);
+	// Remove 9 of every 10 ranges of 1000 keys to empty whole leaves.
+	for (i = 0; i < KEYS; ++i)
+		if (0 != i / 1000 % 10)
+			treRemoveBPTP(&bpt, &i, cbfcmp);
+	treCommitBPTP(&bpt);
+	// Pages freed by the commit are reused here.
+	for (i = KEYS; i < KEYS + MORE; ++i)
+		treInsertBPTP(&bpt, &i, cbfcmp);
+	treCommitBPTP(&bpt);
+	treCloseBPTP(&bpt);
+
+	if (! treOpenBPTP(&bpt, FILE_NAME, 0, 0, FRAMES))
+		return 1;
+	num = bpt.num;
+	treTraverseKeyBPTP(&bpt, cbftvs, (size_t)cnt);
+	treCloseBPTP(&bpt);
+	remove(FILE_NAME);
+
+	printf("num = %lu, traversed = %ld, expected = %d.\n", (unsigned long)num, cnt[0], KEYS / 10 + MORE);
+	if (num != (size_t)(KEYS / 10 + MORE) || cnt[0] != (long)num || 0 != cnt[2])
+	{
+		printf("FAIL\n");
+		return 1;
+	}
+	printf("PASS\n");
+	return 0;
+}
@@ -0,0 +1,142 @@
+//
+//  exp_2026-10-18_2.c
+//  A regression check of B-plus trees that are loaded from sorted keys in one batch.
+//  Range scans through cursors are checked on trees built both ways.
+//  Created by cosh.cage#hotmail.com on 10/18/26.
+//  License:  LGPLv3
+//  Platform: Cross Platform
+//  Copyright (C) 2026 John Cage
+//
+// This file is part of StoneValley.
+//
+// StoneValley is free software: you can redistribute it and/or modify it under
+// the terms of the GNU Lesser General Public License as published by the Free Software Foundation,
+// either version 3 of the License, or (at your option) any later version.
+//
+// StoneValley is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+// without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License along with StoneValley.
+// If not, see <https://www.gnu.org/licenses/>.
+//
+// Tips of use:
+// Put this C source file with StoneValley/src/*.* together and run:
+// $ cc *.c
+// $ ./a.out
+// Keys are inserted into empty trees by function treBatchInsertBPT for every degree and length below.
+// Lengths that are multiples of (degree - 1) fill every leaf exactly.
+// The same range scans run on a tree built by function treInsertBPT and on one built by function treBulkLoadBPT.
+// The program prints PASS and returns 0 if every key can be found and every scan returns the right keys.
+//
+#include <stdio.h>
+#include "svtree.h"
+
+#define MAX_DEGREE 9
+#define MAX_KEYS   400
+
+int a[MAX_KEYS];
+PUCHAR keys[MAX_KEYS];
+
+// Function: cbfcmp
+// Desc:     Compare two integers.
+// Return:   Please refer to the definition of callback function CBF_COMPARE.
+int cbfcmp(const void * px, const void * py)
+{
+	if (*(int *)px > *(int *)py) return CBF_CMP_GT;
+	if (*(int *)px < *(int *)py) return CBF_CMP_LT;
+	return CBF_CMP_EQUAL;
+}
+
+// Function: CheckRanges
+// Desc:     Scan ranges [lo, hi] through a cursor and compare the result to the keys that fall into it.
+// Param:    pbpt: Pointer to a tree that holds the first num keys. num: Number of keys in the tree.
+// Return:   Number of ranges that went wrong.
+long CheckRanges(P_BPT pbpt, size_t num)
+{
+	BPTCURSOR cur;
+	PUCHAR buf[7];
+	int lo, hi, exp;
+	size_t n, i;
+	long wrong = 0;
+	// Bounds run one step beyond both ends. Odd bounds lie between keys.
+	for (lo = -1; lo <= (int)(num * 2); lo += 3)
+	{
+		for (hi = lo; hi <= (int)(num * 2); hi += 5)
+		{
+			exp = lo <= 0 ? 0 : (lo + 1) / 2 * 2;
+			treBPTCursorSeek(&cur, pbpt, &lo, cbfcmp);
+			while (0 != (n = treBPTCursorFetch(&cur, buf, 7, &hi, cbfcmp)))
+			{
+				for (i = 0; i < n; ++i, exp += 2)
+					if (*(int *)buf[i] != exp)
+						break;
+				if (i < n)
+					break;
+			}
+			// The scan shall stop right after the last key that is not greater than hi.
+			if (0 != n || (exp <= hi && exp < (int)(num * 2)))
+				++wrong;
+		}
+	}
+	return wrong;
+}
+
+// Function: main
+// Desc:     Program entry.
+// Return:   0: Passed. 1: Failed.
+int main(void)
+{
+	BPT bpt;
+	size_t degree, num, i;
+	long missed = 0, wrong = 0;
+
+	for (i = 0; i < MAX_KEYS; ++i)
+	{
+		a[i] = (int)(i * 2);
+		keys[i] = (PUCHAR)&a[i];
+	}
+	for (degree = 3; degree <= MAX_DEGREE; ++degree)
+	{
+		for (num = 1; num <= MAX_KEYS; ++num)
+		{
+			treInitBPT(&bpt);
+			if (! treBatchInsertBPT(&bpt, degree, keys, num, cbfcmp))
+			{
+				printf("Allocation failure.\n");
+				return 1;
+			}
+			for (i = 0; i < num; ++i)
+			{
+				if (NULL == treSearchDataBPT(&bpt, &a[i], cbfcmp))
+				{
+					if (0 == missed++)
+						printf("degree = %lu, num = %lu: key %d is missing.\n", (unsigned long)degree, (unsigned long)num, a[i]);
+				}
+			}
+			treFreeBPT(&bpt);
+		}
+	}
+	// An insert-built tree and a bulk-loaded tree shall give the same scans.
+	for (degree = 3; degree <= MAX_DEGREE; ++degree)
+	{
+		treInitBPT(&bpt);
+		for (i = 0; i < MAX_KEYS; ++i)
+			treInsertBPT(&bpt, degree, keys[i], cbfcmp);
+		wrong += CheckRanges(&bpt, MAX_KEYS);
+		treFreeBPT(&bpt);
+		treInitBPT(&bpt);
+		treBulkLoadBPT(&bpt, degree, keys, MAX_KEYS);
+		wrong += CheckRanges(&bpt, MAX_KEYS);
+		treFreeBPT(&bpt);
+	}
+
+	printf("missed = %ld, wrong ranges = %ld.\n", missed, wrong);
+	if (0 != missed || 0 != wrong)
+	{
+		printf("FAIL\n");
+		return 1;
+	}
+	printf("PASS\n");
+	return 0;
+}
@@ -2,7 +2,7 @@
  * Name:        svarray.c
  * Description: Sized array.
  * Author:      cosh.cage#hotmail.com
- * File ID:     0306170948B0806261100L00901
+ * File ID:     0306170948B1018262252L01492
  * License:     LGPLv3
  * Copyright (C) 2017-2026 John Cage
  *
@@ -21,8 +21,8 @@
  *
  */
 
-#include <stdlib.h> /* Using function malloc, calloc, free. */
-#include <string.h> /* Using function memcpy, memmove, memcmp. */
+#include <stdlib.h> /* Using function malloc, calloc, realloc, free. */
+#include <string.h> /* Using function memcpy, memmove, memcmp, memset. */
 #include "svstring.h"
 
 /* File level macro definitions go here. */
@@ -310,8 +310,8 @@ void strRemoveItemArrayZ(P_ARRAY_Z parrz, size_t size, size_t index, bool bshrin
  *       size Size of each element in the array.
  *     cbfcmp Pointer to a function that compares two elements.
  *            Please refer to the type definition CBF_COMPARE in svdef.h.
- *    bstable Input [true]  to sort an array by using stable   sort algorithm.
- *            Input [false] to sort an array by using unstable sort algorithm.
+ *    bstable Input [true]  to sort an array by using stable   sort algorithm, which is svTimSort.
+ *            Input [false] to sort an array by using unstable sort algorithm, which is svIntroSort.
  * Return value:  If sorting succeeded, this function would return a pointer to the first element to the array,
  *                otherwise, this function would return value NULL.
  * Caution:       Address of parrz Must Be Allocated first.
@@ -319,9 +319,9 @@ void strRemoveItemArrayZ(P_ARRAY_Z parrz, size_t size, size_t index, bool bshrin
 void * strSortArrayZ(P_ARRAY_Z parrz, size_t size, CBF_COMPARE cbfcmp, bool bstable)
 {
 	if (bstable)
-		return svMergeSort(parrz->pdata, strLevelArrayZ(parrz), size, cbfcmp);
+		return svTimSort(parrz->pdata, strLevelArrayZ(parrz), size, cbfcmp);
 	else
-		return svQuickSort(parrz->pdata, strLevelArrayZ(parrz), size, cbfcmp);
+		return svIntroSort(parrz->pdata, strLevelArrayZ(parrz), size, cbfcmp);
 }
 
 /* Function name: strMergeSortedArrayZ
@@ -448,6 +448,109 @@ void * strBinarySearchArrayZ_O(P_ARRAY_Z parrz, const void * pkey, size_t size,
 	return svBinarySearch(pkey, parrz->pdata, strLevelArrayZ(parrz), size, cbfcmp);
 }
 
+/* Function name: strEytzingerArrayZ
+ * Description:   Copy a sorted array into Eytzinger layout.
+ * Parameters:
+ *      pdest Pointer to the destination array.
+ *       psrc Pointer to the source array that has been sorted increasingly.
+ *       size Size of element in both two arrays.
+ * Return value:  pdest->pdata
+ * Caution:       Number of two arrays shall equal to each other.
+ *                Address of pdest and psrc Must Be Allocated first.
+ *                Destination and source shall not overlap.
+ * Tip:           Eytzinger layout stores an implicit complete binary search tree in breadth first order.
+ *                Element k has children 2k and 2k + 1 counting from 1, so that the first levels of the tree
+ *                share a few cache lines and the children of each node lie side by side.
+ *                The array is read only after being built. Search it with strSearchEytzingerArrayZ.
+ *                Put satellite data in elements, because elements are reordered.
+ */
+void * strEytzingerArrayZ(P_ARRAY_Z pdest, P_ARRAY_Z psrc, size_t size)
+{
+	REGISTER size_t i, k = 1, n = strLevelArrayZ(psrc);
+	REGISTER PUCHAR ps = psrc->pdata;
+	if (0 == n)
+		return pdest->pdata;
+	/* Start at the leftmost node. */
+	while ((k << 1) <= n)
+		k <<= 1;
+	/* Visit nodes in order and fill them with sorted elements. */
+	for (i = 0; i < n; ++i, ps += size)
+	{
+		memcpy(pdest->pdata + (k - 1) * size, ps, size);
+		if ((k << 1) + 1 <= n)
+		{	/* The leftmost node in the right subtree. */
+			k = (k << 1) + 1;
+			while ((k << 1) <= n)
+				k <<= 1;
+		}
+		else
+		{	/* The first ancestor whose left subtree contains k. */
+			while (k & 1)
+				k >>= 1;
+			k >>= 1;
+		}
+	}
+	return pdest->pdata;
+}
+
+/* Function name: strSearchEytzingerArrayZ
+ * Description:   Search an array in Eytzinger layout by given condition.
+ * Parameters:
+ *      parrz Pointer to a sized array that is built by function strEytzingerArrayZ.
+ *       pkey Pointer to the object that serves as key for searching.
+ *       size Size of each element in the array.
+ *     cbfcmp Pointer to a function that compares two elements.
+ *            The left pointer of function cbfcmp always points to the key.
+ *            Please refer to the type definition of CBF_COMPARE in svdef.h.
+ *     method An enumeration indicates the method of searching. Refer to svBinarySearchDispatch.
+ * Return value:  A pointer to an entry in the array that meets the condition.
+ *                If the value of parameter method does not belong to BSearch
+ *                or function cannot find the key, function will return NULL.
+ * Caution:       Address of parrz Must Be Allocated first.
+ * Tip:           Each step descends to a child without branching on comparison results.
+ *                The path is recorded in bits of the node index and the answer is recovered from it at the end:
+ *                the last node where the search went left is the first element that is greater than (or equal to) the key,
+ *                the last node where the search went right is the last element that is less than (or equal to) the key.
+ *                Descendants four levels below are prefetched by SV_PREFETCH, which is defined in svdef.h.
+ *                To find an exact match, use EBS_FIRST_GREATER_THAN_OR_EQUAL_TO_KEY and compare the result with the key.
+ */
+void * strSearchEytzingerArrayZ(P_ARRAY_Z parrz, const void * pkey, size_t size, CBF_COMPARE cbfcmp, BSearch method)
+{
+	REGISTER size_t k = 1, n = strLevelArrayZ(parrz);
+	REGISTER int t;
+	switch (method)
+	{
+	case EBS_FIRST_GREATER_THAN_OR_EQUAL_TO_KEY:
+	case EBS_LAST_LESS_THAN_KEY:
+		t = 1; /* Go right if key > element. */
+		break;
+	case EBS_FIRST_GREATER_THAN_KEY:
+	case EBS_LAST_LESS_THAN_OR_EQUAL_TO_KEY:
+		t = 0; /* Go right if key >= element. */
+		break;
+	default:
+		return NULL; /* Argument error. */
+	}
+	while (k <= n)
+	{
+		if (k <= (n >> 4))
+			SV_PREFETCH(parrz->pdata + ((k << 4) - 1) * size);
+		k = (k << 1) + (size_t)(cbfcmp(pkey, parrz->pdata + (k - 1) * size) >= t);
+	}
+	if (EBS_FIRST_GREATER_THAN_OR_EQUAL_TO_KEY == method || EBS_FIRST_GREATER_THAN_KEY == method)
+	{	/* Strip the right turns at the tail of the path and the last left turn. */
+		while (k & 1)
+			k >>= 1;
+	}
+	else
+	{	/* Strip the left turns at the tail of the path and the last right turn. */
+		while (0 == (k & 1))
+			k >>= 1;
+	}
+	k >>= 1;
+	return 0 == k ? NULL : parrz->pdata + (k - 1) * size;
+}
+
 /* Function name: strReverseArrayZ
  * Description:   Reverse a fixed-size array.
  * Parameters:
@@ -492,6 +595,8 @@ void strReverseArrayZ(P_ARRAY_Z parrz, void * ptemp, size_t size)
  *                size_t index = 0; PUCHAR ptr = (PUCHAR)strGetLimitationArrayZ(&arr, size, cbfcmp, true);
  *                if (NULL != ptr) index = (ptr - arr.pdata) / size;
  *                Or simply use: i = strIndexOfArrayZ(&arr, ptr, size);
+ *                To get a median, a percentile or the least k elements rather than a limit,
+ *                please call svNthElement or svPartialSort instead of sorting the whole array.
  */
 void * strGetLimitationArrayZ(P_ARRAY_Z parrz, size_t size, CBF_COMPARE cbfcmp, bool bmax, bool brev)
 {
@@ -533,30 +638,148 @@ void * strGetLimitationArrayZ(P_ARRAY_Z parrz, size_t size, CBF_COMPARE cbfcmp,
  * Description:   Delete repeated elements in an array.
  * Parameters:
  *      parrz Pointer to a sized array.
- *      ptemp Pointer to a buffer whose size equals to each size of the element in the array.
+ *      ptemp Unused. It is kept for compatibility.
  *       size Size of each element in the array.
- *     cbfmch Pointer to a function that matches ptemp to any element in array.
+ *     cbfmch Pointer to a function that matches any element in array to an element that is kept.
  *            This function returns CBF_CMP_EQUAL when data match or a non zero value when data mismatch.
  *            Please refer to svdef.h to see more details about type CBF_COMPARE.
  *    bshrink Input true to shrink array, otherwise input false.
  * Return value:  N/A.
  * Caution:       Address of parrz Must Be Allocated first.
- *                Users shall manage the buffer that ptemp points at.
- *                The size of the buffer of ptemp pointed shall equal to parameter size.
+ * Tip:           The first one of repeated elements is kept and the order of elements is preserved.
+ *                Elements are compacted in a single pass, but each one is matched to all kept ones,
+ *                which costs O(n^2) comparisons. For large arrays, users may call strSortUniqueArrayZ,
+ *                strStableUniqueArrayZ or hshUniqueArrayZ instead.
  */
 void strUniqueArrayZ(P_ARRAY_Z parrz, void * ptemp, size_t size, CBF_COMPARE cbfmch, bool bshrink)
 {
-	REGISTER size_t i,  j;
+	REGISTER size_t i, j, k;
 	REGISTER PUCHAR px, py;
-	for (i = 0, px = parrz->pdata; i < strLevelArrayZ(parrz); ++i, px += size)
+	DISUSE(ptemp);
+	for (i = j = 0, px = parrz->pdata; i < strLevelArrayZ(parrz); ++i, px += size)
 	{
-		memcpy(ptemp, px, size);
-		for (j = i + 1, py = parrz->pdata + j * size; j < strLevelArrayZ(parrz); ++j, py += size)
-			if (CBF_CMP_EQUAL == cbfmch(py, ptemp))
-				strRemoveItemArrayZ(parrz, size, j, bshrink), --j, py -= size;
+		for (k = 0, py = parrz->pdata; k < j; ++k, py += size)
+			if (CBF_CMP_EQUAL == cbfmch(px, py))
+				break;
+		if (k == j)
+		{	/* px is unique so far. Move it next to kept elements. */
+			if (py != px)
+				memcpy(py, px, size);
+			++j;
+		}
+	}
+	if (j < strLevelArrayZ(parrz))
+	{
+		parrz->num = j;
+		if (bshrink)
+			strResizeArrayZ(parrz, j, size);
 	}
 }
 
+/* Function name: strSortUniqueArrayZ
+ * Description:   Sort an array and delete repeated elements in it.
+ * Parameters:
+ *      parrz Pointer to a sized array.
+ *       size Size of each element in the array.
+ *     cbfcmp Pointer to a function that compares two elements.
+ *            Please refer to the type definition CBF_COMPARE in svdef.h.
+ *    bshrink Input true to shrink array, otherwise input false.
+ * Return value:  Pointer to the first element to the array. NULL indicates a sorting failure that leaves elements unaltered.
+ * Caution:       Address of parrz Must Be Allocated first.
+ *                Elements are left sorted. It is unspecified which one of repeated elements is kept.
+ * Tip:           It costs O(n log n) comparisons for sorting and O(n) comparisons for compaction.
+ */
+void * strSortUniqueArrayZ(P_ARRAY_Z parrz, size_t size, CBF_COMPARE cbfcmp, bool bshrink)
+{
+	REGISTER size_t i, j;
+	REGISTER PUCHAR px, py;
+	if (strLevelArrayZ(parrz) < 2)
+		return parrz->pdata;
+	if (NULL == strSortArrayZ(parrz, size, cbfcmp, false))
+		return NULL;
+	/* py points to the last kept element. */
+	for (i = j = 1, py = parrz->pdata, px = py + size; i < strLevelArrayZ(parrz); ++i, px += size)
+	{
+		if (CBF_CMP_EQUAL != cbfcmp(py, px))
+		{
+			py += size;
+			if (py != px)
+				memcpy(py, px, size);
+			++j;
+		}
+	}
+	if (j < strLevelArrayZ(parrz))
+	{
+		parrz->num = j;
+		if (bshrink)
+			strResizeArrayZ(parrz, j, size);
+	}
+	return parrz->pdata;
+}
+
+/* Function name: strStableUniqueArrayZ
+ * Description:   Delete repeated elements in an array and preserve the order of elements.
+ * Parameters:
+ *      parrz Pointer to a sized array.
+ *       size Size of each element in the array.
+ *     cbfcmp Pointer to a function that compares two elements.
+ *            Please refer to the type definition CBF_COMPARE in svdef.h.
+ *    bshrink Input true to shrink array, otherwise input false.
+ * Return value:  Pointer to the first element to the array. NULL indicates an allocation failure that leaves elements unaltered.
+ * Caution:       Address of parrz Must Be Allocated first.
+ * Tip:           The first one of repeated elements is kept like strUniqueArrayZ does.
+ *                Copies of elements tagged with their indices are sorted stably to find first ones,
+ *                then the array is compacted in a single pass. It costs O(n log n) comparisons
+ *                and O(n * (size + sizeof(size_t))) extra memory.
+ */
+void * strStableUniqueArrayZ(P_ARRAY_Z parrz, size_t size, CBF_COMPARE cbfcmp, bool bshrink)
+{
+	REGISTER size_t i, j;
+	REGISTER PUCHAR px, py;
+	PUCHAR prec, pkeep;
+	const size_t n = strLevelArrayZ(parrz), stride = ALIGN_SIZET(size) + sizeof(size_t);
+	if (n < 2)
+		return parrz->pdata;
+	/* Records of [element|index] followed by a flag for each element. */
+	if (NULL == (prec = (PUCHAR) malloc(n * stride + n)))
+		return NULL;
+	pkeep = prec + n * stride;
+	for (i = 0, px = parrz->pdata, py = prec; i < n; ++i, px += size, py += stride)
+	{
+		memcpy(py, px, size);
+		*(size_t *)(py + ALIGN_SIZET(size)) = i;
+		pkeep[i] = false;
+	}
+	if (NULL == svMergeSort(prec, n, stride, cbfcmp))
+	{
+		free(prec);
+		return NULL;
+	}
+	/* Stability puts the first one of repeated elements at the head of its run. */
+	pkeep[*(size_t *)(prec + ALIGN_SIZET(size))] = true;
+	for (i = 1, py = prec + stride; i < n; ++i, py += stride)
+		if (CBF_CMP_EQUAL != cbfcmp(py - stride, py))
+			pkeep[*(size_t *)(py + ALIGN_SIZET(size))] = true;
+	for (i = j = 0, px = py = parrz->pdata; i < n; ++i, px += size)
+	{
+		if (pkeep[i])
+		{
+			if (py != px)
+				memcpy(py, px, size);
+			py += size;
+			++j;
+		}
+	}
+	free(prec);
+	if (j < n)
+	{
+		parrz->num = j;
+		if (bshrink)
+			strResizeArrayZ(parrz, j, size);
+	}
+	return parrz->pdata;
+}
+
 /* Function name: strPermuteArrayZ
  * Description:   Permute a fixed size array in dictionary order.
  * Parameters:
@@ -899,3 +1122,371 @@ int strZSearchArrayZ(P_ARRAY_Z parrtxt, P_ARRAY_Z parrptn, size_t size, CBF_TRAV
 	return CBF_CONTINUE;
 }
 
+/* Function name: strInitVector
+ * Description:   Initialize a vector.
+ * Parameters:
+ *       pvec Pointer to the vector you want to initialize.
+ *        cap Number of elements to reserve.
+ *       size Size of each element.
+ * Return value:  Pointer to the buffer of the vector.
+ *                NULL indicates that cap is 0 or an allocation failure occurred. The vector is empty either way.
+ * Caution:       Address of pvec Must Be Allocated first.
+ */
+void * strInitVector(P_VECTOR pvec, size_t cap, size_t size)
+{
+	pvec->arrz.num   = 0;
+	pvec->arrz.pdata = NULL;
+	pvec->cap = 0;
+	if (0 != cap * size && NULL != (pvec->arrz.pdata = (PUCHAR) malloc(cap * size)))
+		pvec->cap = cap;
+	return pvec->arrz.pdata;
+}
+
+/* Function name: strFreeVector
+ * Description:   Deallocate a vector.
+ * Parameter:
+ *       pvec Pointer to the vector you want to free.
+ * Return value:  N/A.
+ * Caution:       Address of pvec Must Be Allocated first.
+ */
+void strFreeVector(P_VECTOR pvec)
+{
+	if (NULL != pvec->arrz.pdata)
+		free(pvec->arrz.pdata);
+	pvec->arrz.pdata = NULL;
+	pvec->arrz.num = pvec->cap = 0;
+}
+
+/* Function name: strReserveVector
+ * Description:   Make a vector hold at least a number of elements without reallocation.
+ * Parameters:
+ *       pvec Pointer to a vector.
+ *        cap Number of elements.
+ *       size Size of each element.
+ *            If size equaled to 0, function would return NULL.
+ * Return value:  Pointer to the buffer of the vector. NULL indicates an allocation failure that leaves the vector intact.
+ * Caution:       Address of pvec Must Be Allocated first.
+ *                Size of vector never shrinks by calling this function.
+ */
+void * strReserveVector(P_VECTOR pvec, size_t cap, size_t size)
+{
+	if (0 == size)
+		return NULL;
+	if (cap > pvec->cap)
+	{
+		REGISTER PUCHAR pnew;
+		if (cap > (~(size_t)0) / size || NULL == (pnew = (PUCHAR) realloc(pvec->arrz.pdata, cap * size)))
+			return NULL;
+		pvec->arrz.pdata = pnew;
+		pvec->cap = cap;
+	}
+	return pvec->arrz.pdata;
+}
+
+/* Function name: strResizeVector
+ * Description:   Alter the number of elements in a vector.
+ * Parameters:
+ *       pvec Pointer to a vector.
+ *        num Number of elements.
+ *       size Size of each element.
+ * Return value:  Pointer to the buffer of the vector. NULL indicates an allocation failure that leaves the vector intact.
+ * Caution:       Address of pvec Must Be Allocated first.
+ *                New elements are not initialized.
+ * Tip:           Capacity grows at least twice each time, so that a sequence of resizing is amortized O(1) for each element.
+ *                Capacity is kept while the vector shrinks. Call strShrinkVector to release spare elements.
+ */
+void * strResizeVector(P_VECTOR pvec, size_t num, size_t size)
+{
+	if (num > pvec->cap && NULL == strReserveVector(pvec, num > 2 * pvec->cap ? num : 2 * pvec->cap, size))
+		return NULL;
+	pvec->arrz.num = num;
+	return pvec->arrz.pdata;
+}
+
+/* Function name: strShrinkVector
+ * Description:   Release spare elements of a vector.
+ * Parameters:
+ *       pvec Pointer to a vector.
+ *       size Size of each element.
+ * Return value:  Pointer to the buffer of the vector. NULL if the vector is empty.
+ * Caution:       Address of pvec Must Be Allocated first.
+ *                If reallocation failed, the vector would keep its capacity.
+ */
+void * strShrinkVector(P_VECTOR pvec, size_t size)
+{
+	if (0 == strLevelArrayZ(&pvec->arrz))
+		strFreeVector(pvec);
+	else if (strLevelArrayZ(&pvec->arrz) < pvec->cap)
+	{
+		REGISTER PUCHAR pnew = (PUCHAR) realloc(pvec->arrz.pdata, strLevelArrayZ(&pvec->arrz) * size);
+		if (NULL != pnew)
+		{
+			pvec->arrz.pdata = pnew;
+			pvec->cap = strLevelArrayZ(&pvec->arrz);
+		}
+	}
+	return pvec->arrz.pdata;
+}
+
+/* Function name: strPushVector
+ * Description:   Append an element to a vector.
+ * Parameters:
+ *       pvec Pointer to a vector.
+ *      pitem Pointer to the element. Input NULL to append an uninitialized element.
+ *       size Size of each element.
+ * Return value:  Pointer to the appended element in the vector. NULL indicates an allocation failure.
+ * Caution:       Address of pvec Must Be Allocated first.
+ *                pitem shall not point into the vector, since the buffer may move.
+ * Usage:         VECTOR vec;
+ *                int i;
+ *                strInitVector(&vec, 0, sizeof(int));
+ *                for (i = 0; i < 100; ++i)
+ *                    strPushVector(&vec, &i, sizeof(int));
+ *                strSortArrayZ(&vec.arrz, sizeof(int), svCBFCompareSignedInteger, false);
+ *                strFreeVector(&vec);
+ */
+void * strPushVector(P_VECTOR pvec, const void * pitem, size_t size)
+{
+	REGISTER PUCHAR pdat;
+	if (NULL == strResizeVector(pvec, strLevelArrayZ(&pvec->arrz) + 1, size))
+		return NULL;
+	pdat = _P_ARRAY_Z_ITEM_M(&pvec->arrz, size, strLevelArrayZ(&pvec->arrz) - 1);
+	if (NULL != pitem)
+		memcpy(pdat, pitem, size);
+	return pdat;
+}
+
+/* Function name: strPopVector
+ * Description:   Remove the last element from a vector.
+ * Parameters:
+ *       pvec Pointer to a vector.
+ *      pitem Pointer to a buffer that receives the element. Input NULL to drop the element.
+ *       size Size of each element.
+ * Return value:  true:  Succeeded.
+ *                false: The vector is empty.
+ * Caution:       Address of pvec Must Be Allocated first.
+ */
+bool strPopVector(P_VECTOR pvec, void * pitem, size_t size)
+{
+	if (0 == strLevelArrayZ(&pvec->arrz))
+		return false;
+	--pvec->arrz.num;
+	if (NULL != pitem)
+		memcpy(pitem, _P_ARRAY_Z_ITEM_M(&pvec->arrz, size, strLevelArrayZ(&pvec->arrz)), size);
+	return true;
+}
+
+/* Number of symbols in an Aho-Corasick automaton. */
+#define _AC_SYMS (UCHAR_MAX + 1)
+/* No pattern ends at a state. */
+#define _AC_NONE (~(size_t)0)
+
+/* Function name: strInitAhoCorasick
+ * Description:   Build an Aho-Corasick automaton from a set of patterns.
+ * Parameters:
+ *        pac Pointer to an automaton you want to initialize.
+ *    parrptn Pointer to a sized array of patterns. Each element of it is an ARRAY_Z that holds bytes of a pattern.
+ * Return value:  true:  Succeeded.
+ *                false: Allocation failure. pac needs not to be freed.
+ * Caution:       Address of pac and parrptn Must Be Allocated first.
+ *                Empty patterns never match. Among identical patterns, only the first one is reported.
+ *                The transition table takes (UCHAR_MAX + 1) * sizeof(size_t) bytes for each state,
+ *                and there are at most one more states than the total length of patterns.
+ * Tip:           Failure links are resolved into the transition table while building,
+ *                so that feeding the automaton takes exactly one table lookup for each byte of text.
+ *                Elements that are wider than bytes can be matched as bytes,
+ *                then users shall drop matches whose offsets are not multiples of the size of elements.
+ */
+bool strInitAhoCorasick(P_AHOCORASICK pac, P_ARRAY_Z parrptn)
+{
+	REGISTER size_t i, j, c, s;
+	REGISTER size_t * ptrans, * pouts;
+	size_t * pfail, * pqueue;
+	size_t head, tail;
+	DISUSE(strInitArrayZ(&pac->outs, 0, sizeof(size_t)));
+	if (NULL == strInitArrayZ(&pac->trans, _AC_SYMS, sizeof(size_t)))
+		return false;
+	memset(pac->trans.pdata, 0, _AC_SYMS * sizeof(size_t));
+	pac->nstat = 1;
+	pac->state = pac->pos = 0;
+	/* Build the goto function as a trie. 0 means no transition, since the root is never a child. */
+	for (i = 0; i < strLevelArrayZ(parrptn); ++i)
+	{
+		REGISTER P_ARRAY_Z pptn = (P_ARRAY_Z) _P_ARRAY_Z_ITEM_M(parrptn, sizeof(ARRAY_Z), i);
+		for (s = 0, j = 0; j < strLevelArrayZ(pptn); ++j)
+		{
+			c = pptn->pdata[j];
+			if (0 == ((size_t *)pac->trans.pdata)[s * _AC_SYMS + c])
+			{
+				if (pac->nstat * _AC_SYMS == strLevelArrayZ(&pac->trans))
+				{	/* Double the table. */
+					if (NULL == strResizeArrayZ(&pac->trans, 2 * pac->nstat * _AC_SYMS, sizeof(size_t)))
+						goto Lbl_Allocation_Failure;
+					memset(pac->trans.pdata + pac->nstat * _AC_SYMS * sizeof(size_t), 0, pac->nstat * _AC_SYMS * sizeof(size_t));
+				}
+				((size_t *)pac->trans.pdata)[s * _AC_SYMS + c] = pac->nstat++;
+			}
+			s = ((size_t *)pac->trans.pdata)[s * _AC_SYMS + c];
+		}
+	}
+	if (NULL == strResizeArrayZ(&pac->trans, pac->nstat * _AC_SYMS, sizeof(size_t)))
+		goto Lbl_Allocation_Failure;
+	if (NULL == strResizeArrayZ(&pac->outs, 3 * pac->nstat, sizeof(size_t)))
+		goto Lbl_Allocation_Failure;
+	if (NULL == (pfail = (size_t *) malloc(2 * pac->nstat * sizeof(size_t))))
+		goto Lbl_Allocation_Failure;
+	pqueue = pfail + pac->nstat;
+	ptrans = (size_t *)pac->trans.pdata;
+	pouts  = (size_t *)pac->outs.pdata;
+	for (s = 0; s < pac->nstat; ++s)
+	{
+		pouts[3 * s]     = _AC_NONE;
+		pouts[3 * s + 1] = 0;
+	}
+	/* Mark ends of patterns and depths along them. */
+	for (i = strLevelArrayZ(parrptn); i > 0; --i)
+	{	/* Walk backward so that the first one of identical patterns wins. */
+		REGISTER P_ARRAY_Z pptn = (P_ARRAY_Z) _P_ARRAY_Z_ITEM_M(parrptn, sizeof(ARRAY_Z), i - 1);
+		for (s = 0, j = 0; j < strLevelArrayZ(pptn); ++j)
+		{
+			s = ptrans[s * _AC_SYMS + pptn->pdata[j]];
+			pouts[3 * s + 2] = j + 1;
+		}
+		if (0 != s)
+			pouts[3 * s] = i - 1;
+	}
+	pouts[2] = 0;
+	/* Breadth first search resolves failure links into rows of the table.
+	 * A row is only altered when its state is dequeued, so nonzero entries met there are children.
+	 */
+	head = tail = 0;
+	pfail[0] = 0;
+	for (c = 0; c < _AC_SYMS; ++c)
+		if (0 != (s = ptrans[c]))
+		{
+			pfail[s] = 0;
+			pqueue[tail++] = s;
+		}
+	while (head < tail)
+	{
+		REGISTER size_t u = pqueue[head++];
+		REGISTER size_t * prow = &ptrans[u * _AC_SYMS], * pfrow = &ptrans[pfail[u] * _AC_SYMS];
+		/* Dictionary suffix link points to the nearest state on the failure chain where a pattern ends. */
+		pouts[3 * u + 1] = _AC_NONE != pouts[3 * pfail[u]] ? pfail[u] : pouts[3 * pfail[u] + 1];
+		for (c = 0; c < _AC_SYMS; ++c)
+		{
+			if (0 != (s = prow[c]))
+			{
+				pfail[s] = pfrow[c];
+				pqueue[tail++] = s;
+			}
+			else
+				prow[c] = pfrow[c];
+		}
+	}
+	free(pfail);
+	return true;
+Lbl_Allocation_Failure:
+	strFreeAhoCorasick(pac);
+	return false;
+}
+
+/* Function name: strFreeAhoCorasick
+ * Description:   Deallocate an Aho-Corasick automaton.
+ * Parameter:
+ *        pac Pointer to an automaton.
+ * Return value:  N/A.
+ * Caution:       Address of pac Must Be Allocated first.
+ */
+void strFreeAhoCorasick(P_AHOCORASICK pac)
+{
+	if (NULL != pac->trans.pdata)
+		strFreeArrayZ(&pac->trans);
+	if (NULL != pac->outs.pdata)
+		strFreeArrayZ(&pac->outs);
+	pac->trans.pdata = pac->outs.pdata = NULL;
+	pac->nstat = pac->state = pac->pos = 0;
+}
+
+/* Function name: strResetAhoCorasick
+ * Description:   Restart the stream of an Aho-Corasick automaton.
+ * Parameter:
+ *        pac Pointer to an automaton.
+ * Return value:  N/A.
+ * Caution:       Address of pac Must Be Allocated first.
+ * Tip:           Call this function between independent texts, such as lines of a log,
+ *                so that no match would span them and offsets would count from 0 again.
+ */
+void strResetAhoCorasick(P_AHOCORASICK pac)
+{
+	pac->state = pac->pos = 0;
+}
+
+/* Function name: strFeedAhoCorasick
+ * Description:   Feed bytes of a stream into an Aho-Corasick automaton and report matches.
+ * Parameters:
+ *        pac Pointer to an automaton.
+ *       pbuf Pointer to bytes.
+ *        num Number of bytes.
+ *     cbftvs Callback function. Every time cbftvs is called, pitem points to an ACMATCH structure.
+ *            Matches that end at the same byte are reported from the longest one to the shortest one.
+ *      param Parameter that is used to transfer into callback function.
+ * Return value:  The same value as callback function cbftvs returned.
+ * Caution:       Address of pac Must Be Allocated first.
+ *                If cbftvs returned CBF_TERMINATE, bytes after the one that ends the match would not be fed.
+ * Tip:           A text can be fed in pieces. Matches that span pieces are reported as well.
+ * Usage:         <test.c>
+ *                #include <stdio.h>
+ *                #include "svstring.h"
+ *                int cbftvs(void * pitem, size_t param) {
+ *                    DISUSE(param);
+ *                    printf("%u %u\n", (unsigned)((P_ACMATCH)pitem)->index, (unsigned)((P_ACMATCH)pitem)->offset);
+ *                    return CBF_CONTINUE;
+ *                }
+ *                int main() {
+ *                    ARRAY_Z ptns[3], arrptn;
+ *                    AHOCORASICK ac;
+ *                    strInitCharacterStringArrayZ(&ptns[0], "he");
+ *                    strInitCharacterStringArrayZ(&ptns[1], "she");
+ *                    strInitCharacterStringArrayZ(&ptns[2], "hers");
+ *                    arrptn.pdata = (PUCHAR)ptns;
+ *                    arrptn.num   = 3;
+ *                    if (strInitAhoCorasick(&ac, &arrptn)) {
+ *                        strFeedAhoCorasick(&ac, "ushers", 6, cbftvs, 0); // Prints 1 1, 0 2 and 2 2.
+ *                        strFreeAhoCorasick(&ac);
+ *                    }
+ *                    strFreeArrayZ(&ptns[0]);
+ *                    strFreeArrayZ(&ptns[1]);
+ *                    strFreeArrayZ(&ptns[2]);
+ *                    return 0;
+ *                }
+ */
+int strFeedAhoCorasick(P_AHOCORASICK pac, const void * pbuf, size_t num, CBF_TRAVERSE cbftvs, size_t param)
+{
+	REGISTER const UCHART * pc = (const UCHART *) pbuf;
+	REGISTER const size_t * ptrans = (const size_t *)pac->trans.pdata;
+	REGISTER const size_t * pouts  = (const size_t *)pac->outs.pdata;
+	REGISTER size_t s = pac->state;
+	for (; num > 0; --num, ++pc)
+	{
+		REGISTER size_t t;
+		s = ptrans[s * _AC_SYMS + *pc];
+		++pac->pos;
+		for (t = _AC_NONE != pouts[3 * s] ? s : pouts[3 * s + 1]; 0 != t; t = pouts[3 * t + 1])
+		{
+			ACMATCH m;
+			m.index  = pouts[3 * t];
+			m.offset = pac->pos - pouts[3 * t + 2];
+			if (CBF_CONTINUE != cbftvs(&m, param))
+			{
+				pac->state = s;
+				return CBF_TERMINATE;
+			}
+		}
+	}
+	pac->state = s;
+	return CBF_CONTINUE;
+}
+
+#undef _AC_SYMS
+#undef _AC_NONE
@@ -2,7 +2,7 @@
  * Name:        svctree.c
  * Description: Huffman coding tree.
  * Author:      cosh.cage#hotmail.com
- * File ID:     0914171200J0820260930L00477
+ * File ID:     0914171200J1018262206L00477
  * License:     LGPLv3
  * Copyright (C) 2017-2026 John Cage
  *
@@ -437,8 +437,8 @@ P_ARRAY_Z treHuffmanDecoding(P_ARRAY_Z ptable, P_BITSTREAM pbstm)
 					if (NULL == pnode->ppnode[LEFT] && NULL == pnode->ppnode[RIGHT]) /* Searching reaches at a leaf node. */
 					{
 						if (i >= strLevelArrayZ(parrzo))
-						{	/* Increase the length of bit stream. */
-							if (NULL == strResizeBufferedArrayZ(parrzo, sizeof(char), +BUFSIZ))
+						{	/* Double the length of output array to avoid reallocating for each block. */
+							if (NULL == strResizeBufferedArrayZ(parrzo, sizeof(char), +(ptrdiff_t)strLevelArrayZ(parrzo)))
 								goto Lbl_Decoding_Failure;
 						}
 						/* Assign symbol to bit stream. */
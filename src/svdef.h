@@ -2,7 +2,7 @@
  * Name:        svdef.c
  * Description: Common definitions.
  * Author:      cosh.cage#hotmail.com
- * File ID:     0306171808Z0806261900L00130
+ * File ID:     0306171808Z1018262251L00164
  * License:     LGPLv3
  * Copyright (C) 2017-2026 John Cage
  *
@@ -102,6 +102,40 @@ stdiv_t stdiv(size_t numerator, size_t denominator);
  */
 #define ALIGN_SIZET(size) (((size) + sizeof(size_t) - 1) & -(ptrdiff_t)sizeof(size_t))
 
+/* Size of a cache line in bytes. Structures that are laid out to fit cache lines refer to it. */
+#define SV_CACHE_LINE (64)
+
+/* Platform hooks.
+ * ISO C90 offers no threads, atomic operations, memory barriers or cache hints, so the library leaves them to platforms.
+ * Define the following macros before including headers of the library, e.g. on the command line of gcc:
+ *   -D"SV_MEMORY_FENCE()=__sync_synchronize()"
+ *   -D"SV_ATOMIC_INC(pn)=__sync_add_and_fetch((pn), 1)"
+ *   -D"SV_ATOMIC_DEC(pn)=__sync_sub_and_fetch((pn), 1)"
+ *   -D"SV_PREFETCH(paddr)=__builtin_prefetch(paddr)"
+ * Parallel loops run on threads only if the library is compiled with OpenMP, e.g. -fopenmp for gcc.
+ * Functions that rely on these hooks refer to this note.
+ */
+
+/* SV_MEMORY_FENCE() shall be a full memory barrier. It has no default,
+ * because readers that run alongside a writer are unsound without a real barrier.
+ * Functions for such readers are only provided when it is defined.
+ */
+
+/* SV_ATOMIC_INC(pn) and SV_ATOMIC_DEC(pn) shall atomically add 1 to or subtract 1 from a size_t object that pn points to
+ * and yield the new value. They are plain increment and decrement by default, which are only safe under one lock.
+ */
+#ifndef SV_ATOMIC_INC
+#define SV_ATOMIC_INC(pn) (++*(pn))
+#endif
+#ifndef SV_ATOMIC_DEC
+#define SV_ATOMIC_DEC(pn) (--*(pn))
+#endif
+
+/* SV_PREFETCH(paddr) hints to fetch the cache line at an address before it is read. It does nothing by default. */
+#ifndef SV_PREFETCH
+#define SV_PREFETCH(paddr) DISUSE(0)
+#endif
+
 /* Macros for library optimization. */
 #define SV_OPT_DISABLED  0x00
 #define SV_OPT_MINISIZE  0x01
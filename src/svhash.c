@@ -2,7 +2,7 @@
  * Name:        svhash.c
  * Description: Hash tables.
  * Author:      cosh.cage#hotmail.com
- * File ID:     0901171615K0809260546L00631
+ * File ID:     0901171615K1018262354L00685
  * License:     LGPLv3
  * Copyright (C) 2017-2026 John Cage
  *
@@ -612,6 +612,60 @@ bool hshCopyA(P_HSHTBL_A pdest, CBF_HASH cbfhsh1, CBF_HASH cbfhsh2, P_HSHTBL_A p
 #undef _P_FLAG
 #undef _FLAG_SIZE
 
+/* Function name: hshUniqueArrayZ
+ * Description:   Delete repeated elements in an array by hashing.
+ * Parameters:
+ *      parrz Pointer to a sized array.
+ *       size Size of each element in the array.
+ *     cbfhsh Pointer to a hash function of elements.
+ *     cbfmch Pointer to a function that matches any element in array to an element that is kept.
+ *            This function returns CBF_CMP_EQUAL when data match or a non zero value when data mismatch.
+ *            Please refer to svdef.h to see more details about type CBF_COMPARE.
+ *    bshrink Input true to shrink array, otherwise input false.
+ * Return value:  true  Succeeded.
+ *                false Allocation failure. The array is unaltered.
+ * Caution:       Address of parrz Must Be Allocated first.
+ *                Matched elements shall have the same hash value.
+ * Tip:           The first one of repeated elements is kept and the order of elements is preserved.
+ *                Indices of kept elements are stored in a temporary open addressing table with linear probing,
+ *                so that the array is compacted in a single pass with O(n) expected comparisons.
+ */
+bool hshUniqueArrayZ(P_ARRAY_Z parrz, size_t size, CBF_HASH cbfhsh, CBF_COMPARE cbfmch, bool bshrink)
+{
+	ARRAY_Z slots;
+	REGISTER size_t i, j, k;
+	REGISTER size_t * ps;
+	REGISTER PUCHAR px;
+	const size_t n = strLevelArrayZ(parrz);
+	if (n < 2)
+		return true;
+	/* Keep the table at most half full. A slot holds an index plus 1 of a kept element, or 0 if it is empty. */
+	if (NULL == strInitArrayZ(&slots, 2 * n + 1, sizeof(size_t)))
+		return false;
+	memset(slots.pdata, 0, strLevelArrayZ(&slots) * sizeof(size_t));
+	ps = (size_t *)slots.pdata;
+	for (i = j = 0, px = parrz->pdata; i < n; ++i, px += size)
+	{
+		for (k = cbfhsh(px) % strLevelArrayZ(&slots); 0 != ps[k]; k = (k + 1) % strLevelArrayZ(&slots))
+			if (CBF_CMP_EQUAL == cbfmch(px, parrz->pdata + (ps[k] - 1) * size))
+				break;
+		if (0 == ps[k])
+		{	/* px is unique so far. Move it next to kept elements. */
+			if (i != j)
+				memcpy(parrz->pdata + j * size, px, size);
+			ps[k] = ++j;
+		}
+	}
+	strFreeArrayZ(&slots);
+	if (j < n)
+	{
+		parrz->num = j;
+		if (bshrink)
+			strResizeArrayZ(parrz, j, size);
+	}
+	return true;
+}
+
 /* Function name: hshCBFHashString
  * Description:   Hash a zero terminated character string.
  * Parameter:
@@ -2,7 +2,7 @@
  * Name:        svhshtbl.h
  * Description: Hash tables interface.
  * Author:      cosh.cage#hotmail.com
- * File ID:     0901171615U0806260346L00108
+ * File ID:     0901171615U1018262251L00110
  * License:     LGPLv3
  * Copyright (C) 2017-2026 John Cage
  *
@@ -56,6 +56,8 @@ void *     hshSearchA       (P_HSHTBL_A   pht,   CBF_HASH     cbfhsh1, CBF_HASH
 void *     hshInsertA       (P_HSHTBL_A   pht,   CBF_HASH     cbfhsh1, CBF_HASH     cbfhsh2, const void * pkey, size_t size);
 bool       hshRemoveA       (P_HSHTBL_A   pht,   CBF_HASH     cbfhsh1, CBF_HASH     cbfhsh2, const void * pkey, size_t size, CBF_COMPARE cbfmch);
 bool       hshCopyA         (P_HSHTBL_A   pdest, CBF_HASH     cbfhsh1, CBF_HASH     cbfhsh2, P_HSHTBL_A   psrc, size_t size);
+/* Functions for deduplicating arrays. */
+bool       hshUniqueArrayZ  (P_ARRAY_Z    parrz, size_t       size,    CBF_HASH     cbfhsh,  CBF_COMPARE  cbfmch, bool bshrink);
 /* Some built-in hash functions are declared below. */
 size_t     hshCBFHashString (const void * pstr);
 
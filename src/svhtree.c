@@ -2,7 +2,7 @@
  * Name:        svhtree.c
  * Description: Heap tree.
  * Author:      cosh.cage#hotmail.com
- * File ID:     0809171737E0719261650L00269
+ * File ID:     0809171737E1018262223L00374
  * License:     LGPLv3
  * Copyright (C) 2017-2026 John Cage
  *
@@ -267,3 +267,108 @@ bool trePeepHeapA(void * pitem, size_t size, P_HEAP_A pheap)
 	return false;
 }
 
+/* Function name: treInitTopKA
+ * Description:   Initialize a bounded heap that keeps the top k elements of a stream.
+ * Parameters:
+ *      ptopk Pointer to a TOPK_A structure.
+ *          k Number of elements to keep.
+ *       size Size of each element.
+ *     cbfcmp Pointer to a CBF_COMPARE callback function.
+ *       bmax true  Keep the greatest k elements.
+ *            false Keep the least k elements.
+ * Return value:  true  indicates initialization succeeded.
+ *                false indicates allocation failed.
+ * Caution:       Address of ptopk Must Be Allocated first.
+ *                Call treFreeTopKA to release it.
+ */
+bool treInitTopKA(P_TOPK_A ptopk, size_t k, size_t size, CBF_COMPARE cbfcmp, bool bmax)
+{
+	ptopk->heap.irear = 0;
+	ptopk->size   = size;
+	ptopk->cbfcmp = cbfcmp;
+	ptopk->bmax   = bmax;
+	if (NULL == (ptopk->ptemp = (PUCHAR) malloc(size)))
+		return false;
+	if (NULL == strInitArrayZ(&ptopk->heap.hdarr, k, size) && k > 0)
+	{
+		free(ptopk->ptemp);
+		ptopk->ptemp = NULL;
+		return false;
+	}
+	return true;
+}
+
+/* Function name: treFreeTopKA
+ * Description:   Release a structure that is allocated by function treInitTopKA.
+ * Parameter:
+ *     ptopk Pointer to a TOPK_A structure.
+ * Return value:  N/A.
+ */
+void treFreeTopKA(P_TOPK_A ptopk)
+{
+	if (NULL != ptopk->heap.hdarr.pdata)
+		treFreeHeapA(&ptopk->heap);
+	if (NULL != ptopk->ptemp)
+		free(ptopk->ptemp);
+	ptopk->ptemp = NULL;
+}
+
+/* Function name: treOfferTopKA
+ * Description:   Offer an element to a top k heap.
+ * Parameters:
+ *      ptopk Pointer to a TOPK_A structure.
+ *      pitem Pointer to the element.
+ * Return value:  true  The element is kept for now.
+ *                false The element is dropped.
+ * Tip:           The heap is a min heap to keep the greatest elements and a max heap to keep the least,
+ *                so that an element that cannot get in costs only one comparison with the root.
+ *                Offering n elements takes O(n*log k) time at worst and O(k) space.
+ */
+bool treOfferTopKA(P_TOPK_A ptopk, const void * pitem)
+{
+	REGISTER int r;
+	if (0 == strLevelArrayZ(&ptopk->heap.hdarr))
+		return false;
+	if (! treIsFullHeapA(&ptopk->heap))
+		return treInsertHeapA(&ptopk->heap, pitem, ptopk->ptemp, ptopk->size, ptopk->cbfcmp, ! ptopk->bmax);
+	r = ptopk->cbfcmp(pitem, ptopk->heap.hdarr.pdata);
+	if (ptopk->bmax ? r <= 0 : r >= 0)
+		return false;
+	/* Replace the worst one that is kept. */
+	treRemoveHeapA(NULL, ptopk->ptemp, ptopk->size, &ptopk->heap, ptopk->cbfcmp, ! ptopk->bmax);
+	return treInsertHeapA(&ptopk->heap, pitem, ptopk->ptemp, ptopk->size, ptopk->cbfcmp, ! ptopk->bmax);
+}
+
+/* Function name: treCBFOfferTopKA
+ * Description:   A traversal callback that offers each visited element to a top k heap.
+ * Parameters:
+ *      pitem Pointer to an element.
+ *      param Pointer to a TOPK_A structure casted to size_t.
+ * Return value:  CBF_CONTINUE.
+ * Tip:           Pass it to any traversal function of the library to select the top k elements of a container, e.g.
+ *                strTraverseArrayZ(&arr, sizeof(int), treCBFOfferTopKA, (size_t)&topk, false);
+ */
+int treCBFOfferTopKA(void * pitem, size_t param)
+{
+	DISUSE(treOfferTopKA((P_TOPK_A)param, pitem));
+	return CBF_CONTINUE;
+}
+
+/* Function name: treDrainTopKA
+ * Description:   Move kept elements out of a top k heap in order.
+ * Parameters:
+ *      ptopk Pointer to a TOPK_A structure.
+ *       pbuf Pointer to a buffer that can hold k elements.
+ * Return value:  Number of elements that were written to pbuf.
+ * Caution:       The heap is empty after calling. It can be reused for another stream.
+ * Tip:           The best element comes first, i.e. the greatest one if bmax were true.
+ */
+size_t treDrainTopKA(P_TOPK_A ptopk, void * pbuf)
+{
+	REGISTER size_t i, n = ptopk->heap.irear;
+	/* The root is the worst one, so fill the buffer from its tail. */
+	for (i = n; i > 0; --i)
+		treRemoveHeapA((PUCHAR)pbuf + (i - 1) * ptopk->size, ptopk->ptemp, ptopk->size, &ptopk->heap, ptopk->cbfcmp, ! ptopk->bmax);
+	return n;
+}
+
@@ -2,7 +2,7 @@
  * Name:        svmisc.c
  * Description: Miscellaneous data structures.
  * Author:      cosh.cage#hotmail.com
- * File ID:     0306170948D0820261341L00933
+ * File ID:     0306170948D1018262251L01989
  * License:     LGPLv3
  * Copyright (C) 2017-2026 John Cage
  *
@@ -22,7 +22,7 @@
  */
 
 #include <stdio.h>  /* Using macro BUFSIZ, function printf. */
-#include <stdlib.h> /* Using function malloc, free. */
+#include <stdlib.h> /* Using function malloc, calloc, free. */
 #include <string.h> /* Using function memcpy, memmove. */
 #include "svstring.h"
 
@@ -654,7 +654,7 @@ void * svMergeSort(void * pbase, size_t num, size_t size, CBF_COMPARE cbfcmp)
 			y = t < num ? t : num;
 
 			while (a < x && b < y)
-				memcpy(pr + k++ * size, cbfcmp(pl + a * size, pl + b * size) < 0 ? pl + a++ * size : pl + b++ * size, size);
+				memcpy(pr + k++ * size, cbfcmp(pl + a * size, pl + b * size) <= 0 ? pl + a++ * size : pl + b++ * size, size);
 
 			while (a < x)
 				memcpy(pr + k++ * size, pl + a++ * size, size);
@@ -679,6 +679,344 @@ void * svMergeSort(void * pbase, size_t num, size_t size, CBF_COMPARE cbfcmp)
 	return pbase;
 }
 
+#define _TIM_MINGALLOP 7 /* Consecutive wins of a run before galloping. */
+
+/* State of a natural merge sort. */
+typedef struct _st_TIMSORT {
+	PUCHAR      pbase;  /* Pointer to the array. */
+	size_t      num;    /* Number of elements in the array. */
+	size_t      size;   /* Size of each element. */
+	CBF_COMPARE cbfcmp; /* Comparison function. */
+	PUCHAR      pbuf;   /* Merging buffer of (num / 2) elements. It is allocated on the first merging. */
+	size_t      nrun;   /* Number of pending runs. */
+	struct {
+		size_t base;    /* Index of the first element of a run. */
+		size_t len;     /* Number of elements in a run. */
+	} run[2 * CHAR_BIT * sizeof(size_t)]; /* Pending runs whose lengths grow at least as Fibonacci numbers downward. */
+} _TIMSORT, * _P_TIMSORT;
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _svGallopLeft
+ * Description:   Count leading elements that are less than a key in a sorted array by exponential search.
+ * Parameters:
+ *       pkey Pointer to the key.
+ *      pbase Pointer to the array.
+ *        num Number of elements in the array.
+ *       size Size of each element.
+ *     cbfcmp Pointer to a function that compares two elements.
+ * Return value:  Number of elements that are less than pkey.
+ */
+size_t _svGallopLeft(const void * pkey, PUCHAR pbase, size_t num, size_t size, CBF_COMPARE cbfcmp)
+{
+	REGISTER size_t lo = 0, hi = 1, m;
+	/* Probe elements 0, 2, 6, 14 ... Elements before lo are less than pkey. */
+	while (hi <= num && cbfcmp(pbase + (hi - 1) * size, pkey) < 0)
+	{
+		lo = hi;
+		hi = (hi << 1) + 1;
+	}
+	hi = hi <= num ? hi - 1 : num;
+	while (lo < hi)
+	{
+		m = lo + ((hi - lo) >> 1);
+		if (cbfcmp(pbase + m * size, pkey) < 0)
+			lo = m + 1;
+		else
+			hi = m;
+	}
+	return lo;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _svGallopRight
+ * Description:   Count leading elements that are less than or equal to a key in a sorted array by exponential search.
+ * Parameters:
+ *       pkey Pointer to the key.
+ *      pbase Pointer to the array.
+ *        num Number of elements in the array.
+ *       size Size of each element.
+ *     cbfcmp Pointer to a function that compares two elements.
+ * Return value:  Number of elements that are less than or equal to pkey.
+ */
+size_t _svGallopRight(const void * pkey, PUCHAR pbase, size_t num, size_t size, CBF_COMPARE cbfcmp)
+{
+	REGISTER size_t lo = 0, hi = 1, m;
+	while (hi <= num && cbfcmp(pbase + (hi - 1) * size, pkey) <= 0)
+	{
+		lo = hi;
+		hi = (hi << 1) + 1;
+	}
+	hi = hi <= num ? hi - 1 : num;
+	while (lo < hi)
+	{
+		m = lo + ((hi - lo) >> 1);
+		if (cbfcmp(pbase + m * size, pkey) <= 0)
+			lo = m + 1;
+		else
+			hi = m;
+	}
+	return lo;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _svMergeLoTimSort
+ * Description:   Merge two adjacent runs from their heads. The former run is copied into the buffer.
+ * Parameters:
+ *        pts Pointer to the state of sorting.
+ *         pa Pointer to the former run.
+ *         na Number of elements in the former run. It shall not exceed nb.
+ *         pb Pointer to the latter run that follows pa.
+ *         nb Number of elements in the latter run.
+ * Return value:  N/A.
+ */
+void _svMergeLoTimSort(_P_TIMSORT pts, PUCHAR pa, size_t na, PUCHAR pb, size_t nb)
+{
+	REGISTER size_t k, wa = 0, wb = 0;
+	REGISTER PUCHAR pc = pts->pbuf, pd = pa;
+	const size_t size = pts->size;
+	memcpy(pc, pa, na * size);
+	while (na > 0 && nb > 0)
+	{
+		if (pts->cbfcmp(pb, pc) < 0)
+		{
+			memcpy(pd, pb, size);
+			pd += size;
+			pb += size;
+			--nb;
+			wa = 0;
+			if (++wb >= _TIM_MINGALLOP && nb > 0)
+			{	/* Elements of the latter run that are less than the head of the former one. */
+				k = _svGallopLeft(pc, pb, nb, size, pts->cbfcmp);
+				memmove(pd, pb, k * size);
+				pd += k * size;
+				pb += k * size;
+				nb -= k;
+				wb = 0;
+			}
+		}
+		else
+		{	/* Elements of the former run go first on ties to keep stability. */
+			memcpy(pd, pc, size);
+			pd += size;
+			pc += size;
+			--na;
+			wb = 0;
+			if (++wa >= _TIM_MINGALLOP && na > 0)
+			{
+				k = _svGallopRight(pb, pc, na, size, pts->cbfcmp);
+				memcpy(pd, pc, k * size);
+				pd += k * size;
+				pc += k * size;
+				na -= k;
+				wa = 0;
+			}
+		}
+	}
+	if (na > 0) /* Rest of the latter run is in place already. */
+		memcpy(pd, pc, na * size);
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _svMergeHiTimSort
+ * Description:   Merge two adjacent runs from their tails. The latter run is copied into the buffer.
+ * Parameters:
+ *        pts Pointer to the state of sorting.
+ *         pa Pointer to the former run.
+ *         na Number of elements in the former run.
+ *         pb Pointer to the latter run that follows pa.
+ *         nb Number of elements in the latter run. It shall not exceed na.
+ * Return value:  N/A.
+ */
+void _svMergeHiTimSort(_P_TIMSORT pts, PUCHAR pa, size_t na, PUCHAR pb, size_t nb)
+{
+	REGISTER size_t k, wa = 0, wb = 0;
+	const size_t size = pts->size;
+	REGISTER PUCHAR pc = pts->pbuf + (nb - 1) * size, pd = pb + (nb - 1) * size, px = pa + (na - 1) * size;
+	memcpy(pts->pbuf, pb, nb * size);
+	while (na > 0 && nb > 0)
+	{
+		if (pts->cbfcmp(pc, px) < 0)
+		{
+			memcpy(pd, px, size);
+			pd -= size;
+			px -= size;
+			--na;
+			wb = 0;
+			if (++wa >= _TIM_MINGALLOP && na > 0)
+			{	/* Elements of the former run that are greater than the tail of the latter one. */
+				k = na - _svGallopRight(pc, pa, na, size, pts->cbfcmp);
+				pd -= k * size;
+				px -= k * size;
+				na -= k;
+				memmove(pd + size, px + size, k * size);
+				wa = 0;
+			}
+		}
+		else
+		{	/* Elements of the latter run go last on ties to keep stability. */
+			memcpy(pd, pc, size);
+			pd -= size;
+			pc -= size;
+			--nb;
+			wa = 0;
+			if (++wb >= _TIM_MINGALLOP && nb > 0)
+			{
+				k = nb - _svGallopLeft(px, pts->pbuf, nb, size, pts->cbfcmp);
+				pd -= k * size;
+				pc -= k * size;
+				nb -= k;
+				memcpy(pd + size, pc + size, k * size);
+				wb = 0;
+			}
+		}
+	}
+	if (nb > 0) /* Rest of the former run is in place already. */
+		memcpy(pa, pts->pbuf, nb * size);
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _svMergeAtTimSort
+ * Description:   Merge pending run i and run i + 1.
+ * Parameters:
+ *        pts Pointer to the state of sorting.
+ *          i Index of the former run.
+ * Return value:  true:  Succeeded.
+ *                false: Allocation failure. Runs are left unaltered.
+ */
+bool _svMergeAtTimSort(_P_TIMSORT pts, size_t i)
+{
+	const size_t size = pts->size;
+	REGISTER PUCHAR pa = pts->pbase + pts->run[i].base * size, pb = pts->pbase + pts->run[i + 1].base * size;
+	REGISTER size_t na = pts->run[i].len, nb = pts->run[i + 1].len, k;
+	if (NULL == pts->pbuf && NULL == (pts->pbuf = (PUCHAR) malloc((pts->num >> 1) * size)))
+		return false;
+	pts->run[i].len += nb;
+	for (k = i + 1; k + 1 < pts->nrun; ++k)
+		pts->run[k] = pts->run[k + 1];
+	--pts->nrun;
+	/* Elements of the former run that are not greater than the head of the latter run are in place. */
+	k = _svGallopRight(pb, pa, na, size, pts->cbfcmp);
+	pa += k * size;
+	na -= k;
+	if (0 == na)
+		return true;
+	/* Elements of the latter run that are not less than the tail of the former run are in place. */
+	nb = _svGallopLeft(pa + (na - 1) * size, pb, nb, size, pts->cbfcmp);
+	if (0 == nb)
+		return true;
+	if (na <= nb)
+		_svMergeLoTimSort(pts, pa, na, pb, nb);
+	else
+		_svMergeHiTimSort(pts, pa, na, pb, nb);
+	return true;
+}
+
+/* Function name: svTimSort
+ * Description:   Natural merge sort algorithm that adapts to runs in the array like Timsort.
+ * Parameters:
+ *      pbase Pointer to the first object of the array to be sorted.
+ *        num Number of elements in the array.
+ *       size Size in bytes of each element in the array.
+ *     cbfcmp Pointer to a function that compares two elements.
+ *            Please refer to the type definition CBF_COMPARE in svdef.h.
+ * Return value:  If sorting succeeded, this function would return the same pointer as pbase pointed,
+ *                otherwise, this function would return NULL and the array would be a permutation of its elements.
+ * Caution:       This sort is stable.
+ * Tip:           Non-descending runs and strictly descending runs are found in a scan. Descending runs are reversed,
+ *                and short runs are extended by binary insertion sort. Runs are merged with galloping,
+ *                so that a sorted, reversed or nearly sorted array takes near O(n) time.
+ *                A buffer of at most n / 2 elements is allocated and only if a merge is needed.
+ *                It takes O(n*log n) time at worst.
+ */
+void * svTimSort(void * pbase, size_t num, size_t size, CBF_COMPARE cbfcmp)
+{
+	_TIMSORT ts;
+	REGISTER size_t i, j, n, k, minrun;
+	REGISTER PUCHAR pa, pb;
+	PUCHAR ptemp;
+	UCHART tmpbuf[BUFSIZ];
+	if (num < 2)
+		return pbase;
+	if (NULL == (ptemp = size <= BUFSIZ ? tmpbuf : (PUCHAR) malloc(size)))
+		return NULL;
+	ts.pbase  = (PUCHAR) pbase;
+	ts.num    = num;
+	ts.size   = size;
+	ts.cbfcmp = cbfcmp;
+	ts.pbuf   = NULL;
+	ts.nrun   = 0;
+	/* Minimum length of runs is in [32, 64] so that num / minrun is a power of 2 or a little less than it. */
+	for (n = num, k = 0; n >= 64; n >>= 1)
+		k |= n & 1;
+	minrun = n + k;
+	for (i = 0; i < num; i += n)
+	{
+		pa = ts.pbase + i * size;
+		/* Find a run. */
+		n = 1;
+		if (i + 1 < num)
+		{
+			if (cbfcmp(pa + size, pa) < 0)
+			{	/* Strictly descending run can be reversed without breaking stability. */
+				for (n = 2, pb = pa + 2 * size; i + n < num && cbfcmp(pb, pb - size) < 0; ++n, pb += size);
+				for (j = 0, pb = pa + (n - 1) * size; j < (n >> 1); ++j, pb -= size)
+					svSwap(pa + j * size, ptemp, pb, size);
+			}
+			else
+				for (n = 2, pb = pa + 2 * size; i + n < num && cbfcmp(pb, pb - size) >= 0; ++n, pb += size);
+		}
+		if (n < minrun)
+		{	/* Extend the run by binary insertion sort. */
+			k = num - i < minrun ? num - i : minrun;
+			for (pb = pa + n * size; n < k; ++n, pb += size)
+			{
+				j = _svGallopRight(pb, pa, n, size, cbfcmp);
+				memcpy(ptemp, pb, size);
+				memmove(pa + (j + 1) * size, pa + j * size, (n - j) * size);
+				memcpy(pa + j * size, ptemp, size);
+			}
+		}
+		ts.run[ts.nrun].base = i;
+		ts.run[ts.nrun].len  = n;
+		++ts.nrun;
+		/* Keep lengths of pending runs decreasing at least as Fibonacci numbers. */
+		while (ts.nrun > 1)
+		{
+			k = ts.nrun - 2;
+			if ((k > 0 && ts.run[k - 1].len <= ts.run[k].len + ts.run[k + 1].len) ||
+				(k > 1 && ts.run[k - 2].len <= ts.run[k - 1].len + ts.run[k].len))
+			{
+				if (ts.run[k - 1].len < ts.run[k + 1].len)
+					--k;
+			}
+			else if (ts.run[k].len > ts.run[k + 1].len)
+				break;
+			if (! _svMergeAtTimSort(&ts, k))
+				goto Lbl_Failure;
+		}
+	}
+	/* Merge all pending runs. */
+	while (ts.nrun > 1)
+	{
+		k = ts.nrun - 2;
+		if (k > 0 && ts.run[k - 1].len < ts.run[k + 1].len)
+			--k;
+		if (! _svMergeAtTimSort(&ts, k))
+			goto Lbl_Failure;
+	}
+	if (NULL != ts.pbuf)
+		free(ts.pbuf);
+	if (tmpbuf != ptemp)
+		free(ptemp);
+	return pbase;
+Lbl_Failure:
+	if (tmpbuf != ptemp)
+		free(ptemp);
+	return NULL; /* Allocation failure. */
+}
+
+#undef _TIM_MINGALLOP
+
 /* Function name: svHeapSort
  * Description:   Heap sort algorithm.
  * Parameters:
@@ -763,6 +1101,643 @@ void * svHeapSort(void * pbase, size_t num, size_t size, CBF_COMPARE cbfcmp)
 	return pbase;
 }
 
+#define _INTRO_CUTOFF  16  /* Ranges shorter than this are sorted by svShellSort. */
+#define _INTRO_NINTHER 128 /* Ranges of this length or longer choose pivots by Tukey's ninther. */
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _svMedianOfThree
+ * Description:   Find the median of three elements.
+ * Parameters:
+ *         pa Pointer to an element.
+ *         pb Pointer to an element.
+ *         pc Pointer to an element.
+ *     cbfcmp Pointer to a function that compares two elements.
+ * Return value:  Pointer to the median element.
+ */
+PUCHAR _svMedianOfThree(PUCHAR pa, PUCHAR pb, PUCHAR pc, CBF_COMPARE cbfcmp)
+{
+	if (cbfcmp(pa, pb) < 0)
+	{
+		if (cbfcmp(pb, pc) < 0)
+			return pb;
+		return cbfcmp(pa, pc) < 0 ? pc : pa;
+	}
+	if (cbfcmp(pa, pc) < 0)
+		return pa;
+	return cbfcmp(pb, pc) < 0 ? pc : pb;
+}
+
+/* Function name: svIntroSort
+ * Description:   Introspective sort algorithm.
+ * Parameters:
+ *      pbase Pointer to the first object of the array to be sorted.
+ *        num Number of elements in the array.
+ *       size Size in bytes of each element in the array.
+ *     cbfcmp Pointer to a function that compares two elements.
+ *            Please refer to the type definition CBF_COMPARE in svdef.h.
+ * Return value:  If sorting succeeded, this function would return the same pointer to pbase,
+ *                otherwise, this function would return NULL.
+ * Caution:       Introspective sort is not stable.
+ * Tip:           This function sorts in O(n*log n) time at worst, unlike svQuickSort:
+ *                (*) Pivots are medians of three, or Tukey's ninthers for long ranges.
+ *                (*) Three way partitioning gathers elements that equal to pivots, so that repeated keys cost linear time.
+ *                (*) Ranges that are already sorted are detected in a linear scan and skipped.
+ *                    Ranges that are strictly descending are reversed.
+ *                (*) Ranges that recurse deeper than 2 * log2(n) levels are sorted by svHeapSort.
+ *                Only O(log n) extra space is used for the stack of ranges.
+ */
+void * svIntroSort(void * pbase, size_t num, size_t size, CBF_COMPARE cbfcmp)
+{
+	PUCHAR ptemp = NULL;
+	UCHART tmpbuf[BUFSIZ];
+	if (num < 2)
+		return pbase;
+	/* A buffer for swapping followed by a buffer for pivots. */
+	ptemp = 2 * size <= BUFSIZ ? tmpbuf : (PUCHAR) malloc(2 * size);
+	if (NULL != ptemp)
+	{
+		struct { size_t l; size_t r; size_t d; } rawstk[CHAR_BIT * sizeof(size_t)], * pstk = rawstk + 1;
+		REGISTER size_t l, r, d, n, i, lt, gt;
+		REGISTER PUCHAR pa, pb;
+		REGISTER int c;
+		PUCHAR ppiv = ptemp + size;
+		/* Initialize parameter stack. Ranges are half open. */
+		rawstk[0].l = 0;
+		rawstk[0].r = num;
+		for (rawstk[0].d = 0, n = num; n > 1; n >>= 1)
+			rawstk[0].d += 2;
+	Lbl_Recurse:
+		/* Pop parameters from stack. */
+		--pstk;
+		l = pstk->l;
+		r = pstk->r;
+		d = pstk->d;
+		n = r - l;
+		pa = (PUCHAR) pbase + size * l;
+		if (n < _INTRO_CUTOFF)
+		{
+			svShellSort(pa, ptemp, n, size, cbfcmp);
+			goto Lbl_Next;
+		}
+		/* Detect a sorted run. */
+		for (i = 1, pb = pa + size; i < n && cbfcmp(pb - size, pb) <= 0; ++i, pb += size);
+		if (i == n)
+			goto Lbl_Next;
+		if (1 == i)
+		{	/* Detect a strictly descending run. */
+			for (i = 1, pb = pa + size; i < n && cbfcmp(pb - size, pb) > 0; ++i, pb += size);
+			if (i == n)
+			{
+				for (pb = pa + size * (n - 1); pa < pb; pa += size, pb -= size)
+					svSwap(pa, ptemp, pb, size);
+				goto Lbl_Next;
+			}
+		}
+		if (0 == d)
+		{	/* Partitions have been bad too many times. */
+			if (NULL == svHeapSort(pa, n, size, cbfcmp))
+				goto Lbl_Failure;
+			goto Lbl_Next;
+		}
+		/* Choose a pivot. */
+		if (n < _INTRO_NINTHER)
+			pb = _svMedianOfThree(pa, pa + size * (n >> 1), pa + size * (n - 1), cbfcmp);
+		else
+		{
+			REGISTER size_t s = n >> 3;
+			REGISTER PUCHAR pm = pa + size * (n >> 1), pz = pa + size * (n - 1);
+			pb = _svMedianOfThree
+			(
+				_svMedianOfThree(pa, pa + size * s, pa + size * 2 * s, cbfcmp),
+				_svMedianOfThree(pm - size * s, pm, pm + size * s, cbfcmp),
+				_svMedianOfThree(pz - size * 2 * s, pz - size * s, pz, cbfcmp),
+				cbfcmp
+			);
+		}
+		memcpy(ppiv, pb, size);
+		/* Partition [l, lt) < pivot, [lt, gt) == pivot and [gt, r) > pivot. */
+		for (lt = i = l, gt = r; i < gt; )
+		{
+			pb = (PUCHAR) pbase + size * i;
+			if ((c = cbfcmp(pb, ppiv)) < 0)
+			{
+				if (lt != i)
+					svSwap((PUCHAR) pbase + size * lt, ptemp, pb, size);
+				++lt;
+				++i;
+			}
+			else if (c > 0)
+				svSwap(pb, ptemp, (PUCHAR) pbase + size * --gt, size);
+			else
+				++i;
+		}
+		/* Push the longer range first, so that the stack holds at most log2(n) ranges. */
+		c = lt - l > r - gt;
+		pstk->l = c ? l  : gt;
+		pstk->r = c ? lt : r;
+		pstk->d = d - 1;
+		++pstk;
+		pstk->l = c ? gt : l;
+		pstk->r = c ? r  : lt;
+		pstk->d = d - 1;
+		++pstk;
+	Lbl_Next:
+		if (rawstk != pstk)
+			goto Lbl_Recurse;
+		if (tmpbuf != ptemp)
+			free(ptemp);
+		return pbase;
+	Lbl_Failure:
+		if (tmpbuf != ptemp)
+			free(ptemp);
+	}
+	return NULL; /* Allocation failure. */
+}
+
+/* Function name: svNthElement
+ * Description:   Introspective selection algorithm. Partially sort an array to place the nth element.
+ * Parameters:
+ *      pbase Pointer to the first object of the array.
+ *        num Number of elements in the array.
+ *       size Size in bytes of each element in the array.
+ *     cbfcmp Pointer to a function that compares two elements.
+ *            Please refer to the type definition CBF_COMPARE in svdef.h.
+ *          n Index of the element to be placed. Input num >> 1 to get a median.
+ * Return value:  Pointer to the nth element of the array. NULL if n >= num or allocation failed.
+ * Caution:       This function is not stable.
+ * Tip:           After calling, element n is the one that would be there if the array were sorted,
+ *                elements before it are not greater and elements after it are not less than it.
+ *                It runs in O(n) time on average. Partitions are chosen like svIntroSort and
+ *                ranges that recurse deeper than 2 * log2(n) levels are sorted by svHeapSort.
+ */
+void * svNthElement(void * pbase, size_t num, size_t size, CBF_COMPARE cbfcmp, size_t n)
+{
+	REGISTER size_t l = 0, r = num, d, i, lt, gt, m;
+	REGISTER PUCHAR pa, pb;
+	REGISTER int c;
+	PUCHAR ptemp, ppiv;
+	UCHART tmpbuf[BUFSIZ];
+	if (n >= num)
+		return NULL;
+	/* A buffer for swapping followed by a buffer for pivots. */
+	if (NULL == (ptemp = 2 * size <= BUFSIZ ? tmpbuf : (PUCHAR) malloc(2 * size)))
+		return NULL;
+	ppiv = ptemp + size;
+	for (d = 0, m = num; m > 1; m >>= 1)
+		d += 2;
+	for (;;)
+	{
+		m = r - l;
+		pa = (PUCHAR) pbase + size * l;
+		if (m < _INTRO_CUTOFF)
+		{
+			svShellSort(pa, ptemp, m, size, cbfcmp);
+			break;
+		}
+		if (0 == d--)
+		{	/* Partitions have been bad too many times. */
+			if (NULL == svHeapSort(pa, m, size, cbfcmp))
+				goto Lbl_Failure;
+			break;
+		}
+		/* Choose a pivot. */
+		if (m < _INTRO_NINTHER)
+			pb = _svMedianOfThree(pa, pa + size * (m >> 1), pa + size * (m - 1), cbfcmp);
+		else
+		{
+			REGISTER size_t s = m >> 3;
+			REGISTER PUCHAR pm = pa + size * (m >> 1), pz = pa + size * (m - 1);
+			pb = _svMedianOfThree
+			(
+				_svMedianOfThree(pa, pa + size * s, pa + size * 2 * s, cbfcmp),
+				_svMedianOfThree(pm - size * s, pm, pm + size * s, cbfcmp),
+				_svMedianOfThree(pz - size * 2 * s, pz - size * s, pz, cbfcmp),
+				cbfcmp
+			);
+		}
+		memcpy(ppiv, pb, size);
+		/* Partition [l, lt) < pivot, [lt, gt) == pivot and [gt, r) > pivot. */
+		for (lt = i = l, gt = r; i < gt; )
+		{
+			pb = (PUCHAR) pbase + size * i;
+			if ((c = cbfcmp(pb, ppiv)) < 0)
+			{
+				if (lt != i)
+					svSwap((PUCHAR) pbase + size * lt, ptemp, pb, size);
+				++lt;
+				++i;
+			}
+			else if (c > 0)
+				svSwap(pb, ptemp, (PUCHAR) pbase + size * --gt, size);
+			else
+				++i;
+		}
+		/* Descend into the range that holds n only. */
+		if (n < lt)
+			r = lt;
+		else if (n >= gt)
+			l = gt;
+		else
+			break;
+	}
+	if (tmpbuf != ptemp)
+		free(ptemp);
+	return (PUCHAR) pbase + size * n;
+Lbl_Failure:
+	if (tmpbuf != ptemp)
+		free(ptemp);
+	return NULL; /* Allocation failure. */
+}
+
+/* Function name: svPartialSort
+ * Description:   Sort the least k elements of an array to the head of the array.
+ * Parameters:
+ *      pbase Pointer to the first object of the array.
+ *        num Number of elements in the array.
+ *       size Size in bytes of each element in the array.
+ *     cbfcmp Pointer to a function that compares two elements.
+ *            Please refer to the type definition CBF_COMPARE in svdef.h.
+ *          k Number of elements to be sorted. If k were greater than num, the whole array would be sorted.
+ * Return value:  pbase or NULL if allocation failed.
+ * Caution:       This function is not stable. The order of the rest num - k elements is unspecified.
+ * Tip:           It takes O(n + k*log k) time by calling svNthElement and then svIntroSort on the head.
+ *                Reverse cbfcmp to get the greatest k elements.
+ */
+void * svPartialSort(void * pbase, size_t num, size_t size, CBF_COMPARE cbfcmp, size_t k)
+{
+	if (0 == k)
+		return pbase;
+	if (k < num)
+	{
+		if (NULL == svNthElement(pbase, num, size, cbfcmp, k - 1))
+			return NULL;
+		--k; /* Element k - 1 is in place already. */
+	}
+	else
+		k = num;
+	return svIntroSort(pbase, k, size, cbfcmp);
+}
+
+#undef _INTRO_CUTOFF
+#undef _INTRO_NINTHER
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _svRadixSort
+ * Description:   Least significant digit radix sort on bytes of keys.
+ * Parameters:
+ *      pbase Pointer to the first object of the array to be sorted.
+ *        num Number of elements in the array.
+ *       size Size in bytes of each element in the array.
+ *     offset Offset in bytes of keys in elements.
+ *      width Number of bytes of each key.
+ *  bmsbfirst Input true if the most significant byte of a key comes first in memory.
+ *       flip A mask that is applied to the most significant byte, e.g. 0x80 to order signed integers.
+ * Return value:  pbase or NULL if allocation failed.
+ */
+void * _svRadixSort(void * pbase, size_t num, size_t size, size_t offset, size_t width, bool bmsbfirst, UCHART flip)
+{
+	REGISTER size_t i, d, k;
+	REGISTER PUCHAR ps, pd, p;
+	PUCHAR pbuf;
+	size_t * pcnt;
+	if (num < 2 || 0 == width)
+		return pbase;
+	/* A buffer of elements and histograms of all digits. */
+	if (NULL == (pcnt = (size_t *) calloc(width * (UCHAR_MAX + 1), sizeof(size_t))))
+		return NULL;
+	if (NULL == (pbuf = (PUCHAR) malloc(num * size)))
+	{
+		free(pcnt);
+		return NULL;
+	}
+	/* Count all digits in a single pass. Histogram d is for the byte at offset + d in keys. */
+	for (i = 0, p = (PUCHAR) pbase + offset; i < num; ++i, p += size)
+		for (d = 0; d < width; ++d)
+			++pcnt[d * (UCHAR_MAX + 1) + p[d]];
+	ps = (PUCHAR) pbase;
+	pd = pbuf;
+	for (k = 0; k < width; ++k)
+	{	/* Digit k from the least significant one. */
+		REGISTER size_t * pc;
+		REGISTER size_t sum;
+		REGISTER UCHART msk = k + 1 == width ? flip : 0;
+		d = bmsbfirst ? width - 1 - k : k;
+		pc = &pcnt[d * (UCHAR_MAX + 1)];
+		if (num == pc[(UCHART)(ps[offset + d])]) /* Probe the first element. */
+			continue; /* All elements share this digit. */
+		/* Turn counts into starting positions in order of flipped digits. */
+		for (sum = 0, i = 0; i <= UCHAR_MAX; ++i)
+		{
+			REGISTER size_t t = pc[i ^ msk];
+			pc[i ^ msk] = sum;
+			sum += t;
+		}
+		if (sizeof(size_t) == size)
+		{	/* Optimized loop for size_t. */
+			for (i = 0, p = ps; i < num; ++i, p += size)
+				((size_t *)pd)[pc[p[offset + d]]++] = *(size_t *)p;
+		}
+		else
+			for (i = 0, p = ps; i < num; ++i, p += size)
+				memcpy(pd + pc[p[offset + d]]++ * size, p, size);
+		p = ps;
+		ps = pd;
+		pd = p;
+	}
+	if (ps != (PUCHAR) pbase)
+		memcpy(pbase, ps, num * size);
+	free(pbuf);
+	free(pcnt);
+	return pbase;
+}
+
+/* Function name: svRadixSortInteger
+ * Description:   Sort an array by integer keys in elements with radix sort.
+ * Parameters:
+ *      pbase Pointer to the first object of the array to be sorted.
+ *        num Number of elements in the array.
+ *       size Size in bytes of each element in the array.
+ *     offset Offset in bytes of the key in each element. Input 0 if elements are integers themselves.
+ *      width Size in bytes of the key, e.g. sizeof(size_t).
+ *    bsigned Input true if keys are signed integers in two's complement, otherwise input false.
+ * Return value:  If sorting succeeded, this function would return the same pointer as pbase,
+ *                otherwise, this function would return NULL.
+ * Caution:       This sort is stable.
+ *                Keys are read in native byte order.
+ * Tip:           No comparison function is called. It takes at most width passes over the array
+ *                and one more pass to count digits, plus a buffer of num elements.
+ *                Passes of bytes that are the same in all keys are skipped.
+ * Usage:         typedef struct { size_t id; int score; } REC;
+ *                svRadixSortInteger(recs, n, sizeof(REC), offsetof(REC, score), sizeof(int), true);
+ */
+void * svRadixSortInteger(void * pbase, size_t num, size_t size, size_t offset, size_t width, bool bsigned)
+{
+	const size_t one = 1;
+	return _svRadixSort(pbase, num, size, offset, width, 1 != *(const UCHART *)&one, (UCHART)(bsigned ? 1 << (CHAR_BIT - 1) : 0));
+}
+
+/* Function name: svRadixSortBytes
+ * Description:   Sort an array by fixed length byte string keys in elements with radix sort.
+ * Parameters:
+ *      pbase Pointer to the first object of the array to be sorted.
+ *        num Number of elements in the array.
+ *       size Size in bytes of each element in the array.
+ *     offset Offset in bytes of the key in each element.
+ *      width Size in bytes of the key.
+ * Return value:  If sorting succeeded, this function would return the same pointer as pbase,
+ *                otherwise, this function would return NULL.
+ * Caution:       This sort is stable.
+ * Tip:           Keys are ordered as memcmp orders them.
+ *                Big endian unsigned integers can be sorted as byte strings as well.
+ */
+void * svRadixSortBytes(void * pbase, size_t num, size_t size, size_t offset, size_t width)
+{
+	return _svRadixSort(pbase, num, size, offset, width, true, 0);
+}
+
+#define _PAR_MINCHUNK 4096 /* Minimum number of elements in a chunk that is worth a thread. */
+/* Part i of n elements cut into d parts starts at i * n / d. It is computed without overflow for i <= d. */
+#define _PAR_SPLIT(n, i, d) ((n) / (d) * (i) + (n) % (d) * (i) / (d))
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _svCoRank
+ * Description:   Count elements of the former array among the first k outputs of a stable merge.
+ * Parameters:
+ *          k Number of outputs.
+ *         pa Pointer to the former sorted array.
+ *         na Number of elements in pa.
+ *         pb Pointer to the latter sorted array.
+ *         nb Number of elements in pb.
+ *       size Size of each element.
+ *     cbfcmp Pointer to a function that compares two elements.
+ * Return value:  Number of elements of pa. The rest k minus it come from pb.
+ */
+size_t _svCoRank(size_t k, PUCHAR pa, size_t na, PUCHAR pb, size_t nb, size_t size, CBF_COMPARE cbfcmp)
+{
+	REGISTER size_t lo = k > nb ? k - nb : 0, hi = k < na ? k : na, m;
+	while (lo < hi)
+	{	/* Elements of pa go first on ties. */
+		m = lo + ((hi - lo) >> 1);
+		if (cbfcmp(pa + m * size, pb + (k - m - 1) * size) <= 0)
+			lo = m + 1;
+		else
+			hi = m;
+	}
+	return lo;
+}
+
+/* Function name: svParallelSort
+ * Description:   Sort an array in chunks and merge chunks, with threads if OpenMP is enabled.
+ * Parameters:
+ *      pbase Pointer to the first object of the array to be sorted.
+ *        num Number of elements in the array.
+ *       size Size in bytes of each element in the array.
+ *     cbfcmp Pointer to a function that compares two elements.
+ *            Please refer to the type definition CBF_COMPARE in svdef.h.
+ *    nthread Number of threads. Input 0 or 1 to sort in the calling thread only.
+ *    bstable Input true to sort stably, otherwise input false.
+ * Return value:  If sorting succeeded, this function would return the same pointer as pbase,
+ *                otherwise, this function would return NULL.
+ * Caution:       cbfcmp shall be safe to be called by threads at the same time.
+ * Tip:           Loops below run on a team of nthread threads if this file is compiled with OpenMP,
+ *                otherwise the same chunks and merges run one by one. Refer to the note of platform hooks in svdef.h.
+ *                The array is cut into nthread chunks that are sorted by svIntroSort or svTimSort at the same time.
+ *                Then pairs of sorted runs are merged in log2(nthread) rounds. Each round cuts its outputs into
+ *                nthread parts by co-ranking, so that even the last merge of two runs is shared by all threads.
+ *                A buffer of num elements is allocated for merging.
+ */
+void * svParallelSort(void * pbase, size_t num, size_t size, CBF_COMPARE cbfcmp, size_t nthread, bool bstable)
+{
+	PUCHAR pbuf, psrc, pdst;
+	size_t w, npair, nseg;
+	long t;
+	bool bfail = false;
+	if (nthread > num / _PAR_MINCHUNK)
+		nthread = num / _PAR_MINCHUNK;
+	if (nthread < 2)
+		return bstable ? svTimSort(pbase, num, size, cbfcmp) : svIntroSort(pbase, num, size, cbfcmp);
+	if (NULL == (pbuf = (PUCHAR) malloc(num * size)))
+		return NULL;
+	/* Chunk t covers [t * num / nthread, (t + 1) * num / nthread). */
+#ifdef _OPENMP
+	#pragma omp parallel for num_threads(nthread) schedule(static) reduction(||:bfail)
+#endif
+	for (t = 0; t < (long)nthread; ++t)
+	{
+		size_t lo = _PAR_SPLIT(num, (size_t)t, nthread), hi = _PAR_SPLIT(num, (size_t)t + 1, nthread);
+		PUCHAR p = (PUCHAR) pbase + lo * size;
+		if (NULL == (bstable ? svTimSort(p, hi - lo, size, cbfcmp) : svIntroSort(p, hi - lo, size, cbfcmp)))
+			bfail = true;
+	}
+	if (bfail)
+		goto Lbl_Failure;
+	/* Merge runs of w chunks pairwise. */
+	psrc = (PUCHAR) pbase;
+	pdst = pbuf;
+	for (w = 1; w < nthread; w <<= 1)
+	{
+		npair = (nthread + 2 * w - 1) / (2 * w);
+		nseg  = nthread / npair > 0 ? nthread / npair : 1;
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(nthread) schedule(static)
+#endif
+		for (t = 0; t < (long)(npair * nseg); ++t)
+		{
+			size_t p = (size_t)t / nseg, q = (size_t)t % nseg;
+			size_t c0 = 2 * w * p, c1 = c0 + w < nthread ? c0 + w : nthread, c2 = c0 + 2 * w < nthread ? c0 + 2 * w : nthread;
+			size_t lo = _PAR_SPLIT(num, c0, nthread), mid = _PAR_SPLIT(num, c1, nthread), hi = _PAR_SPLIT(num, c2, nthread);
+			size_t k0 = _PAR_SPLIT(hi - lo, q, nseg), k1 = _PAR_SPLIT(hi - lo, q + 1, nseg);
+			PUCHAR pa = psrc + lo * size, pb = psrc + mid * size, pd = pdst + (lo + k0) * size;
+			size_t i = _svCoRank(k0, pa, mid - lo, pb, hi - mid, size, cbfcmp), j = k0 - i;
+			size_t i1 = _svCoRank(k1, pa, mid - lo, pb, hi - mid, size, cbfcmp), j1 = k1 - i1;
+			while (i < i1 && j < j1)
+			{
+				if (cbfcmp(pb + j * size, pa + i * size) < 0)
+					memcpy(pd, pb + j++ * size, size);
+				else
+					memcpy(pd, pa + i++ * size, size);
+				pd += size;
+			}
+			memcpy(pd, pa + i * size, (i1 - i) * size);
+			pd += (i1 - i) * size;
+			memcpy(pd, pb + j * size, (j1 - j) * size);
+		}
+		psrc = pdst;
+		pdst = pbuf == pdst ? (PUCHAR) pbase : pbuf;
+	}
+	if (psrc != (PUCHAR) pbase)
+		memcpy(pbase, psrc, num * size);
+	free(pbuf);
+	return pbase;
+Lbl_Failure:
+	free(pbuf);
+	return NULL;
+}
+
+#undef _PAR_MINCHUNK
+#undef _PAR_SPLIT
+
+#define _ARG_RUN 16 /* Length of runs that are sorted by insertion before merging indices. */
+#define _ARG_REC(i) (pb + (i) * size) /* Locate a record by its index. */
+
+/* Function name: svArgSort
+ * Description:   Sort indices of an array by comparing records they refer to, leaving records in place.
+ * Parameters:
+ *      pbase Pointer to the first object of the array.
+ *        num Number of elements in the array.
+ *       size Size in bytes of each element in the array.
+ *     cbfcmp Pointer to a function that compares two elements.
+ *            Please refer to the type definition CBF_COMPARE in svdef.h.
+ *       pidx Pointer to an array of num size_t integers that receives indices.
+ * Return value:  pidx or NULL if allocation failed.
+ * Caution:       This sort is stable. Indices of equal records remain increasing.
+ * Tip:           After sorting, pbase[pidx[0]], pbase[pidx[1]] ... are in order.
+ *                Only indices are moved, so that wide records cost the same as narrow ones.
+ *                Users may call svPermute to move records into the order once, or to reorder parallel arrays.
+ *                It takes O(n*log n) comparisons and a buffer of num size_t integers.
+ */
+size_t * svArgSort(const void * pbase, size_t num, size_t size, CBF_COMPARE cbfcmp, size_t * pidx)
+{
+	REGISTER size_t i, j, k, w;
+	REGISTER const UCHART * pb = (const UCHART *) pbase;
+	size_t * psrc, * pdst, * pbuf;
+	for (i = 0; i < num; ++i)
+		pidx[i] = i;
+	/* Insertion sort for short runs. */
+	for (i = 0; i < num; i += _ARG_RUN)
+	{
+		REGISTER size_t n = num - i < _ARG_RUN ? num - i : _ARG_RUN;
+		for (j = 1; j < n; ++j)
+		{
+			w = pidx[i + j];
+			for (k = j; k > 0 && cbfcmp(_ARG_REC(pidx[i + k - 1]), _ARG_REC(w)) > 0; --k)
+				pidx[i + k] = pidx[i + k - 1];
+			pidx[i + k] = w;
+		}
+	}
+	if (num <= _ARG_RUN)
+		return pidx;
+	if (NULL == (pbuf = (size_t *) malloc(num * sizeof(size_t))))
+		return NULL;
+	psrc = pidx;
+	pdst = pbuf;
+	for (w = _ARG_RUN; w < num; w <<= 1)
+	{
+		for (i = 0; i < num; i += w << 1)
+		{
+			REGISTER size_t a = i, x = i + w < num ? i + w : num, b = x, y = i + (w << 1) < num ? i + (w << 1) : num;
+			k = i;
+			if (b < y && cbfcmp(_ARG_REC(psrc[x - 1]), _ARG_REC(psrc[b])) <= 0)
+			{	/* Runs are in order already. */
+				memcpy(pdst + i, psrc + i, (y - i) * sizeof(size_t));
+				continue;
+			}
+			while (a < x && b < y)
+				pdst[k++] = cbfcmp(_ARG_REC(psrc[a]), _ARG_REC(psrc[b])) <= 0 ? psrc[a++] : psrc[b++];
+			while (a < x)
+				pdst[k++] = psrc[a++];
+			while (b < y)
+				pdst[k++] = psrc[b++];
+		}
+		psrc = pdst;
+		pdst = pdst == pbuf ? pidx : pbuf;
+	}
+	if (psrc != pidx)
+		memcpy(pidx, psrc, num * sizeof(size_t));
+	free(pbuf);
+	return pidx;
+}
+
+#undef _ARG_RUN
+#undef _ARG_REC
+
+/* Highest bit of a size_t integer. It marks indices that have been visited. */
+#define _PERM_MARK (~(~(size_t)0 >> 1))
+
+/* Function name: svPermute
+ * Description:   Rearrange elements of an array in place by a permutation.
+ * Parameters:
+ *      pbase Pointer to the first object of the array.
+ *        num Number of elements in the array.
+ *       size Size in bytes of each element in the array.
+ *       pidx Pointer to an array of num size_t integers that is a permutation of 0 to num - 1.
+ *            Element i of the array becomes the former element pidx[i].
+ * Return value:  pbase or NULL if allocation failed.
+ * Caution:       pidx is altered while it is in use and restored on return, so that it shall not be shared meanwhile.
+ *                num shall be less than the highest bit of size_t.
+ * Tip:           Each cycle of the permutation is followed once, so that each element is moved once
+ *                and only one element is buffered. Apply the result of svArgSort to sort records or parallel arrays.
+ */
+void * svPermute(void * pbase, size_t num, size_t size, size_t * pidx)
+{
+	REGISTER size_t i, j, k;
+	REGISTER PUCHAR pb = (PUCHAR) pbase;
+	PUCHAR ptemp;
+	UCHART tmpbuf[BUFSIZ];
+	if (NULL == (ptemp = size <= BUFSIZ ? tmpbuf : (PUCHAR) malloc(size)))
+		return NULL;
+	for (i = 0; i < num; ++i)
+	{
+		if ((pidx[i] & _PERM_MARK) || pidx[i] == i)
+			continue; /* Visited or fixed. */
+		memcpy(ptemp, pb + i * size, size);
+		for (j = i; (k = pidx[j]) != i; j = k)
+		{
+			memcpy(pb + j * size, pb + k * size, size);
+			pidx[j] |= _PERM_MARK;
+		}
+		memcpy(pb + j * size, ptemp, size);
+		pidx[j] |= _PERM_MARK;
+	}
+	for (i = 0; i < num; ++i)
+		pidx[i] &= ~_PERM_MARK;
+	if (tmpbuf != ptemp)
+		free(ptemp);
+	return pbase;
+}
+
+#undef _PERM_MARK
+
 /* Function name: svBinarySearch
  * Description:   Generic binary search algorithm.
  * Parameters:
@@ -917,6 +1892,87 @@ void * svBinarySearchDispatch(const void * pkey, const void * pbase, size_t num,
 	return NULL; /* Argument error. */
 }
 
+#define _BATCH_LANES 16 /* Number of searches that advance in lockstep. */
+
+/* Function name: svBatchBinarySearch
+ * Description:   Binary search a block of consecutive memory for many keys at once by given condition.
+ * Parameters:
+ *      pkeys Pointer to the first key of an array of keys.
+ *       nkey Number of keys.
+ *      ksize Size in bytes of each key.
+ *      pbase Pointer to the first object of the array to search.
+ *        num Number of elements in an array that pointed by base.
+ *       size Size in bytes of each element in the array.
+ *     cbfcmp Pointer to a function that compares two elements.
+ *            The left pointer of function cbfcmp always points to a key.
+ *            The right pointer of function cbfcmp may point to any position in the array.
+ *            Please refer to the type definition CBF_COMPARE in svdef.h.
+ *     method An enumeration indicates the method of searching. Refer to svBinarySearchDispatch.
+ *    presult Pointer to an array of nkey pointers that receives results.
+ *            presult[i] is what svBinarySearchDispatch would return for key i.
+ * Return value:  true  Searching succeeded.
+ *                false The value of parameter method does not belong to BSearch.
+ * Caution:       Binary search must be performed on an ordered array usually sorted increasingly.
+ * Tip:           A single binary search waits for each cache miss before it can choose the next probe.
+ *                This function advances 16 searches in lockstep. Every search takes the same number of steps
+ *                and chooses its half without branching, so that misses of different searches overlap.
+ *                The next probe of each search is known one step ahead and is prefetched by SV_PREFETCH in svdef.h.
+ *                Keys need not be sorted.
+ */
+bool svBatchBinarySearch(const void * pkeys, size_t nkey, size_t ksize, const void * pbase, size_t num, size_t size, CBF_COMPARE cbfcmp, BSearch method, void ** presult)
+{
+	size_t base[_BATCH_LANES];
+	REGISTER size_t i, j, g, n, h;
+	REGISTER int t;
+	REGISTER const UCHART * pk = (const UCHART *) pkeys, * pb = (const UCHART *) pbase;
+	switch (method)
+	{
+	case EBS_FIRST_GREATER_THAN_OR_EQUAL_TO_KEY:
+	case EBS_LAST_LESS_THAN_KEY:
+		t = 1; /* Go right if key > element. */
+		break;
+	case EBS_FIRST_GREATER_THAN_KEY:
+	case EBS_LAST_LESS_THAN_OR_EQUAL_TO_KEY:
+		t = 0; /* Go right if key >= element. */
+		break;
+	default:
+		return false; /* Argument error. */
+	}
+	for (i = 0; i < nkey; i += g, pk += g * ksize)
+	{
+		g = nkey - i < _BATCH_LANES ? nkey - i : _BATCH_LANES;
+		if (0 == num)
+		{
+			for (j = 0; j < g; ++j)
+				presult[i + j] = NULL;
+			continue;
+		}
+		for (j = 0; j < g; ++j)
+			base[j] = 0;
+		/* The answer of search j lies in [base[j], base[j] + n]. */
+		for (n = num; n > 1; n -= h)
+		{
+			h = n >> 1;
+			for (j = 0; j < g; ++j)
+			{
+				base[j] += h * (size_t)(cbfcmp(pk + j * ksize, pb + (base[j] + h) * size) >= t);
+				SV_PREFETCH(pb + (base[j] + ((n - h) >> 1)) * size);
+			}
+		}
+		for (j = 0; j < g; ++j)
+		{	/* Index of the first element that search j would not go right of. */
+			h = base[j] + (size_t)(cbfcmp(pk + j * ksize, pb + base[j] * size) >= t);
+			if (EBS_FIRST_GREATER_THAN_OR_EQUAL_TO_KEY == method || EBS_FIRST_GREATER_THAN_KEY == method)
+				presult[i + j] = num == h ? NULL : (void *)(pb + h * size);
+			else
+				presult[i + j] = 0 == h ? NULL : (void *)(pb + (h - 1) * size);
+		}
+	}
+	return true;
+}
+
+#undef _BATCH_LANES
+
 /* Function name: svIndexOf_O
  * Description:   Return the index of an object starting from pbase in a consecutive memory space.
  * Parameters:
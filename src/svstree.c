@@ -2,7 +2,7 @@
  * Name:        svstree.c
  * Description: Search trees.
  * Author:      cosh.cage#hotmail.com
- * File ID:     0809171737I0809260645L02544
+ * File ID:     0809171737I1018262354L07990
  * License:     LGPLv3
  * Copyright (C) 2017-2026 John Cage
  *
@@ -22,7 +22,7 @@
  */
 
 #include <stdlib.h> /* Using function malloc, free. */
-#include <string.h> /* Using function memcpy, memmove. */
+#include <string.h> /* Using function memcpy, memmove, strlen. */
 #include "svtree.h"
 
 /* A macro describes children nodes pointers of a BST node. */
@@ -246,6 +246,358 @@ P_BSTNODE treBSTFindData_N(P_BSTNODE proot, const void * pitem, CBF_COMPARE cbfc
 	return NULL;
 }
 
+/* Cursors for binary search trees are implemented in the following section. */
+
+/* Function declarations for BST cursors. */
+void * _treBSTCursorDescend (P_BSTCURSOR pcur, P_BSTNODE pnode, bool bright);
+void * _treBSTCursorStep    (P_BSTCURSOR pcur, bool      bright);
+
+/* Function name: treInitBSTCursor
+ * Description:   Initialize a cursor for a binary search tree.
+ * Parameters:
+ *       pcur Pointer to the cursor you want to initialize.
+ *      proot Pointer to the root node of the tree that the cursor walks through.
+ * Return value:  N/A.
+ * Caution:       Address of pcur Must Be Allocated first.
+ *                A cursor does not need to be freed.
+ *                The cursor points nowhere after initialization.
+ *                Call treBSTCursorFirst, treBSTCursorLast or treBSTCursorSeek to place it on a node.
+ * Tip:           Red black trees can be walked through by this cursor as well. Use P2P_BSTNODE to cast the root.
+ */
+void treInitBSTCursor(P_BSTCURSOR pcur, P_BSTNODE proot)
+{
+	pcur->proot = proot;
+	pcur->pnode = NULL;
+	pcur->depth = 0;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treBSTCursorDescend
+ * Description:   Move a cursor to pnode, then keep on going down to the leftmost or the rightmost descendant of pnode.
+ * Parameters:
+ *       pcur Pointer to a cursor.
+ *      pnode Pointer to the node to start with. Its ancestors must have been pushed already.
+ *     bright Input true to go to the rightmost node; Input false to go to the leftmost node.
+ * Return value:  Data pointer of the node that cursor rests on.
+ *                If the ancestor stack overflowed, function would return NULL and cursor would point nowhere.
+ */
+void * _treBSTCursorDescend(P_BSTCURSOR pcur, P_BSTNODE pnode, bool bright)
+{
+	if (NULL != pnode)
+	{
+		while (NULL != pbstchild(pnode)[bright])
+		{
+			if (pcur->depth >= BST_CURSOR_DEPTH)
+			{
+				pnode = NULL;
+				break;
+			}
+			pcur->pstack[pcur->depth++] = pnode;
+			pnode = pbstchild(pnode)[bright];
+		}
+	}
+	if (NULL == (pcur->pnode = pnode))
+	{
+		pcur->depth = 0;
+		return NULL;
+	}
+	return pnode->knot.pdata;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treBSTCursorStep
+ * Description:   Move a cursor to the in-order successor or predecessor of the current node.
+ * Parameters:
+ *       pcur Pointer to a cursor.
+ *     bright Input true to move to successor; Input false to move to predecessor.
+ * Return value:  Data pointer of the node that cursor rests on.
+ *                NULL indicates cursor went off the tree.
+ */
+void * _treBSTCursorStep(P_BSTCURSOR pcur, bool bright)
+{
+	REGISTER P_BSTNODE pnode = pcur->pnode, pparent;
+	if (NULL == pnode)
+		return NULL;
+	if (NULL != pbstchild(pnode)[bright])
+	{	/* Go one step along direction bright then all the way back along the other direction. */
+		if (pcur->depth >= BST_CURSOR_DEPTH)
+			return _treBSTCursorDescend(pcur, NULL, ! bright);
+		pcur->pstack[pcur->depth++] = pnode;
+		return _treBSTCursorDescend(pcur, pbstchild(pnode)[bright], ! bright);
+	}
+	/* Climb up until we came from the other side of an ancestor. */
+	while (0 != pcur->depth)
+	{
+		pparent = pcur->pstack[--pcur->depth];
+		if (pbstchild(pparent)[! bright] == pnode)
+		{
+			pcur->pnode = pparent;
+			return pparent->knot.pdata;
+		}
+		pnode = pparent;
+	}
+	pcur->pnode = NULL;
+	return NULL;
+}
+
+/* Function name: treBSTCursorFirst
+ * Description:   Move a cursor to the minimum node in a binary search tree.
+ * Parameter:
+ *      pcur Pointer to a cursor.
+ * Return value:  Data pointer of the minimum node.
+ *                NULL indicates the tree is empty.
+ */
+void * treBSTCursorFirst(P_BSTCURSOR pcur)
+{
+	pcur->depth = 0;
+	return _treBSTCursorDescend(pcur, pcur->proot, LEFT);
+}
+
+/* Function name: treBSTCursorLast
+ * Description:   Move a cursor to the maximum node in a binary search tree.
+ * Parameter:
+ *      pcur Pointer to a cursor.
+ * Return value:  Data pointer of the maximum node.
+ *                NULL indicates the tree is empty.
+ */
+void * treBSTCursorLast(P_BSTCURSOR pcur)
+{
+	pcur->depth = 0;
+	return _treBSTCursorDescend(pcur, pcur->proot, RIGHT);
+}
+
+/* Function name: treBSTCursorNext
+ * Description:   Move a cursor to the next node in order.
+ * Parameter:
+ *      pcur Pointer to a cursor.
+ * Return value:  Data pointer of the next node.
+ *                NULL indicates cursor has passed the maximum node.
+ * Caution:       Cursor would stay off the tree once it returned NULL.
+ *                Do not alter the tree while a cursor is resting on it.
+ * Tip:           Several cursors may walk through a same tree at the same time,
+ *                because cursors only read the tree. There is no need of callbacks.
+ * Usage:         BSTCURSOR cur;
+ *                void * pdata;
+ *                treInitBSTCursor(&cur, *pbst);
+ *                for (pdata = treBSTCursorFirst(&cur); NULL != pdata; pdata = treBSTCursorNext(&cur))
+ *                    printf("%d ", *(int *)pdata);
+ */
+void * treBSTCursorNext(P_BSTCURSOR pcur)
+{
+	return _treBSTCursorStep(pcur, RIGHT);
+}
+
+/* Function name: treBSTCursorPrev
+ * Description:   Move a cursor to the previous node in order.
+ * Parameter:
+ *      pcur Pointer to a cursor.
+ * Return value:  Data pointer of the previous node.
+ *                NULL indicates cursor has passed the minimum node.
+ * Caution:       Cursor would stay off the tree once it returned NULL.
+ *                Do not alter the tree while a cursor is resting on it.
+ */
+void * treBSTCursorPrev(P_BSTCURSOR pcur)
+{
+	return _treBSTCursorStep(pcur, LEFT);
+}
+
+/* Function name: treBSTCursorSeek
+ * Description:   Move a cursor to the first node whose data is not less than pitem.
+ * Parameters:
+ *       pcur Pointer to a cursor.
+ *      pitem Pointer to an element to seek.
+ *     cbfcmp Pointer to a callback comparison function.
+ * Return value:  Data pointer of the node that cursor rests on.
+ *                NULL indicates every node in the tree is less than pitem.
+ * Caution:       Parameter cbfcmp should be the same function that was used to build the tree.
+ */
+void * treBSTCursorSeek(P_BSTCURSOR pcur, const void * pitem, CBF_COMPARE cbfcmp)
+{
+	REGISTER P_BSTNODE pnode = pcur->proot, pfound = NULL;
+	REGISTER size_t i = 0, j = 0;
+	while (NULL != pnode)
+	{
+		if (i >= BST_CURSOR_DEPTH)
+		{
+			pfound = NULL;
+			break;
+		}
+		if (cbfcmp(pitem, pnode->knot.pdata) > 0)
+		{
+			pcur->pstack[i++] = pnode;
+			pnode = pbstchild(pnode)[RIGHT];
+		}
+		else
+		{	/* Record the candidate and its depth, then search its left subtree for a smaller one. */
+			pfound = pnode;
+			j = i;
+			pcur->pstack[i++] = pnode;
+			pnode = pbstchild(pnode)[LEFT];
+		}
+	}
+	/* Ancestors of the candidate are exactly the first j nodes on the search path. */
+	pcur->depth = NULL == pfound ? 0 : j;
+	pcur->pnode = pfound;
+	return NULL == pfound ? NULL : pfound->knot.pdata;
+}
+
+/* Bulk building of balanced binary search trees is implemented in the following section. */
+
+/* Levels of an AA-tree or black heights of a red black tree that a bulk builder could meet. */
+#define _BULK_LEVELS (CHAR_BIT * sizeof(size_t) + 1)
+
+/* A structure that holds the context of a bulk building procedure. */
+typedef struct _st_BST_BULK {
+	PUCHAR pbase;               /* Sorted source array. */
+	PUCHAR pslab;               /* Nodes and data of the whole tree. NULL for separately allocated nodes. */
+	size_t num;                 /* Number of elements. */
+	size_t size;                /* Size of each element. */
+	size_t inext;               /* Index of the next unused node in the slab. */
+	bool   brbt;                /* true for red black tree nodes. false for BST nodes. */
+	bool   bfail;               /* true if any allocation failed. */
+	size_t maxn[_BULK_LEVELS];  /* maxn[l] is the maximum number of elements a 2-3 tree of height l can hold. */
+} _BST_BULK, * _P_BST_BULK;
+
+/* File level function declarations for bulk building. */
+bool      _treInitBulkBST    (_P_BST_BULK pbk,   P_ARRAY_Z parrz, size_t    size,  bool      brbt,  bool      bslab);
+P_BSTNODE _treNewBulkNodeBST (_P_BST_BULK pbk,   size_t    i,     size_t    param, P_BSTNODE parent);
+P_BSTNODE _treBulkBuild23BST (_P_BST_BULK pbk,   size_t    lo,    size_t    n,     size_t    level, P_BSTNODE parent);
+size_t    _treBulkLevelBST   (size_t      num);
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treInitBulkBST
+ * Description:   Prepare a context for bulk building.
+ * Parameters:
+ *        pbk Pointer to the context.
+ *      parrz Pointer to a sorted array.
+ *       size Size of each element in the array.
+ *       brbt Input true to build red black tree nodes; Input false to build BST nodes.
+ *      bslab Input true to allocate all nodes and data in a single slab.
+ * Return value:  true:  Succeeded.
+ *                false: Allocation failure.
+ */
+bool _treInitBulkBST(_P_BST_BULK pbk, P_ARRAY_Z parrz, size_t size, bool brbt, bool bslab)
+{
+	REGISTER size_t i, ndsiz = brbt ? sizeof(RBTNODE) : sizeof(BSTNODE);
+	pbk->pbase = parrz->pdata;
+	pbk->pslab = NULL;
+	pbk->num   = strLevelArrayZ(parrz);
+	pbk->size  = size;
+	pbk->inext = 0;
+	pbk->brbt  = brbt;
+	pbk->bfail = false;
+	/* A 2-3 tree of height l holds 3^l - 1 elements at most. Saturate it to avoid overflow. */
+	pbk->maxn[0] = 0;
+	for (i = 1; i < _BULK_LEVELS; ++i)
+		pbk->maxn[i] = pbk->maxn[i - 1] > ((size_t)~0 >> 2) / 3 ? pbk->maxn[i - 1] : pbk->maxn[i - 1] * 3 + 2;
+	if (bslab)
+	{	/* Nodes come first, then data in the rest of the slab. */
+		if (pbk->num > (size_t)~0 / (ndsiz + ALIGN_SIZET(size)))
+			return false;
+		if (NULL == (pbk->pslab = (PUCHAR) malloc(pbk->num * (ndsiz + ALIGN_SIZET(size)))))
+			return false;
+	}
+	return true;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treNewBulkNodeBST
+ * Description:   Fetch a new node for the i-th element from the slab or from the heap.
+ * Parameters:
+ *        pbk Pointer to the context.
+ *          i Index of the element in the source array.
+ *      param Parameter of the new node.
+ *     parent Pointer to the parent of the new node. It is only used by red black trees.
+ * Return value:  Pointer to the new node. NULL indicates an allocation failure.
+ */
+P_BSTNODE _treNewBulkNodeBST(_P_BST_BULK pbk, size_t i, size_t param, P_BSTNODE parent)
+{
+	REGISTER P_BSTNODE pnode;
+	if (NULL != pbk->pslab)
+	{
+		REGISTER size_t ndsiz = pbk->brbt ? sizeof(RBTNODE) : sizeof(BSTNODE);
+		pnode = P2P_BSTNODE(pbk->pslab + pbk->inext * ndsiz);
+		pnode->knot.pdata = pbk->pslab + pbk->num * ndsiz + pbk->inext * ALIGN_SIZET(pbk->size);
+		memcpy(pnode->knot.pdata, pbk->pbase + i * pbk->size, pbk->size);
+		pnode->knot.ppnode[LEFT] = pnode->knot.ppnode[RIGHT] = NULL;
+		pnode->param = param;
+		if (pbk->brbt)
+			P2P_RBTNODE(pnode)->parent = P2P_RBTNODE(parent);
+		++pbk->inext;
+	}
+	else
+	{
+		if (pbk->brbt)
+			pnode = P2P_BSTNODE(treCreateRBTNode(pbk->pbase + i * pbk->size, pbk->size, (RBTColor)param, P2P_RBTNODE(parent)));
+		else
+			pnode = treCreateBSTNode(pbk->pbase + i * pbk->size, pbk->size, param);
+		if (NULL == pnode)
+			pbk->bfail = true;
+	}
+	return pnode;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treBulkBuild23BST
+ * Description:   Build a 2-3 tree of a given height out of sorted elements in O(n),
+ *                and represent each 3-node by a node and its right child.
+ *                The right child is a horizontal link in an AA-tree or a red node in a red black tree.
+ * Parameters:
+ *        pbk Pointer to the context.
+ *         lo Index of the first element in the source array.
+ *          n Number of elements. (2^level - 1) <= n <= (3^level - 1).
+ *      level Height of the 2-3 tree, which is also the level of the root in an AA-tree.
+ *     parent Pointer to the parent of the subtree.
+ * Return value:  Pointer to the root of the subtree.
+ */
+P_BSTNODE _treBulkBuild23BST(_P_BST_BULK pbk, size_t lo, size_t n, size_t level, P_BSTNODE parent)
+{
+	REGISTER P_BSTNODE px, pr;
+	REGISTER size_t a, b;
+	if (0 == n || 0 == level)
+		return NULL;
+	if (n - 1 <= pbk->maxn[level - 1] << 1)
+	{	/* A 2-node. */
+		a = (n - 1) >> 1;
+		if (NULL == (px = _treNewBulkNodeBST(pbk, lo + a, pbk->brbt ? BLACK : level, parent)))
+			return NULL;
+		pbstchild(px)[LEFT]  = _treBulkBuild23BST(pbk, lo, a, level - 1, px);
+		pbstchild(px)[RIGHT] = _treBulkBuild23BST(pbk, lo + a + 1, n - 1 - a, level - 1, px);
+	}
+	else
+	{	/* A 3-node. */
+		a = (n - 2) / 3;
+		b = (n - 2 - a) >> 1;
+		if (NULL == (px = _treNewBulkNodeBST(pbk, lo + a, pbk->brbt ? BLACK : level, parent)))
+			return NULL;
+		pbstchild(px)[LEFT] = _treBulkBuild23BST(pbk, lo, a, level - 1, px);
+		if (NULL == (pr = _treNewBulkNodeBST(pbk, lo + a + 1 + b, pbk->brbt ? RED : level, px)))
+			return px;
+		pbstchild(px)[RIGHT] = pr;
+		pbstchild(pr)[LEFT]  = _treBulkBuild23BST(pbk, lo + a + 1, b, level - 1, pr);
+		pbstchild(pr)[RIGHT] = _treBulkBuild23BST(pbk, lo + a + 2 + b, n - 2 - a - b, level - 1, pr);
+	}
+	return px;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treBulkLevelBST
+ * Description:   Calculate the height of a 2-3 tree that holds num elements in bulk building.
+ * Parameter:
+ *        num Number of elements.
+ * Return value:  floor(log2(num + 1)).
+ */
+size_t _treBulkLevelBST(size_t num)
+{
+	REGISTER size_t level = 0;
+	while (num > 0)
+	{
+		num = (num - 1) >> 1;
+		++level;
+	}
+	return level;
+}
+
 /* AA-tree implementation is achieved in the following section. */
 
 /* Function declarations for AA-trees. */
@@ -396,6 +748,39 @@ P_BSTNODE treBSTRemoveAA(P_BSTNODE pnode, const void * pitem, size_t size, CBF_C
 	return pnode;
 }
 
+/* Function name: treBulkBuildAA
+ * Description:   Build an AA-tree from a sorted array in O(n).
+ * Parameters:
+ *      parrz Pointer to a sorted array.
+ *       size Size of each element in the array.
+ *      bslab Input true to allocate all nodes and their data in one single block.
+ *            Input false to allocate each node separately like function treBSTInsertAA does.
+ * Return value:  Pointer to the root node of the new AA-tree.
+ *                If the array were empty or allocation failed, function would return NULL.
+ * Caution:       Elements in parrz must be sorted in ascending order by the comparison function that
+ *                will be used to search the tree.
+ *                If bslab is true, the returned root is the address of the whole block.
+ *                Such a tree can be searched, traversed and copied, but do not insert nodes into it or remove nodes from it,
+ *                and release it by function free instead of treFreeBST.
+ *                If bslab is false, the result is a valid AA-tree that functions treBSTInsertAA and treBSTRemoveAA accept.
+ * Tip:           Levels are assigned by building a 2-3 tree whose 3-nodes are represented by horizontal right links.
+ * Usage:         P_BST pbst = treCreateBST();
+ *                strSortArrayZ(parrz, sizeof(int), cbfcmp, false);
+ *                *pbst = treBulkBuildAA(parrz, sizeof(int), false);
+ *                treDeleteBST(pbst);
+ */
+P_BSTNODE treBulkBuildAA(P_ARRAY_Z parrz, size_t size, bool bslab)
+{
+	_BST_BULK bk;
+	P_BSTNODE proot;
+	if (0 == strLevelArrayZ(parrz) || ! _treInitBulkBST(&bk, parrz, size, false, bslab))
+		return NULL;
+	proot = _treBulkBuild23BST(&bk, 0, bk.num, _treBulkLevelBST(bk.num), NULL);
+	if (bk.bfail)
+		treFreeBST(&proot);
+	return proot;
+}
+
 /* An implementation for AVL-tree is listed below. */
 
 /* An enumeration describes the balance factor for AVL-tree nodes. */
@@ -411,6 +796,7 @@ ptrdiff_t _treBSTGetBalanceFactorAVL_O  (P_BSTNODE pnode);
 ptrdiff_t _treBSTMaxBalanceFactorAVL_O  (ptrdiff_t lbf,   ptrdiff_t rbf);
 ptrdiff_t _treBSTReadBalanceFactorAVL_O (P_BSTNODE pnode);
 P_BSTNODE _treBSTRotateAVL              (P_BSTNODE pnode, bool      bright);
+P_BSTNODE _treBulkBuildAVLPuppet        (_P_BST_BULK pbk, size_t    lo,     size_t    n);
 
 /* Inline function macros are defined here. */
 #define _treBSTGetBalanceFactorAVL_M(pnode_M) (NULL == (pnode_M) ? _ABF_BALANCED : _NODE_PARAM((pnode_M), const ptrdiff_t))
@@ -679,6 +1065,60 @@ P_BSTNODE treBSTRemoveAVL(P_BSTNODE pnode, const void * pitem, size_t size, CBF_
 	return pnode;
 }
 
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treBulkBuildAVLPuppet
+ * Description:   Build an AVL-tree by splitting sorted elements at the middle recursively.
+ * Parameters:
+ *        pbk Pointer to the context.
+ *         lo Index of the first element in the source array.
+ *          n Number of elements.
+ * Return value:  Pointer to the root of the subtree.
+ */
+P_BSTNODE _treBulkBuildAVLPuppet(_P_BST_BULK pbk, size_t lo, size_t n)
+{
+	REGISTER P_BSTNODE pnode;
+	if (0 == n)
+		return NULL;
+	if (NULL == (pnode = _treNewBulkNodeBST(pbk, lo + (n >> 1), _ABF_BALANCED, NULL)))
+		return NULL;
+	pbstchild(pnode)[LEFT]  = _treBulkBuildAVLPuppet(pbk, lo, n >> 1);
+	pbstchild(pnode)[RIGHT] = _treBulkBuildAVLPuppet(pbk, lo + (n >> 1) + 1, n - 1 - (n >> 1));
+	/* Heights are recalculated the same way as function treBSTInsertAVL does. */
+	if (NULL != pbstchild(pnode)[LEFT] || NULL != pbstchild(pnode)[RIGHT])
+		_NODE_PARAM(pnode, ptrdiff_t) = _ABF_HEAVY_LT + _treBSTMaxBalanceFactorAVL
+		(
+			_treBSTGetBalanceFactorAVL(pbstchild(pnode)[LEFT]),
+			_treBSTGetBalanceFactorAVL(pbstchild(pnode)[RIGHT])
+		);
+	return pnode;
+}
+
+/* Function name: treBulkBuildAVL
+ * Description:   Build an AVL-tree from a sorted array in O(n).
+ * Parameters:
+ *      parrz Pointer to a sorted array.
+ *       size Size of each element in the array.
+ *      bslab Input true to allocate all nodes and their data in one single block.
+ *            Input false to allocate each node separately like function treBSTInsertAVL does.
+ * Return value:  Pointer to the root node of the new AVL-tree.
+ *                If the array were empty or allocation failed, function would return NULL.
+ * Caution:       Elements in parrz must be sorted in ascending order.
+ *                If bslab is true, the returned root is the address of the whole block.
+ *                Such a tree can be searched, traversed and copied, but do not insert nodes into it or remove nodes from it,
+ *                and release it by function free instead of treFreeBST.
+ */
+P_BSTNODE treBulkBuildAVL(P_ARRAY_Z parrz, size_t size, bool bslab)
+{
+	_BST_BULK bk;
+	P_BSTNODE proot;
+	if (0 == strLevelArrayZ(parrz) || ! _treInitBulkBST(&bk, parrz, size, false, bslab))
+		return NULL;
+	proot = _treBulkBuildAVLPuppet(&bk, 0, bk.num);
+	if (bk.bfail)
+		treFreeBST(&proot);
+	return proot;
+}
+
 #undef _NODE_PARAM
 #undef pbstchild
 /* Undefine used macros for this section. */
@@ -704,7 +1144,7 @@ P_BSTNODE treBSTRemoveAVL(P_BSTNODE pnode, const void * pitem, size_t size, CBF_
 P_RBTNODE _treCopyRBTPuppet       (P_RBTNODE pnode, P_RBTNODE proot, size_t    size);
 int       _treCBFFreeNodeRBT      (void *    pitem, size_t    param);
 void      _treRBRotate            (P_RBT     prbt,  P_RBTNODE x,     bool      bright);
-void      _treRBInsertFixupPuppet (P_RBT     prbt,  P_RBTNODE z,     bool      bright);
+P_RBTNODE _treRBInsertFixupPuppet (P_RBT     prbt,  P_RBTNODE z,     bool      bright);
 void      _treRBInsertFixup       (P_RBT     prbt,  P_RBTNODE z);
 void      _treRBTransplant        (P_RBT     prbt,  P_RBTNODE u,     P_RBTNODE v);
 void      _treRBDeleteFixup       (P_RBT     prbt,  P_RBTNODE x);
@@ -929,9 +1369,9 @@ void _treRBRotate(P_RBT prbt, P_RBTNODE x, bool bright)
  *       prbt Pointer to a red black tree.
  *          z Pointer to a red black tree node.
  *     bright This parameter can either be LEFT/false or RIGHT/true.
- * Return value:  N/A.
+ * Return value:  Pointer to the node that the caller should continue fixing up with.
  */
-void _treRBInsertFixupPuppet(P_RBT prbt, P_RBTNODE z, bool bright)
+P_RBTNODE _treRBInsertFixupPuppet(P_RBT prbt, P_RBTNODE z, bool bright)
 {
 	REGISTER P_RBTNODE y = prbtchild(prbtparent(prbtparent(z)))[bright];
 			
@@ -956,6 +1396,7 @@ void _treRBInsertFixupPuppet(P_RBT prbt, P_RBTNODE z, bool bright)
 		
 		_treRBRotate(prbt, prbtparent(prbtparent(z)), bright);
 	}
+	return z;
 }
 
 /* Attention:     This Is An Internal Function. No Interface for Library Users.
@@ -968,15 +1409,12 @@ void _treRBInsertFixupPuppet(P_RBT prbt, P_RBTNODE z, bool bright)
  */
 void _treRBInsertFixup(P_RBT prbt, P_RBTNODE z)
 {
-	if (NULL != prbtparent(z))
+	while (NULL != prbtparent(z) && RED == _NODE_COLOR(prbtparent(z), const RBTColor))
 	{
-		while (RED == _NODE_COLOR(prbtparent(z), const RBTColor))
-		{
-			if (prbtparent(z) == prbtchild(prbtparent(prbtparent(z)))[LEFT])
-				_treRBInsertFixupPuppet(prbt, z, RIGHT);
-			else
-				_treRBInsertFixupPuppet(prbt, z, LEFT);
-		}
+		if (prbtparent(z) == prbtchild(prbtparent(prbtparent(z)))[LEFT])
+			z = _treRBInsertFixupPuppet(prbt, z, RIGHT);
+		else
+			z = _treRBInsertFixupPuppet(prbt, z, LEFT);
 	}
 	_NODE_COLOR(*prbt, RBTColor) = BLACK;
 }
@@ -1154,83 +1592,539 @@ void treRemoveRBT(P_RBT prbt, const void * pitem, CBF_COMPARE cbfcmp)
 	}
 }
 
+/* Function name: treRBTExtremum
+ * Description:   Find the minimum or the maximum node in a red black tree.
+ * Parameters:
+ *      proot Pointer to the root node.
+ *       bmax Input true to find the maximum node; Input false to find the minimum node.
+ * Return value:  Pointer to the node found. NULL indicates the tree is empty.
+ * Tip:           Call this function and treRBTNeighbor to walk through a red black tree
+ *                in order without recursion and stack.
+ * Usage:         P_RBTNODE pnode;
+ *                for (pnode = treRBTExtremum(*prbt, false); NULL != pnode; pnode = treRBTNeighbor(pnode, true))
+ *                    printf("%d ", *(int *)pnode->bstn.knot.pdata);
+ */
+P_RBTNODE treRBTExtremum(P_RBTNODE proot, bool bmax)
+{
+	if (NULL != proot)
+		while (NULL != prbtchild(proot)[bmax])
+			proot = prbtchild(proot)[bmax];
+	return proot;
+}
+
+/* Function name: treRBTNeighbor
+ * Description:   Find the in-order successor or predecessor of a node in a red black tree.
+ * Parameters:
+ *      pnode Pointer to a node in the tree.
+ *      bnext Input true to find the successor; Input false to find the predecessor.
+ * Return value:  Pointer to the neighbor node. NULL indicates pnode is the last or the first node.
+ * Caution:       Address of pnode Must Be Allocated first.
+ * Tip:           This function only climbs along parent pointers and modifies nothing,
+ *                so it is safe to call it from several readers at the same time.
+ */
+P_RBTNODE treRBTNeighbor(P_RBTNODE pnode, bool bnext)
+{
+	REGISTER P_RBTNODE pparent;
+	if (NULL != prbtchild(pnode)[bnext])
+		return treRBTExtremum(prbtchild(pnode)[bnext], ! bnext);
+	while (NULL != (pparent = prbtparent(pnode)) && pnode == prbtchild(pparent)[bnext])
+		pnode = pparent;
+	return pparent;
+}
+
+/* Function name: treRBTLowerBound
+ * Description:   Find the first node whose data is not less than pitem in a red black tree.
+ * Parameters:
+ *      proot Pointer to the root node.
+ *      pitem Pointer to an element to seek.
+ *     cbfcmp Pointer to a callback comparison function.
+ * Return value:  Pointer to the node found.
+ *                NULL indicates every node in the tree is less than pitem.
+ */
+P_RBTNODE treRBTLowerBound(P_RBTNODE proot, const void * pitem, CBF_COMPARE cbfcmp)
+{
+	REGISTER P_RBTNODE pfound = NULL;
+	while (NULL != proot)
+	{
+		if (cbfcmp(pitem, proot->bstn.knot.pdata) > 0)
+			proot = prbtchild(proot)[RIGHT];
+		else
+		{
+			pfound = proot;
+			proot = prbtchild(proot)[LEFT];
+		}
+	}
+	return pfound;
+}
+
+/* Function name: treBulkBuildRBT
+ * Description:   Build a red black tree from a sorted array in O(n).
+ * Parameters:
+ *      parrz Pointer to a sorted array.
+ *       size Size of each element in the array.
+ *      bslab Input true to allocate all nodes and their data in one single block.
+ *            Input false to allocate each node separately like function treInsertRBT does.
+ * Return value:  Pointer to the root node of the new red black tree.
+ *                If the array were empty or allocation failed, function would return NULL.
+ * Caution:       Elements in parrz must be sorted in ascending order.
+ *                If bslab is true, the returned root is the address of the whole block.
+ *                Such a tree can be searched, traversed and copied, but do not insert nodes into it or remove nodes from it,
+ *                and release it by function free instead of treFreeRBT.
+ * Tip:           Every 3-node of the underlying 2-3 tree becomes a black node with a red right child.
+ * Usage:         P_RBT prbt = treCreateRBT();
+ *                *prbt = treBulkBuildRBT(parrz, sizeof(int), false);
+ *                treDeleteRBT(prbt);
+ */
+P_RBTNODE treBulkBuildRBT(P_ARRAY_Z parrz, size_t size, bool bslab)
+{
+	_BST_BULK bk;
+	P_RBTNODE proot;
+	if (0 == strLevelArrayZ(parrz) || ! _treInitBulkBST(&bk, parrz, size, true, bslab))
+		return NULL;
+	proot = P2P_RBTNODE(_treBulkBuild23BST(&bk, 0, bk.num, _treBulkLevelBST(bk.num), NULL));
+	if (bk.bfail)
+		treFreeRBT(&proot);
+	return proot;
+}
+
 #undef prbtparent
 #undef prbtchild
 #undef _NODE_COLOR
 /* Undefine used macros for this section. */
 
-/* Functions for B+ trees. */
-#include "svqueue.h"
-#define PARENTPTR 0
-#define NEXTPTR   1
+/* This following section is for persistent AA-trees.
+ * Updating a persistent tree copies nodes on the way down instead of modifying them,
+ * so that snapshots taken earlier keep on seeing the old version.
+ * A node is modified in place only if nothing else refers to it.
+ */
 
-/* Additional information for BPTNODE of B-plus trees. */
-typedef struct _st_BPT_INFO {
-	ARRAY_Z   keyarr;  /* Array of keys and children pointers. */
-	P_BPTNODE headptr; /* The first child pointer of a node. */
-} _BPT_INFO, * _P_BPT_INFO;
+/* A macro describes children nodes pointers of a persistent tree node. */
+#define ppstchild(pnode) *(P_PSTNODE *)&(pnode)->bstn.knot.ppnode
 
-/* Keys and child pointer elements in array. */
-typedef struct _st_BPT_KEY_INFO {
-	PUCHAR    pkey;   /* Key pointer. */
-	P_BPTNODE pchild; /* Child pointer. */
-} _BPT_KEY_INFO, * _P_BPT_KEY_INFO;
+/* A macro to the level of a persistent AA-tree node. A NULL pointer is at level 0. */
+#define _PST_LEVEL(pnode) (NULL == (pnode) ? 0 : (pnode)->bstn.param)
 
-/* File-scope function declarations go here. */
-void             _treInitBPTInfo_O           (_P_BPT_INFO      pbi);
-void             _treFreeBPTInfo             (_P_BPT_INFO      pbi);
-_P_BPT_INFO      _treCreateBPTInfo           (void);
-void             _treDeleteBPTInfo_O         (_P_BPT_INFO      pbi);
-P_BPTNODE        _treGetParentBPTNode_O      (P_BPTNODE        pnode);
-P_BPTNODE        _treGetNextBPTNode_O        (P_BPTNODE        pnode);
-bool             _treIsLeafBPTNode_O         (P_BPTNODE        pnode);
-void             _treFreeBPTPuppet           (P_QUEUE_L        pquelx,  P_QUEUE_L    pquely);
-P_BPTNODE        _treLocateKeyChainHeaderBPT (P_BPT            pbpt);
-P_BPTNODE        _treLocateKeyInLeafBPT      (P_BPT            pbpt,    const void * pkey,   CBF_COMPARE  cbfcmp);
-_P_BPT_KEY_INFO  _treInsertKeyIntoArrayBPT   (_P_BPT_INFO      pbni,    const void * pkey,   P_BPTNODE    pchild,   CBF_COMPARE  cbfcmp);
-size_t           _treRemoveKeyFromArrayBPT   (_P_BPT_INFO      pbni,    const void * pkey,   CBF_COMPARE  cbfmch);
-bool             _treSplitArrayInLeafBPT     (P_BPTNODE        pnew,    P_BPTNODE    pold,   const size_t degree);
-bool             _treSplitArrayInNodeBPT     (_P_BPT_KEY_INFO  pbki,    P_BPTNODE    pnew,   P_BPTNODE    pold,     const size_t degree);
-bool             _treMakeKeyChainBPT         (P_QUEUE_L        pquel,   P_BPTNODE *  pprev,  PUCHAR *     ppkeys[], const size_t num);
-P_BPTNODE        _treGetSiblingNodeBPT       (P_BPTNODE        pnode,   bool         bright);
-void             _treRedistributeNodesBPT    (P_BPTNODE        pnode,   P_BPTNODE    psib,   bool         bright);
-void             _treMergeNodesBPT           (P_BPTNODE        pnode,   P_BPTNODE    psib,   P_BPTNODE    phead,    bool         bright);
-bool             _treBPTRemovePuppet         (P_BPT            pbpt,    P_BPTNODE    pnode,  const size_t hdeg,     const void * pkey,  CBF_COMPARE cbfcmp);
+/* File level function declarations. */
+P_PSTNODE _treCreatePSTNode        (const void * pitem,  size_t       size,   size_t       level);
+bool      _treOwnPSTNode           (P_PSTNODE *  ppnode, size_t       size);
+void      _treSkewPST              (P_PSTNODE *  ppnode, size_t       size,   bool *       pbok);
+void      _treSplitPST             (P_PSTNODE *  ppnode, size_t       size,   bool *       pbok);
+P_PSTNODE _treInsertPSTPuppet      (P_PSTNODE    pnode,  const void * pitem,  size_t       size,   CBF_COMPARE cbfcmp, bool *   pbok);
+P_PSTNODE _treRemovePSTPuppet      (P_PSTNODE    pnode,  const void * pitem,  size_t       size,   CBF_COMPARE cbfcmp, PUCHAR * ppdata, bool * pbok);
 
 /* Attention:     This Is An Internal Function. No Interface for Library Users.
- * Function name: _treInitBPTInfo_O
- * Description:   Initialize a _BPT_INFO structure.
- * Parameter:
- *       pbi Pointer to the _BPT_INFO structure you want to initialize.
- * Return value:  N/A.
- * Caution:       Address of pbi Must Be Allocated first.
- * Tip:           A macro version of this function named _treInitBPTInfo_M is available.
+ * Function name: _treCreatePSTNode
+ * Description:   Allocate a node for a persistent AA-tree.
+ * Parameters:
+ *      pitem Pointer to an element.
+ *       size Size of the element.
+ *      level Level of the new node.
+ * Return value:  Pointer to the new node whose reference counter is 1.
+ *                If function could not create a node, it would return NULL.
  */
-void _treInitBPTInfo_O(_P_BPT_INFO pbi)
+P_PSTNODE _treCreatePSTNode(const void * pitem, size_t size, size_t level)
 {
-	pbi->headptr = NULL;
-	pbi->keyarr.num = 0;
-	pbi->keyarr.pdata = NULL;
+	REGISTER P_PSTNODE pnew = P2P_PSTNODE(malloc(sizeof(PSTNODE)));
+	if (NULL != pnew)
+	{
+		if (NULL == treInitBSTNode(&pnew->bstn, pitem, size, level))
+		{
+			free(pnew);
+			return NULL;
+		}
+		pnew->refc = 1;
+	}
+	return pnew;
 }
 
 /* Attention:     This Is An Internal Function. No Interface for Library Users.
- * Function name: _treFreeBPTInfo
- * Description:   Retract a _BPT_INFO structure which is allocated by function _treInitBPTInfo_O.
- * Parameter:
- *       pbi Pointer to the _BPT_INFO structure you want to release.
- * Return value:  N/A.
- * Caution:       Address of pbi Must Be Allocated first.
+ * Function name: _treOwnPSTNode
+ * Description:   Make sure that a node is only referred by the slot that ppnode points to.
+ *                A shared node would be replaced by a copy of it.
+ * Parameters:
+ *     ppnode Pointer to a slot inside a node that has already been owned, or to a local variable.
+ *       size Size of the element in each node.
+ * Return value:  true:  *ppnode can be modified freely.
+ *                false: Allocation failure. *ppnode would not be changed.
  */
-void _treFreeBPTInfo(_P_BPT_INFO pbi)
+bool _treOwnPSTNode(P_PSTNODE * ppnode, size_t size)
 {
-	pbi->headptr = NULL;
-	strFreeArrayZ(&pbi->keyarr);
+	REGISTER P_PSTNODE pold = *ppnode, pnew;
+	if (1 == pold->refc)
+		return true;
+	if (NULL == (pnew = _treCreatePSTNode(pold->bstn.knot.pdata, size, pold->bstn.param)))
+		return false;
+	/* The copy shares children with the old node. */
+	if (NULL != (ppstchild(pnew)[LEFT] = ppstchild(pold)[LEFT]))
+		DISUSE(SV_ATOMIC_INC(&(ppstchild(pnew)[LEFT])->refc));
+	if (NULL != (ppstchild(pnew)[RIGHT] = ppstchild(pold)[RIGHT]))
+		DISUSE(SV_ATOMIC_INC(&(ppstchild(pnew)[RIGHT])->refc));
+	/* A reader may have released its snapshot since refc was checked. */
+	if (0 == SV_ATOMIC_DEC(&pold->refc))
+		treReleasePST(pold);
+	*ppnode = pnew;
+	return true;
 }
 
 /* Attention:     This Is An Internal Function. No Interface for Library Users.
- * Function name: _treCreateBPTInfo
- * Description:   Dynamically allocate a _BPT_INFO structure.
- * Parameter:     N/A.
+ * Function name: _treSkewPST
+ * Description:   Skew a node in a persistent AA-tree.
+ * Parameters:
+ *     ppnode Pointer to a slot inside a node that has already been owned.
+ *       size Size of the element in each node.
+ *       pbok Pointer to a flag that would be set to false once an allocation failed.
+ * Return value:  N/A.
+ */
+void _treSkewPST(P_PSTNODE * ppnode, size_t size, bool * pbok)
+{
+	REGISTER P_PSTNODE pnode = *ppnode, ptemp;
+	if (NULL != pnode && NULL != ppstchild(pnode)[LEFT] && _PST_LEVEL(ppstchild(pnode)[LEFT]) == _PST_LEVEL(pnode))
+	{
+		if (! _treOwnPSTNode(ppnode, size) || ! _treOwnPSTNode(&ppstchild(*ppnode)[LEFT], size))
+		{
+			*pbok = false;
+			return;
+		}
+		/* Rotate right. */
+		pnode = *ppnode;
+		ptemp = ppstchild(pnode)[LEFT];
+		ppstchild(pnode)[LEFT]  = ppstchild(ptemp)[RIGHT];
+		ppstchild(ptemp)[RIGHT] = pnode;
+		*ppnode = ptemp;
+	}
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treSplitPST
+ * Description:   Split a node in a persistent AA-tree.
+ * Parameters:
+ *     ppnode Pointer to a slot inside a node that has already been owned.
+ *       size Size of the element in each node.
+ *       pbok Pointer to a flag that would be set to false once an allocation failed.
+ * Return value:  N/A.
+ */
+void _treSplitPST(P_PSTNODE * ppnode, size_t size, bool * pbok)
+{
+	REGISTER P_PSTNODE pnode = *ppnode, ptemp;
+	if
+	(
+		NULL != pnode &&
+		NULL != ppstchild(pnode)[RIGHT] &&
+		NULL != ppstchild(ppstchild(pnode)[RIGHT])[RIGHT] &&
+		_PST_LEVEL(ppstchild(ppstchild(pnode)[RIGHT])[RIGHT]) == _PST_LEVEL(pnode)
+	)
+	{
+		if (! _treOwnPSTNode(ppnode, size) || ! _treOwnPSTNode(&ppstchild(*ppnode)[RIGHT], size))
+		{
+			*pbok = false;
+			return;
+		}
+		/* Rotate left. */
+		pnode = *ppnode;
+		ptemp = ppstchild(pnode)[RIGHT];
+		ppstchild(pnode)[RIGHT] = ppstchild(ptemp)[LEFT];
+		ppstchild(ptemp)[LEFT]  = pnode;
+		++ptemp->bstn.param;
+		*ppnode = ptemp;
+	}
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treInsertPSTPuppet
+ * Description:   Insert data into a persistent AA-tree recursively.
+ * Parameters:
+ *      pnode Pointer to a subtree. The reference to it is consumed.
+ *      pitem Pointer to an element that contains the data you want to insert.
+ *       size Size of the element.
+ *     cbfcmp Pointer to a callback comparison function.
+ *       pbok Pointer to a flag that would be set to false once an allocation failed.
+ * Return value:  Pointer to the new subtree.
+ */
+P_PSTNODE _treInsertPSTPuppet(P_PSTNODE pnode, const void * pitem, size_t size, CBF_COMPARE cbfcmp, bool * pbok)
+{
+	REGISTER int r;
+	if (NULL == pnode)
+	{
+		if (NULL == (pnode = _treCreatePSTNode(pitem, size, 1)))
+			*pbok = false;
+		return pnode;
+	}
+	if (CBF_CMP_EQUAL == (r = cbfcmp(pitem, pnode->bstn.knot.pdata)))
+		return pnode;
+	if (! _treOwnPSTNode(&pnode, size))
+	{
+		*pbok = false;
+		return pnode;
+	}
+	ppstchild(pnode)[r > 0] = _treInsertPSTPuppet(ppstchild(pnode)[r > 0], pitem, size, cbfcmp, pbok);
+	if (*pbok)
+	{	/* Nodes that need to be rotated are all on the copied path, so that skewing and splitting allocate nothing.
+		 * The new node is created after every node above it has been copied, so that nothing is linked if any allocation fails.
+		 */
+		_treSkewPST(&pnode, size, pbok);
+		_treSplitPST(&pnode, size, pbok);
+	}
+	return pnode;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treRemovePSTPuppet
+ * Description:   Remove data from a persistent AA-tree recursively.
+ * Parameters:
+ *      pnode Pointer to a subtree. The reference to it is consumed.
+ *      pitem Pointer to an element that contains the data you want to remove.
+ *            If pitem were NULL, function would remove the minimum node of the subtree.
+ *       size Size of the element.
+ *     cbfcmp Pointer to a callback comparison function.
+ *     ppdata If ppdata were not NULL, data of the removed node would be handed over to *ppdata instead of being freed.
+ *       pbok Pointer to a flag that would be set to false once an allocation failed.
+ * Return value:  Pointer to the new subtree.
+ */
+P_PSTNODE _treRemovePSTPuppet(P_PSTNODE pnode, const void * pitem, size_t size, CBF_COMPARE cbfcmp, PUCHAR * ppdata, bool * pbok)
+{
+	REGISTER int r;
+	REGISTER size_t level;
+	if (NULL == pnode)
+		return NULL;
+	if (NULL == pitem)
+		r = NULL == ppstchild(pnode)[LEFT] ? CBF_CMP_EQUAL : CBF_CMP_LT;
+	else
+		r = cbfcmp(pitem, pnode->bstn.knot.pdata);
+	if (! _treOwnPSTNode(&pnode, size))
+	{
+		*pbok = false;
+		return pnode;
+	}
+	if (CBF_CMP_EQUAL != r)
+		ppstchild(pnode)[r > 0] = _treRemovePSTPuppet(ppstchild(pnode)[r > 0], pitem, size, cbfcmp, ppdata, pbok);
+	else if (NULL == ppstchild(pnode)[LEFT])
+	{	/* Such a node is at level 1 and its right child, if any, is a leaf. */
+		REGISTER P_PSTNODE pright = ppstchild(pnode)[RIGHT];
+		if (NULL != ppdata)
+			*ppdata = pnode->bstn.knot.pdata;
+		else
+			free(pnode->bstn.knot.pdata);
+		free(pnode);
+		return pright;
+	}
+	else
+	{	/* Every node that has a left child has a right child in an AA-tree. Take the successor's data. */
+		PUCHAR pdata = NULL;
+		ppstchild(pnode)[RIGHT] = _treRemovePSTPuppet(ppstchild(pnode)[RIGHT], NULL, size, cbfcmp, &pdata, pbok);
+		if (NULL != pdata)
+		{
+			if (NULL != ppdata)
+				*ppdata = pnode->bstn.knot.pdata;
+			else
+				free(pnode->bstn.knot.pdata);
+			pnode->bstn.knot.pdata = pdata;
+		}
+	}
+	if (! *pbok)
+		return pnode;
+	/* Decrease level. */
+	level = _PST_LEVEL(ppstchild(pnode)[LEFT]) < _PST_LEVEL(ppstchild(pnode)[RIGHT]) ?
+		_PST_LEVEL(ppstchild(pnode)[LEFT]) + 1 : _PST_LEVEL(ppstchild(pnode)[RIGHT]) + 1;
+	if (level < pnode->bstn.param)
+	{
+		pnode->bstn.param = level;
+		if (level < _PST_LEVEL(ppstchild(pnode)[RIGHT]))
+		{
+			if (! _treOwnPSTNode(&ppstchild(pnode)[RIGHT], size))
+			{
+				*pbok = false;
+				return pnode;
+			}
+			(ppstchild(pnode)[RIGHT])->bstn.param = level;
+		}
+	}
+	/* Skew and split nodes alongside the right spine. */
+	_treSkewPST(&pnode, size, pbok);
+	_treSkewPST(&ppstchild(pnode)[RIGHT], size, pbok);
+	if (NULL != ppstchild(pnode)[RIGHT] && NULL != ppstchild(ppstchild(pnode)[RIGHT])[RIGHT])
+	{
+		REGISTER P_PSTNODE pnext = ppstchild(ppstchild(pnode)[RIGHT])[RIGHT];
+		if (NULL != ppstchild(pnext)[LEFT] && _PST_LEVEL(ppstchild(pnext)[LEFT]) == _PST_LEVEL(pnext))
+		{
+			if (_treOwnPSTNode(&ppstchild(pnode)[RIGHT], size))
+				_treSkewPST(&ppstchild(ppstchild(pnode)[RIGHT])[RIGHT], size, pbok);
+			else
+				*pbok = false;
+		}
+	}
+	_treSplitPST(&pnode, size, pbok);
+	_treSplitPST(&ppstchild(pnode)[RIGHT], size, pbok);
+	return pnode;
+}
+
+/* Function name: treSnapshotPST
+ * Description:   Take a snapshot of a persistent AA-tree.
+ * Parameter:
+ *       ppst Pointer to a persistent AA-tree.
+ * Return value:  Pointer to the root node of the snapshot.
+ * Caution:       Address of ppst Must Be Allocated first.
+ *                Each snapshot should be released by function treReleasePST.
+ *                Snapshots shall be taken by the writer or under the same lock as writes.
+ * Tip:           A snapshot costs O(1). It stays unchanged while writers keep on inserting into
+ *                or removing from *ppst. Cast it by P2P_BSTNODE to search it with treBSTFindData_N
+ *                or to walk through it with a BSTCURSOR.
+ */
+P_PSTNODE treSnapshotPST(P_PST ppst)
+{
+	if (NULL != *ppst)
+		DISUSE(SV_ATOMIC_INC(&(*ppst)->refc));
+	return *ppst;
+}
+
+/* Function name: treReleasePST
+ * Description:   Release a snapshot or a whole persistent AA-tree.
+ * Parameter:
+ *      proot Pointer to the root node of a snapshot or a tree.
+ * Return value:  N/A.
+ * Caution:       Reference counters are changed by SV_ATOMIC_INC and SV_ATOMIC_DEC.
+ *                Unless both macros are atomic, this function and all writes to the tree shall run under one lock.
+ *                Refer to the note of platform hooks in svdef.h.
+ *                If they are atomic, readers may release snapshots while one writer alters the tree.
+ * Tip:           Only nodes that no other version refers to are freed.
+ */
+void treReleasePST(P_PSTNODE proot)
+{
+	if (NULL != proot && 0 == SV_ATOMIC_DEC(&proot->refc))
+	{
+		treReleasePST(ppstchild(proot)[LEFT]);
+		treReleasePST(ppstchild(proot)[RIGHT]);
+		treFreeBSTNode(&proot->bstn);
+		free(proot);
+	}
+}
+
+/* Function name: treInsertPST
+ * Description:   Insert data into a persistent AA-tree.
+ * Parameters:
+ *       ppst Pointer to a persistent AA-tree.
+ *      pitem Pointer to an element that contains the data you want to insert.
+ *       size Size of the element.
+ *     cbfcmp Pointer to a callback comparison function.
+ * Return value:  true:  Succeeded. Data that already existed would not be inserted again.
+ *                false: Allocation failure. The tree holds the same data in the same shape as before,
+ *                       but nodes on the search path above the failure may have been replaced by their copies.
+ *                       Snapshots are not affected.
+ * Caution:       Address of ppst Must Be Allocated first.
+ * Tip:           Only O(log n) nodes on the search path would be copied if snapshots shared them.
+ * Usage:         PST pst = NULL;
+ *                P_PSTNODE psnap;
+ *                treInsertPST(&pst, &a, sizeof(a), cbfcmp);
+ *                psnap = treSnapshotPST(&pst); // Readers use psnap.
+ *                treInsertPST(&pst, &b, sizeof(b), cbfcmp); // psnap still contains a only.
+ *                treReleasePST(psnap);
+ *                treReleasePST(pst);
+ */
+bool treInsertPST(P_PST ppst, const void * pitem, size_t size, CBF_COMPARE cbfcmp)
+{
+	bool bok = true;
+	if (NULL == treBSTFindData_N(P2P_BSTNODE(*ppst), pitem, cbfcmp))
+		*ppst = _treInsertPSTPuppet(*ppst, pitem, size, cbfcmp, &bok);
+	return bok;
+}
+
+/* Function name: treRemovePST
+ * Description:   Remove data from a persistent AA-tree.
+ * Parameters:
+ *       ppst Pointer to a persistent AA-tree.
+ *      pitem Pointer to an element that contains the data you want to remove.
+ *       size Size of the element.
+ *     cbfcmp Pointer to a callback comparison function.
+ * Return value:  true:  Succeeded or pitem did not exist.
+ *                false: Allocation failure. The tree would still be a valid binary search tree,
+ *                       but it might be out of balance.
+ * Caution:       Address of ppst Must Be Allocated first.
+ */
+bool treRemovePST(P_PST ppst, const void * pitem, size_t size, CBF_COMPARE cbfcmp)
+{
+	bool bok = true;
+	if (NULL != treBSTFindData_N(P2P_BSTNODE(*ppst), pitem, cbfcmp))
+		*ppst = _treRemovePSTPuppet(*ppst, pitem, size, cbfcmp, NULL, &bok);
+	return bok;
+}
+
+#undef ppstchild
+#undef _PST_LEVEL
+/* Undefine used macros for this section. */
+
+/* Functions for B+ trees. */
+#include "svqueue.h"
+#define PARENTPTR 0
+#define NEXTPTR   1
+
+/* Additional information for BPTNODE of B-plus trees. */
+typedef struct _st_BPT_INFO {
+	ARRAY_Z   keyarr;  /* Array of keys and children pointers. */
+	P_BPTNODE headptr; /* The first child pointer of a node. */
+} _BPT_INFO, * _P_BPT_INFO;
+
+/* Keys and child pointer elements in array. */
+typedef struct _st_BPT_KEY_INFO {
+	PUCHAR    pkey;   /* Key pointer. */
+	P_BPTNODE pchild; /* Child pointer. */
+} _BPT_KEY_INFO, * _P_BPT_KEY_INFO;
+
+/* File-scope function declarations go here. */
+void             _treInitBPTInfo_O           (_P_BPT_INFO      pbi);
+void             _treFreeBPTInfo             (_P_BPT_INFO      pbi);
+_P_BPT_INFO      _treCreateBPTInfo           (void);
+void             _treDeleteBPTInfo_O         (_P_BPT_INFO      pbi);
+P_BPTNODE        _treGetParentBPTNode_O      (P_BPTNODE        pnode);
+P_BPTNODE        _treGetNextBPTNode_O        (P_BPTNODE        pnode);
+bool             _treIsLeafBPTNode_O         (P_BPTNODE        pnode);
+void             _treFreeBPTPuppet           (P_QUEUE_L        pquelx,  P_QUEUE_L    pquely);
+P_BPTNODE        _treLocateKeyChainHeaderBPT (P_BPT            pbpt);
+P_BPTNODE        _treLocateKeyInLeafBPT      (P_BPT            pbpt,    const void * pkey,   CBF_COMPARE  cbfcmp);
+P_BPTNODE        _treLocateLowerBoundLeafBPT (P_BPT            pbpt,    const void * pkey,   CBF_COMPARE  cbfcmp);
+_P_BPT_KEY_INFO  _treInsertKeyIntoArrayBPT   (_P_BPT_INFO      pbni,    const void * pkey,   P_BPTNODE    pchild,   CBF_COMPARE  cbfcmp);
+size_t           _treRemoveKeyFromArrayBPT   (_P_BPT_INFO      pbni,    const void * pkey,   CBF_COMPARE  cbfmch);
+bool             _treSplitArrayInLeafBPT     (P_BPTNODE        pnew,    P_BPTNODE    pold,   const size_t degree);
+bool             _treSplitArrayInNodeBPT     (_P_BPT_KEY_INFO  pbki,    P_BPTNODE    pnew,   P_BPTNODE    pold,     const size_t degree);
+bool             _treMakeKeyChainBPT         (P_QUEUE_L        pquel,   P_BPTNODE *  pprev,  PUCHAR *     ppkeys[], const size_t num);
+bool             _treSplitNodeInBulkBPT      (P_BPT            pbpt,    P_BPTNODE    pnode,  const size_t degree);
+P_BPTNODE        _treGetSiblingNodeBPT       (P_BPTNODE        pnode,   bool         bright);
+void             _treRedistributeNodesBPT    (P_BPTNODE        pnode,   P_BPTNODE    psib,   bool         bright);
+void             _treMergeNodesBPT           (P_BPTNODE        pnode,   P_BPTNODE    psib,   P_BPTNODE    phead,    bool         bright);
+bool             _treBPTRemovePuppet         (P_BPT            pbpt,    P_BPTNODE    pnode,  const size_t hdeg,     const void * pkey,  CBF_COMPARE cbfcmp);
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treInitBPTInfo_O
+ * Description:   Initialize a _BPT_INFO structure.
+ * Parameter:
+ *       pbi Pointer to the _BPT_INFO structure you want to initialize.
+ * Return value:  N/A.
+ * Caution:       Address of pbi Must Be Allocated first.
+ * Tip:           A macro version of this function named _treInitBPTInfo_M is available.
+ */
+void _treInitBPTInfo_O(_P_BPT_INFO pbi)
+{
+	pbi->headptr = NULL;
+	pbi->keyarr.num = 0;
+	pbi->keyarr.pdata = NULL;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treFreeBPTInfo
+ * Description:   Retract a _BPT_INFO structure which is allocated by function _treInitBPTInfo_O.
+ * Parameter:
+ *       pbi Pointer to the _BPT_INFO structure you want to release.
+ * Return value:  N/A.
+ * Caution:       Address of pbi Must Be Allocated first.
+ */
+void _treFreeBPTInfo(_P_BPT_INFO pbi)
+{
+	pbi->headptr = NULL;
+	strFreeArrayZ(&pbi->keyarr);
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treCreateBPTInfo
+ * Description:   Dynamically allocate a _BPT_INFO structure.
+ * Parameter:     N/A.
  * Return value:  Pointer to the new allocated structure.
  *                If function could not create a structure, it would return NULL.
  */
@@ -1565,6 +2459,114 @@ void * treSearchDataBPT(P_BPT pbpt, const void * pkey, CBF_COMPARE cbfcmp)
 	return NULL;
 }
 
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treLocateLowerBoundLeafBPT
+ * Description:   Locate the leaf node from which the first key that is not less than pkey can be found
+ *                by walking through key chain.
+ * Parameters:
+ *       pbpt Pointer to the B-plus tree.
+ *       pkey A pointer value which stores the index key.
+ *     cbfcmp Pointer to a callback function that compares the data in pkey and the data in the nodes of tree.
+ * Return value:  A pointer to a leaf node.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ * Tip:           Unlike function _treLocateKeyInLeafBPT, this function follows the last separator that is
+ *                strictly less than pkey, so duplicated keys that spread over several leaves would not be skipped.
+ */
+P_BPTNODE _treLocateLowerBoundLeafBPT(P_BPT pbpt, const void * pkey, CBF_COMPARE cbfcmp)
+{
+	REGISTER P_BPTNODE pnode = *pbpt;
+	while (NULL != pnode && (! _treIsLeafBPTNode(pnode)))
+	{
+		REGISTER size_t i;
+		_P_BPT_INFO pbni = (_P_BPT_INFO)pnode->pdata;
+		for (i = pbni->keyarr.num; i > 0; --i)
+			if (cbfcmp((i - 1)[(_P_BPT_KEY_INFO)pbni->keyarr.pdata].pkey, pkey) < 0)
+				break;
+		pnode = 0 == i ? pbni->headptr : (i - 1)[(_P_BPT_KEY_INFO)pbni->keyarr.pdata].pchild;
+	}
+	return pnode;
+}
+
+/* Function name: treBPTCursorSeek
+ * Description:   Place a cursor before the first key that is not less than pkey in a B-plus tree.
+ * Parameters:
+ *       pcur Pointer to a cursor.
+ *       pbpt Pointer to the B-plus tree.
+ *       pkey Pointer to the key to seek. Input NULL to seek the smallest key in the tree.
+ *     cbfcmp Pointer to a callback function that compares keys.
+ * Return value:  true:  There are keys to fetch.
+ *                false: Every key in the tree is less than pkey or the tree is empty.
+ * Caution:       Address of pcur and pbpt Must Be Allocated first.
+ *                Do not insert keys into or remove keys from the tree while a cursor is working on it.
+ * Tip:           Seeking costs one descent from root to leaf; fetching costs O(1) for each key.
+ * Usage:         BPTCURSOR cur;
+ *                PUCHAR keys[64];
+ *                size_t i, n;
+ *                treBPTCursorSeek(&cur, pbpt, &lo, cbfcmp);
+ *                while (0 != (n = treBPTCursorFetch(&cur, keys, 64, &hi, cbfcmp)))
+ *                    for (i = 0; i < n; ++i)
+ *                        printf("%d ", *(int *)keys[i]); // Keys in range [lo, hi].
+ */
+bool treBPTCursorSeek(P_BPTCURSOR pcur, P_BPT pbpt, const void * pkey, CBF_COMPARE cbfcmp)
+{
+	REGISTER size_t i = 0;
+	REGISTER _P_BPT_INFO pbni;
+	pcur->pnode = NULL == pkey ? _treLocateKeyChainHeaderBPT(pbpt) : _treLocateLowerBoundLeafBPT(pbpt, pkey, cbfcmp);
+	if (NULL != pcur->pnode && NULL != pkey)
+	{
+		pbni = (_P_BPT_INFO)pcur->pnode->pdata;
+		while (i < pbni->keyarr.num && cbfcmp(i[(_P_BPT_KEY_INFO)pbni->keyarr.pdata].pkey, pkey) < 0)
+			++i;
+	}
+	pcur->index = i;
+	/* Skip to the next leaf if all keys in this leaf are less than pkey. */
+	while (NULL != pcur->pnode && pcur->index >= ((_P_BPT_INFO)pcur->pnode->pdata)->keyarr.num)
+	{
+		pcur->pnode = _treGetNextBPTNode(pcur->pnode);
+		pcur->index = 0;
+	}
+	return NULL != pcur->pnode;
+}
+
+/* Function name: treBPTCursorFetch
+ * Description:   Fetch a batch of keys from a cursor in ascending order and move the cursor forward.
+ * Parameters:
+ *       pcur Pointer to a cursor.
+ *      pkeys Pointer to an array that receives key pointers.
+ *        num Capacity of the array that pkeys pointed.
+ *     pupper Pointer to the upper bound of keys. Fetching stops before the first key greater than *pupper.
+ *            Input NULL to fetch keys until the end of key chain.
+ *     cbfcmp Pointer to a callback function that compares keys. It can be NULL if pupper is NULL.
+ * Return value:  Number of key pointers stored into pkeys. 0 indicates the scan is over.
+ * Caution:       Address of pcur Must Be Allocated first.
+ *                Call function treBPTCursorSeek before fetching.
+ */
+size_t treBPTCursorFetch(P_BPTCURSOR pcur, PUCHAR pkeys[], size_t num, const void * pupper, CBF_COMPARE cbfcmp)
+{
+	REGISTER size_t j = 0;
+	while (j < num && NULL != pcur->pnode)
+	{
+		REGISTER _P_BPT_INFO pbni = (_P_BPT_INFO)pcur->pnode->pdata;
+		while (j < num && pcur->index < pbni->keyarr.num)
+		{
+			REGISTER PUCHAR pk = pcur->index[(_P_BPT_KEY_INFO)pbni->keyarr.pdata].pkey;
+			if (NULL != pupper && cbfcmp(pk, pupper) > 0)
+			{	/* Out of range. Stop scanning for good. */
+				pcur->pnode = NULL;
+				return j;
+			}
+			pkeys[j++] = pk;
+			++pcur->index;
+		}
+		if (pcur->index >= pbni->keyarr.num)
+		{
+			pcur->pnode = _treGetNextBPTNode(pcur->pnode);
+			pcur->index = 0;
+		}
+	}
+	return j;
+}
+
 /* Attention:     This Is An Internal Function. No Interface for Library Users.
  * Function name: _treInsertKeyIntoArrayBPT
  * Description:   Insert a key into array in a node.
@@ -1667,7 +2669,7 @@ bool _treSplitArrayInNodeBPT(_P_BPT_KEY_INFO pbki, P_BPTNODE pnew, P_BPTNODE pol
 {
 	_P_BPT_INFO pbni0 = (_P_BPT_INFO)pold->pdata;
 	_P_BPT_INFO pbni1 = (_P_BPT_INFO)pnew->pdata;
-	size_t j = degree >> 1;
+	size_t i, j = degree >> 1;
 	if (NULL == strResizeArrayZ(&pbni1->keyarr, pbni0->keyarr.num - j - 1, sizeof(_BPT_KEY_INFO)))
 		return false; /* Reallocation failure. */
 	/* Extract the middle key from pold. */
@@ -1675,6 +2677,10 @@ bool _treSplitArrayInNodeBPT(_P_BPT_KEY_INFO pbki, P_BPTNODE pnew, P_BPTNODE pol
 	pbki->pchild = (((_P_BPT_KEY_INFO)pbni0->keyarr.pdata) + j)->pchild;
 	/* Fill up new allocated array. */
 	memcpy(pbni1->keyarr.pdata, ((_P_BPT_KEY_INFO)pbni0->keyarr.pdata) + j + 1, sizeof(_BPT_KEY_INFO) * (pbni0->keyarr.num - j - 1));
+	/* Children that moved to pnew have a new parent. */
+	pbki->pchild->ppnode[PARENTPTR] = pnew;
+	for (i = 0; i < pbni1->keyarr.num; ++i)
+		(((_P_BPT_KEY_INFO)pbni1->keyarr.pdata) + i)->pchild->ppnode[PARENTPTR] = pnew;
 	/* Shrink array of the previous node. */
 	if (NULL == strResizeArrayZ(&pbni0->keyarr, j, sizeof(_BPT_KEY_INFO)))
 		return false; /* Reallocation failure. */
@@ -1728,7 +2734,8 @@ bool treInsertBPT(P_BPT pbpt, const size_t degree, const void * pkey, CBF_COMPAR
 						treDeleteBPTNode(pnew);
 						return false; /* Can not split array. */
 					}
-					/* Set next pointer of pnode. */
+					/* Link pnew into key chain right after pnode. */
+					pnew->ppnode[NEXTPTR]  = pnode->ppnode[NEXTPTR];
 					pnode->ppnode[NEXTPTR] = pnew;
 					/* Get key value form the new split node. */
 					parrz = &((_P_BPT_INFO)pnew->pdata)->keyarr;
@@ -1828,7 +2835,7 @@ bool _treMakeKeyChainBPT(P_QUEUE_L pquel, P_BPTNODE * pprev, PUCHAR * ppkeys[],
  *            Each key pointer in this array should be converted into (PUCHAR).
  *        num Length of the key pointer array.
  * Return value:  true  Loading succeeded.
- *                false Loading failed.
+ *                false Loading failed. The tree would be left empty.
  * Caution:       (*) The address of pbpt pointed must be allocated first and (*pbpt) shall equal to value NULL.
  *                (*) Users need to sort pointers in the array that pkeys pointed and let the first pointer points to the smallest value,
  *                and the last pointer in this array shall point to the biggest value.
@@ -1856,10 +2863,11 @@ bool treBulkLoadBPT(P_BPT pbpt, const size_t degree, PUCHAR pkeys[], size_t num)
 			if (_treMakeKeyChainBPT(&q1, &prev, &pkeys, degree - 1))
 				goto Lbl_Allocation_Failure;
 		/* Assemble the rest of keys. */
-		if (_treMakeKeyChainBPT(&q1, &prev, &pkeys, dr.rem))
+		if (dr.rem > 0 && _treMakeKeyChainBPT(&q1, &prev, &pkeys, dr.rem))
 			goto Lbl_Allocation_Failure;
 		/* All keys had been enqueued. No leaf node is left behind.
 		 * Assemble internal nodes and propagate upward to root.
+		 * A separator is the smallest key in its subtree, which is the first key of the leftmost leaf.
 		 */
 		while (! queIsEmptyL(pqa))
 		{
@@ -1897,7 +2905,7 @@ bool treBulkLoadBPT(P_BPT pbpt, const size_t degree, PUCHAR pkeys[], size_t num)
 				{	/* Insert nodes pointers into parent's array. */
 					queRemoveL(&pnode, sizeof(P_BPTNODE), pqa);
 					pki->pchild = pnode;
-					pki->pkey = ((_P_BPT_KEY_INFO) ((_P_BPT_INFO)pnode->pdata)->keyarr.pdata)->pkey;
+					pki->pkey = ((_P_BPT_KEY_INFO) ((_P_BPT_INFO)_treLocateKeyChainHeaderBPT(&pnode)->pdata)->keyarr.pdata)->pkey;
 					pnode->ppnode[PARENTPTR] = pnew;
 					++pki;
 				}
@@ -1906,7 +2914,7 @@ bool treBulkLoadBPT(P_BPT pbpt, const size_t degree, PUCHAR pkeys[], size_t num)
 			{	/* Insert nodes pointers into parent's array. */
 				queRemoveL(&pnode, sizeof(P_BPTNODE), pqa);
 				pki->pchild = pnode;
-				pki->pkey = ((_P_BPT_KEY_INFO) ((_P_BPT_INFO)pnode->pdata)->keyarr.pdata)->pkey;
+				pki->pkey = ((_P_BPT_KEY_INFO) ((_P_BPT_INFO)_treLocateKeyChainHeaderBPT(&pnode)->pdata)->keyarr.pdata)->pkey;
 				pnode->ppnode[PARENTPTR] = pnew;
 			}
 			/* Insert new created node into the second one. queue. */
@@ -1918,7 +2926,7 @@ bool treBulkLoadBPT(P_BPT pbpt, const size_t degree, PUCHAR pkeys[], size_t num)
 		queFreeL(&q2);
 		return true;
 Lbl_Allocation_Failure:
-		treDeleteBPT(pbpt);
+		/* Root has not been assigned yet, so the tree is still empty. */
 		/* Move contents of the second queue to the first queue. */
 		while (!queIsEmptyL(pqb))
 		{
@@ -1934,36 +2942,238 @@ Lbl_Allocation_Failure:
 }
 
 /* Attention:     This Is An Internal Function. No Interface for Library Users.
- * Function name: _treGetSiblingNodeBPT
- * Description:   Get the sibling of a node.
+ * Function name: _treSplitNodeInBulkBPT
+ * Description:   Split an overflowed node into as many nodes as it needs at once and
+ *                insert all new separators into its parent in one move. Repeat on ancestors that overflow.
+ *                This function is used to cooperate with function treBatchInsertBPT.
  * Parameters:
- *      pnode Pointer to a node in B-plus tree.
- *     bright true  Get the right sibling of pnode.
- *            false Get the left sibling of pnode.
- * Return value:  Pointer to the sibling of pnode.
- * Caution:       Address of pnode Must Be Allocated first.
+ *       pbpt Pointer to B-plus indexing tree.
+ *      pnode Pointer to the node that may hold degree or more keys.
+ *     degree Degree of nodes in B-plus indexing tree.
+ *            Value of degree shall be greater than or equal to 3.
+ * Return value:  true  Splitting succeeded.
+ *                false Allocation failure. The node that could not be split would be left overflowed.
+ *                      The tree is still searchable and later insertions would split it.
  */
-P_BPTNODE _treGetSiblingNodeBPT(P_BPTNODE pnode, bool bright)
+bool _treSplitNodeInBulkBPT(P_BPT pbpt, P_BPTNODE pnode, const size_t degree)
 {
-	REGISTER P_BPTNODE parent = _treGetParentBPTNode(pnode);
-	if (NULL != parent)
+	bool bleaf = _treIsLeafBPTNode(pnode);
+	while (NULL != pnode && ((_P_BPT_INFO)pnode->pdata)->keyarr.num >= degree)
 	{
-		P_ARRAY_Z parrz = &((_P_BPT_INFO)parent->pdata)->keyarr;
-		/* Retrieve entry in parent. */
-		if (((_P_BPT_INFO)parent->pdata)->headptr == pnode)
-		{	/* Entry pointer of pnode is the header pointer. */
-			if (! bright)
-				return NULL; /* Header pointer has no left sibling. */
-			/* Other wise, return the first pointer in the array. */
-			return ((_P_BPT_KEY_INFO)parrz->pdata)->pchild;
+		REGISTER size_t i, k;
+		size_t m = ((_P_BPT_INFO)pnode->pdata)->keyarr.num, p, q, r, c, t;
+		_P_BPT_KEY_INFO pe = (_P_BPT_KEY_INFO)((_P_BPT_INFO)pnode->pdata)->keyarr.pdata, pup;
+		P_BPTNODE * pnew, parent = _treGetParentBPTNode(pnode), prev = pnode;
+		_P_BPT_INFO pbnp;
+		/* A node holds degree - 1 keys at most. For an internal node, a key goes up between two pieces. */
+		if (bleaf)
+		{
+			p = (m + degree - 2) / (degree - 1);
+			q = m / p;
+			r = m % p;
 		}
 		else
-		{	/* Locate entry in the pointer array. */
-			REGISTER size_t i;
-			for (i = 0; i < strLevelArrayZ(parrz); ++i)
-			{
-				if (i[(_P_BPT_KEY_INFO)parrz->pdata].pchild == pnode)
-				{	/* Index of the pointer has been found in the parent node. */
+		{
+			p = (m + degree) / degree;
+			q = (m - p + 1) / p;
+			r = (m - p + 1) % p;
+		}
+		/* Allocate everything in advance, so that a failure leaves the tree intact. */
+		if (NULL == (pnew = (P_BPTNODE *) malloc((p - 1) * sizeof(P_BPTNODE))))
+			return false;
+		for (k = 1; k < p; ++k)
+		{
+			if
+			(
+				NULL == (pnew[k - 1] = treCreateBPTNode(parent, NULL)) ||
+				NULL == strInitArrayZ(&((_P_BPT_INFO)pnew[k - 1]->pdata)->keyarr, q + (k < r), sizeof(_BPT_KEY_INFO))
+			)
+			{
+				if (NULL != pnew[k - 1])
+					treDeleteBPTNode(pnew[k - 1]);
+				goto Lbl_Allocation_Failure;
+			}
+		}
+		if (NULL == parent)
+		{	/* Grow a new root. */
+			if (NULL == (parent = treCreateBPTNode(NULL, NULL)))
+				goto Lbl_Allocation_Failure;
+			((_P_BPT_INFO)parent->pdata)->headptr = pnode;
+		}
+		pbnp = (_P_BPT_INFO)parent->pdata;
+		/* Locate pnode in its parent. Separators are going to be inserted right after it. */
+		if (pbnp->headptr == pnode)
+			t = 0;
+		else
+		{
+			for (t = 0; t < pbnp->keyarr.num; ++t)
+				if (t[(_P_BPT_KEY_INFO)pbnp->keyarr.pdata].pchild == pnode)
+					break;
+			++t;
+		}
+		if (NULL == strResizeArrayZ(&pbnp->keyarr, pbnp->keyarr.num + p - 1, sizeof(_BPT_KEY_INFO)))
+		{
+			if (NULL == _treGetParentBPTNode(pnode))
+				treDeleteBPTNode(parent);
+			goto Lbl_Allocation_Failure;
+		}
+		pup = ((_P_BPT_KEY_INFO)pbnp->keyarr.pdata) + t;
+		memmove(pup + p - 1, pup, (pbnp->keyarr.num - t - p + 1) * sizeof(_BPT_KEY_INFO));
+		if (NULL == _treGetParentBPTNode(pnode))
+		{
+			pnode->ppnode[PARENTPTR] = parent;
+			*pbpt = parent;
+		}
+		/* Distribute keys. The first piece stays in pnode. */
+		c = q + (0 < r);
+		for (k = 1; k < p; ++k)
+		{
+			REGISTER P_BPTNODE pn = pnew[k - 1];
+			REGISTER _P_BPT_INFO pbn = (_P_BPT_INFO)pn->pdata;
+			pn->ppnode[PARENTPTR] = parent;
+			pup[k - 1].pkey   = pe[c].pkey;
+			pup[k - 1].pchild = pn;
+			if (bleaf)
+			{	/* Link the new leaf into key chain. */
+				pn->ppnode[NEXTPTR]   = prev->ppnode[NEXTPTR];
+				prev->ppnode[NEXTPTR] = pn;
+				prev = pn;
+			}
+			else
+			{	/* The key goes up and its child becomes the head child of the new node. */
+				pbn->headptr = pe[c].pchild;
+				pbn->headptr->ppnode[PARENTPTR] = pn;
+				++c;
+			}
+			memcpy(pbn->keyarr.pdata, pe + c, pbn->keyarr.num * sizeof(_BPT_KEY_INFO));
+			if (! bleaf)
+				for (i = 0; i < pbn->keyarr.num; ++i)
+					i[(_P_BPT_KEY_INFO)pbn->keyarr.pdata].pchild->ppnode[PARENTPTR] = pn;
+			c += pbn->keyarr.num;
+		}
+		free(pnew);
+		/* If shrinking failed, the array would keep its memory with fewer keys in use. */
+		strResizeArrayZ(&((_P_BPT_INFO)pnode->pdata)->keyarr, q + (0 < r), sizeof(_BPT_KEY_INFO));
+		((_P_BPT_INFO)pnode->pdata)->keyarr.num = q + (0 < r);
+		pnode = parent;
+		bleaf = false;
+		continue;
+Lbl_Allocation_Failure:
+		while (--k > 0)
+			treDeleteBPTNode(pnew[k - 1]);
+		free(pnew);
+		return false;
+	}
+	return true;
+}
+
+/* Function name: treBatchInsertBPT
+ * Description:   Insert a batch of sorted keys into a B-plus indexing tree.
+ * Parameters:
+ *       pbpt Pointer to B-plus indexing tree.
+ *     degree Degree of nodes in B-plus indexing tree.
+ *            Value of degree shall be greater than or equal to 3.
+ *      pkeys Pointer to an array that contains key pointers in sorted order.
+ *            Each key pointer in this array should be converted into (PUCHAR).
+ *            Keys will be stored in B-plus tree directly.
+ *        num Length of the key pointer array.
+ *     cbfcmp Pointer to a callback function that compares data size of keys.
+ * Return value:  true  Insertion succeeded.
+ *                false Insertion failed. Keys are handled leaf by leaf in ascending order.
+ *                      Keys that belong to leaves before the failed one are in the tree and the rest are not.
+ *                      If the failed leaf could not be enlarged, none of its keys are in the tree;
+ *                      if splitting it or one of its ancestors failed, all of its keys are in the tree and
+ *                      the node that could not be split is left overflowed, which is still searchable.
+ *                      If the tree was empty, it would be left empty.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ *                Users need to sort pointers in the array that pkeys pointed as function treBulkLoadBPT requires.
+ * Tip:           For each leaf, function descends from root once, merges every key that belongs to the leaf at once
+ *                and splits the leaf into as many leaves as it needs in one move.
+ *                An empty tree would be loaded by function treBulkLoadBPT.
+ */
+bool treBatchInsertBPT(P_BPT pbpt, const size_t degree, PUCHAR pkeys[], size_t num, CBF_COMPARE cbfcmp)
+{
+	REGISTER size_t i = 0, j;
+	if (0 == num)
+		return true;
+	if (NULL == *pbpt)
+		return treBulkLoadBPT(pbpt, degree, pkeys, num);
+	while (i < num)
+	{
+		REGISTER P_BPTNODE pnode = *pbpt;
+		REGISTER _P_BPT_INFO pbni;
+		REGISTER _P_BPT_KEY_INFO pe;
+		PUCHAR pupper = NULL;
+		size_t a, w, n;
+		/* Descend as function _treLocateKeyInLeafBPT does and remember the separator on the right side. */
+		while (! _treIsLeafBPTNode(pnode))
+		{
+			pbni = (_P_BPT_INFO)pnode->pdata;
+			for (j = pbni->keyarr.num; j > 0; --j)
+				if (cbfcmp((j - 1)[(_P_BPT_KEY_INFO)pbni->keyarr.pdata].pkey, pkeys[i]) <= 0)
+					break;
+			if (j < pbni->keyarr.num)
+				pupper = j[(_P_BPT_KEY_INFO)pbni->keyarr.pdata].pkey;
+			pnode = 0 == j ? pbni->headptr : (j - 1)[(_P_BPT_KEY_INFO)pbni->keyarr.pdata].pchild;
+		}
+		/* Keys less than the separator on the right side belong to this leaf. */
+		for (j = i + 1; j < num && (NULL == pupper || cbfcmp(pkeys[j], pupper) < 0); ++j)
+			;
+		n = j - i;
+		pbni = (_P_BPT_INFO)pnode->pdata;
+		a = pbni->keyarr.num;
+		if (NULL == strResizeArrayZ(&pbni->keyarr, a + n, sizeof(_BPT_KEY_INFO)))
+			return false;
+		/* Merge from the back. A new key goes after existing keys that equal it as function treInsertBPT does. */
+		pe = (_P_BPT_KEY_INFO)pbni->keyarr.pdata;
+		for (w = a + n; j > i; )
+		{
+			if (a > 0 && cbfcmp(pe[a - 1].pkey, pkeys[j - 1]) > 0)
+				pe[--w] = pe[--a];
+			else
+			{
+				pe[--w].pkey = pkeys[--j];
+				pe[w].pchild = NULL;
+			}
+		}
+		i += n;
+		if (! _treSplitNodeInBulkBPT(pbpt, pnode, degree))
+			return false;
+	}
+	return true;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treGetSiblingNodeBPT
+ * Description:   Get the sibling of a node.
+ * Parameters:
+ *      pnode Pointer to a node in B-plus tree.
+ *     bright true  Get the right sibling of pnode.
+ *            false Get the left sibling of pnode.
+ * Return value:  Pointer to the sibling of pnode.
+ * Caution:       Address of pnode Must Be Allocated first.
+ */
+P_BPTNODE _treGetSiblingNodeBPT(P_BPTNODE pnode, bool bright)
+{
+	REGISTER P_BPTNODE parent = _treGetParentBPTNode(pnode);
+	if (NULL != parent)
+	{
+		P_ARRAY_Z parrz = &((_P_BPT_INFO)parent->pdata)->keyarr;
+		/* Retrieve entry in parent. */
+		if (((_P_BPT_INFO)parent->pdata)->headptr == pnode)
+		{	/* Entry pointer of pnode is the header pointer. */
+			if (! bright)
+				return NULL; /* Header pointer has no left sibling. */
+			/* Other wise, return the first pointer in the array. */
+			return ((_P_BPT_KEY_INFO)parrz->pdata)->pchild;
+		}
+		else
+		{	/* Locate entry in the pointer array. */
+			REGISTER size_t i;
+			for (i = 0; i < strLevelArrayZ(parrz); ++i)
+			{
+				if (i[(_P_BPT_KEY_INFO)parrz->pdata].pchild == pnode)
+				{	/* Index of the pointer has been found in the parent node. */
 					if (! bright)
 					{
 						if (0 == i) /* The first element in the array. */
@@ -2229,316 +3439,4552 @@ bool treRemoveBPT(P_BPT pbpt, const size_t degree, const void * pkey, CBF_COMPAR
 #undef PARENTPTR
 #undef NEXTPTR /* Undefine two macros here, because B-plus tree section ends at this place. */
 
-/* Functions that implemented tries are listed here. */
-#include "svstack.h"
+/* This following section is for B-plus trees that store fixed-size keys inline.
+ * Keys of a node lie in a contiguous array right after the node header and
+ * child pointers of an internal node lie in another array after keys,
+ * so that searching in a node touches no memory other than the node itself.
+ */
 
-/* A macro used to calculate the length of an element in a trie's array. */
-#define _ELESIZ(size) (ALIGN_SIZET(size) + sizeof(TRIE_A) + sizeof(size_t) + sizeof(size_t) + sizeof(size_t))
-/**                                ^              ^                ^                ^                ^
- * An element consists of: --------data--------next_trie---reference_counter--------appendix---------flag.
- * We make the flag sign as size_t to further align structure to a suitable size.
+/* Maximum height of a B-plus tree with inline keys. Each level at least doubles the number of keys. */
+#define _BPTF_MAX_HEIGHT (CHAR_BIT * sizeof(size_t))
+
+/* Macros that locate keys and children in a node. A node holds degree + 1 keys and degree + 2 children temporarily. */
+#define _BPTF_KEYS(pnode) ((PUCHAR)(pnode) + ALIGN_SIZET(sizeof(BPTNODE_F)))
+#define _BPTF_KEY(pbpt, pnode, i) (_BPTF_KEYS(pnode) + (i) * (pbpt)->size)
+#define _BPTF_CHILDREN(pbpt, pnode) ((P_BPTNODE_F *)(_BPTF_KEYS(pnode) + ALIGN_SIZET(((pbpt)->degree + 1) * (pbpt)->size)))
+
+/* Macros for readers that run alongside a writer. A writer makes the version of a node odd before it alters the node
+ * and makes it even again afterwards. A reader that finds a version odd or changed would start over from the root.
  */
+#ifdef SV_MEMORY_FENCE
+#define _BPTF_FENCE() SV_MEMORY_FENCE()
+#else /* Without a barrier no reader can run alongside a writer. Refer to the note of platform hooks in svdef.h. */
+#define _BPTF_FENCE() DISUSE(0)
+#endif
+#define _BPTF_VERSION(pnode) (*(volatile size_t *)&(pnode)->ver)
+#define _BPTF_LOCK(pnode)    do { ++_BPTF_VERSION(pnode); _BPTF_FENCE(); } while (0)
+#define _BPTF_UNLOCK(pnode)  do { _BPTF_FENCE(); ++_BPTF_VERSION(pnode); } while (0)
+#define _BPTF_ROOT(pbpt)     (*(P_BPTNODE_F volatile *)&(pbpt)->proot)
 
 /* File level function declarations. */
-void _treFreeTrieNode(P_TRIE_A ptrie, size_t size);
+size_t      _treSearchKeysBPTF    (P_BPT_F     pbpt,  P_BPTNODE_F pnode,  const void * pkey,    CBF_COMPARE  cbfcmp, bool bupper);
+P_BPTNODE_F _treCreateNodeBPTF    (P_BPT_F     pbpt,  bool        bleaf);
+void        _treFreeNodesBPTF     (P_BPT_F     pbpt,  P_BPTNODE_F pnode);
+void        _treFixUnderflowBPTF  (P_BPT_F     pbpt,  P_BPTNODE_F path[], size_t       pos[],   size_t       depth);
+void        _treRetireNodeBPTF    (P_BPT_F     pbpt,  P_BPTNODE_F pnode);
 
-/* Function name: treInitTrieA_O
- * Description:   Initialize an array implemented trie.
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treSearchKeysBPTF
+ * Description:   Search keys in a node without branches in the loop.
  * Parameters:
- *      ptrie Pointer to a trie you want to initialize.
- * Return value:  N/A.
- * Caution:       Address of ptrie Must Be Allocated first.
- * Tip:           A macro version of this function named treInitTrieA_M is available.
+ *       pbpt Pointer to a B-plus tree.
+ *      pnode Pointer to a node.
+ *       pkey Pointer to the key to search.
+ *     cbfcmp Pointer to a callback comparison function.
+ *     bupper Input true to count keys that are less than or equal to pkey;
+ *            Input false to count keys that are less than pkey.
+ * Return value:  Number of keys counted, that is the index of the first key greater than(bupper)
+ *                or not less than(! bupper) pkey.
+ * Tip:           Each turn of the loop halves the range by a multiplication instead of a conditional jump,
+ *                so that compilers could emit conditional moves and CPUs would not mispredict.
  */
-void treInitTrieA_O(P_TRIE_A ptrie)
+size_t _treSearchKeysBPTF(P_BPT_F pbpt, P_BPTNODE_F pnode, const void * pkey, CBF_COMPARE cbfcmp, bool bupper)
 {
-	*ptrie = NULL;
+	REGISTER PUCHAR pkeys = _BPTF_KEYS(pnode);
+	REGISTER size_t base = 0, n = pnode->num, half;
+	REGISTER int bias = bupper ? CBF_CMP_LT : CBF_CMP_EQUAL;
+	if (0 == n)
+		return 0;
+	while (n > 1)
+	{
+		half = n >> 1;
+		base += (size_t)(cbfcmp(pkey, pkeys + (base + half) * pbpt->size) > bias) * half;
+		n -= half;
+	}
+	return base + (size_t)(cbfcmp(pkey, pkeys + base * pbpt->size) > bias);
 }
 
 /* Attention:     This Is An Internal Function. No Interface for Library Users.
- * Function name: _treFreeTrieNode
- * Description:   This function is used to free array implemented nodes in a trie.
+ * Function name: _treCreateNodeBPTF
+ * Description:   Allocate a node with keys and children in one block.
  * Parameters:
- *      ptrie Pointer to a trie you want to release.
- *       size Size of an element in the string which had been inserted into trie before.
+ *       pbpt Pointer to a B-plus tree.
+ *      bleaf Input true to create a leaf node.
+ * Return value:  Pointer to the new node. NULL indicates an allocation failure.
+ */
+P_BPTNODE_F _treCreateNodeBPTF(P_BPT_F pbpt, bool bleaf)
+{
+	REGISTER P_BPTNODE_F pnode;
+	REGISTER size_t bytes = ALIGN_SIZET(sizeof(BPTNODE_F)) + ALIGN_SIZET((pbpt->degree + 1) * pbpt->size);
+	if (! bleaf) /* Leaves do not need child pointers. */
+		bytes += (pbpt->degree + 2) * sizeof(P_BPTNODE_F);
+	if (NULL != (pnode = (P_BPTNODE_F) malloc(bytes)))
+	{
+		pnode->num   = 0;
+		pnode->ver   = 0;
+		pnode->pnext = NULL;
+		pnode->bleaf = bleaf;
+	}
+	return pnode;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treFreeNodesBPTF
+ * Description:   Free a node and all its descendants.
+ * Parameters:
+ *       pbpt Pointer to a B-plus tree.
+ *      pnode Pointer to a node.
  * Return value:  N/A.
- * Caution:       Address of ptrie Must Be Allocated first.
- *                Size shall not equal to 0.
  */
-void _treFreeTrieNode(P_TRIE_A ptrie, size_t size)
+void _treFreeNodesBPTF(P_BPT_F pbpt, P_BPTNODE_F pnode)
 {
-	if (NULL != *ptrie)
+	if (! pnode->bleaf)
 	{
 		REGISTER size_t i;
-		REGISTER PUCHAR pdat = (*ptrie)->pdata;
-		for (i = 0; i < strLevelArrayZ(*ptrie); ++i, pdat += _ELESIZ(size))
-		{
-			P_TRIE_A pt = (P_TRIE_A) (pdat + size);
-			if (NULL != *pt)
-				_treFreeTrieNode(pt, size);
-		}
-		strDeleteArrayZ(*ptrie);
+		for (i = 0; i <= pnode->num; ++i)
+			_treFreeNodesBPTF(pbpt, _BPTF_CHILDREN(pbpt, pnode)[i]);
 	}
+	free(pnode);
 }
 
-/* Function name: treFreeTrieA_O
- * Description:   Retract a trie which is allocated by function treInitTrieA_O.
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treRetireNodeBPTF
+ * Description:   Free a node that has left the tree, or keep it in retired list if readers might still hold it.
  * Parameters:
- *      ptrie Pointer to a trie you want to release.
- *       size Size of an element in the string which had been inserted into trie before.
+ *       pbpt Pointer to a B-plus tree.
+ *      pnode Pointer to a node.
  * Return value:  N/A.
- * Caution:       Address of ptrie Must Be Allocated first.
- *                Size shall not equal to 0.
- * Tip:           A macro version of this function named treFreeTrieA_M is available.
  */
-void treFreeTrieA_O(P_TRIE_A ptrie, size_t size)
+void _treRetireNodeBPTF(P_BPT_F pbpt, P_BPTNODE_F pnode)
 {
-	_treFreeTrieNode(ptrie, size);
-	*ptrie = NULL;
+	if (pbpt->bshared)
+	{
+		pnode->pnext = pbpt->pretired;
+		pbpt->pretired = pnode;
+	}
+	else
+		free(pnode);
 }
 
-/* Function name: treCreateTrieA
- * Description:   Allocate a new array implemented trie dynamically.
- * Parameters:    N/A.
- * Return value:  Pointer to the new allocated trie.
+/* Function name: treInitBPTF
+ * Description:   Initialize a B-plus tree that stores fixed-size keys inline.
+ * Parameters:
+ *       pbpt Pointer to the B-plus tree you want to initialize.
+ *       size Size of each key. It shall not be 0.
+ *     degree Maximum number of keys in a node. It would be raised to 4 if it were less than 4.
+ *            Input 0 to let function choose a degree that keys of a node fill BPTF_NODE_LINES cache lines.
+ * Return value:  true:  Succeeded.
+ *                false: size was 0. The tree is left empty and shall not be used.
+ * Caution:       Address of pbpt Must Be Allocated first.
  */
-P_TRIE_A treCreateTrieA(void)
+bool treInitBPTF(P_BPT_F pbpt, size_t size, size_t degree)
 {
-	REGISTER P_TRIE_A ptrie = (P_TRIE_A) malloc(sizeof(TRIE_A));
-	if (NULL != ptrie)
-		treInitTrieA(ptrie);
-	return ptrie;
+	pbpt->proot    = NULL;
+	pbpt->pretired = NULL;
+	pbpt->bshared  = false;
+	pbpt->size     = size;
+	if (0 == size)
+	{
+		pbpt->degree = 0;
+		return false;
+	}
+	if (0 == degree)
+		degree = BPTF_NODE_LINES * SV_CACHE_LINE / size;
+	pbpt->degree   = degree < 4 ? 4 : degree;
+	return true;
 }
 
-/* Function name: treDeleteTrieA_O
- * Description:   Delete a trie which is allocated by function treCreateTrieA.
+/* Function name: treFreeBPTF
+ * Description:   Retract a B-plus tree which is allocated by function treInitBPTF.
+ * Parameter:
+ *      pbpt Pointer to the B-plus tree you want to release.
+ * Return value:  N/A.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ */
+void treFreeBPTF(P_BPT_F pbpt)
+{
+	if (NULL != pbpt->proot)
+		_treFreeNodesBPTF(pbpt, pbpt->proot);
+	pbpt->proot = NULL;
+	treReclaimBPTF(pbpt);
+}
+
+/* Function name: treCreateBPTF
+ * Description:   Dynamically allocate a B-plus tree that stores fixed-size keys inline.
  * Parameters:
- *      ptrie Pointer to a trie you want to allocate.
- *       size Size of an element in the string which had been inserted into trie before.
+ *       size Size of each key.
+ *     degree Maximum number of keys in a node. Input 0 to let function choose it.
+ * Return value:  Pointer to the new allocated tree.
+ *                If function could not create a structure or size was 0, it would return NULL.
+ */
+P_BPT_F treCreateBPTF(size_t size, size_t degree)
+{
+	REGISTER P_BPT_F pbpt = (P_BPT_F) malloc(sizeof(BPT_F));
+	if (NULL != pbpt && ! treInitBPTF(pbpt, size, degree))
+	{
+		free(pbpt);
+		pbpt = NULL;
+	}
+	return pbpt;
+}
+
+/* Function name: treDeleteBPTF
+ * Description:   Retract a B-plus tree which is allocated by function treCreateBPTF.
+ * Parameter:
+ *      pbpt Pointer to the tree you want to release.
  * Return value:  N/A.
- * Caution:       Address of ptrie Must Be Allocated first.
- *                Size shall not equal to 0.
- * Tip:           A macro version of this function named treDeleteTrieA_M is available.
+ * Caution:       Address of pbpt Must Be Allocated first.
  */
-void treDeleteTrieA_O(P_TRIE_A ptrie, size_t size)
+void treDeleteBPTF(P_BPT_F pbpt)
 {
-	_treFreeTrieNode(ptrie, size);
-	free(ptrie);
+	treFreeBPTF(pbpt);
+	free(pbpt);
 }
 
-/* Function name: treSearchTrieA
- * Description:   Search a string in a trie.
+/* Function name: treTraverseKeyBPTF
+ * Description:   Traverse each key in key chain in ascending order.
  * Parameters:
- *      ptrie Pointer to a trie of which you want to operate on.
- *       pstr Pointer to the first element to a string and cast it into (const void *).
- *        num Number of elements in the string.
- *       size Size of each element in the string.
+ *       pbpt Pointer to the B-plus tree.
+ *     cbftvs Pointer to a callback function to traverse.
+ *            Parameter pitem of callback function points to a key inside the tree.
+ *      param A size_t value which can be transferred into callback function.
+ * Return value:  The same value as callback function returns.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ */
+int treTraverseKeyBPTF(P_BPT_F pbpt, CBF_TRAVERSE cbftvs, size_t param)
+{
+	REGISTER P_BPTNODE_F pnode = pbpt->proot;
+	REGISTER size_t i;
+	if (NULL == pnode)
+		return CBF_CONTINUE;
+	while (! pnode->bleaf)
+		pnode = _BPTF_CHILDREN(pbpt, pnode)[0];
+	for (; NULL != pnode; pnode = pnode->pnext)
+		for (i = 0; i < pnode->num; ++i)
+			if (CBF_CONTINUE != cbftvs(_BPTF_KEY(pbpt, pnode, i), param))
+				return CBF_TERMINATE;
+	return CBF_CONTINUE;
+}
+
+/* Function name: treSearchBPTF
+ * Description:   Search a key in a B-plus tree.
+ * Parameters:
+ *       pbpt Pointer to the B-plus tree.
+ *       pkey Pointer to the key to search.
  *     cbfcmp Pointer to a callback comparison function.
- *            Two parameters of this callback function may point to any element in the string and in the trie.
- *            Please refer to the prototype of callback function CBF_COMPARE in file svdef.h.
- * Return value:  Pointer to the value that contains vapdx stored in a trie.
- *                If this function returned value NULL, it should indicate that the string pstr pointed cannot be found in trie.
- * Caution:       ptrie must be allocated first.
- * Tip:           The following codes may give you an example for the usage of tries:
- *                const char ptip[] = "lynx"; size_t apdx = (size_t)ptip; P_TRIE_A pt = treCreateTrieA();
- *                treInsertTrieA(pt, "cat", strlen("cat"), sizeof(char), apdx, cbfcmp);
- *                apdx = *treSearchTrieA(pt, "cat", strlen("cat"), sizeof(char), cbfcmp);
- *                printf("%s\n", (const char *)apdx); treDeleteTrieA(pt, sizeof(char));
+ * Return value:  Pointer to the key stored in the tree.
+ *                NULL Cannot find pkey.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ *                Do not alter the part of the returned key that cbfcmp compares.
  */
-size_t * treSearchTrieA(P_TRIE_A ptrie, const void * pstr, size_t num, size_t size, CBF_COMPARE cbfcmp)
+void * treSearchBPTF(P_BPT_F pbpt, const void * pkey, CBF_COMPARE cbfcmp)
 {
-	if (SV_ASSERT(0 != num && 0 != size))
+	REGISTER P_BPTNODE_F pnode = pbpt->proot;
+	REGISTER size_t i;
+	if (NULL == pnode)
+		return NULL;
+	while (! pnode->bleaf)
+		pnode = _BPTF_CHILDREN(pbpt, pnode)[_treSearchKeysBPTF(pbpt, pnode, pkey, cbfcmp, true)];
+	i = _treSearchKeysBPTF(pbpt, pnode, pkey, cbfcmp, false);
+	if (i < pnode->num && CBF_CMP_EQUAL == cbfcmp(pkey, _BPTF_KEY(pbpt, pnode, i)))
+		return _BPTF_KEY(pbpt, pnode, i);
+	return NULL;
+}
+
+/* Function name: treBPTFCursorSeek
+ * Description:   Place a cursor before the first key that is not less than pkey in a B-plus tree with inline keys.
+ * Parameters:
+ *       pcur Pointer to a cursor.
+ *       pbpt Pointer to the B-plus tree.
+ *       pkey Pointer to the key to seek. Input NULL to seek the smallest key in the tree.
+ *     cbfcmp Pointer to a callback comparison function.
+ * Return value:  true:  There are keys to fetch.
+ *                false: Every key in the tree is less than pkey or the tree is empty.
+ * Caution:       Address of pcur and pbpt Must Be Allocated first.
+ *                Do not insert keys into or remove keys from the tree while a cursor is working on it.
+ */
+bool treBPTFCursorSeek(P_BPTCURSOR_F pcur, P_BPT_F pbpt, const void * pkey, CBF_COMPARE cbfcmp)
+{
+	REGISTER P_BPTNODE_F pnode = pbpt->proot;
+	pcur->pbpt  = pbpt;
+	pcur->index = 0;
+	if (NULL != pnode)
 	{
-		REGISTER PUCHAR pbase = (PUCHAR) pstr;
-		while (NULL != *ptrie && 0 != num)
+		while (! pnode->bleaf)
+			pnode = _BPTF_CHILDREN(pbpt, pnode)[NULL == pkey ? 0 : _treSearchKeysBPTF(pbpt, pnode, pkey, cbfcmp, true)];
+		if (NULL != pkey)
+			pcur->index = _treSearchKeysBPTF(pbpt, pnode, pkey, cbfcmp, false);
+		/* Skip to the next leaf if all keys in this leaf are less than pkey. */
+		while (NULL != pnode && pcur->index >= pnode->num)
 		{
-			REGISTER PUCHAR pdat;
-			if (NULL == (pdat = (PUCHAR) strBinarySearchArrayZ(*ptrie, pbase, _ELESIZ(size), cbfcmp)))
-				return NULL;
-			ptrie = (P_TRIE_A) &pdat[size];
-			--num;
-			pbase += size;
+			pnode = pnode->pnext;
+			pcur->index = 0;
 		}
-		if (0 == num) /* Searching reaches at the end of string. */
-			if (BOOLIZE(*((size_t *) &(sizeof(TRIE_A) + sizeof(size_t) + sizeof(size_t))[(PUCHAR) ptrie])))
-				return ((size_t *) &(sizeof(TRIE_A) + sizeof(size_t))[(PUCHAR) ptrie]);
 	}
-	return NULL;
+	return NULL != (pcur->pnode = pnode);
 }
 
-/* Function name: treInsertTrieA
- * Description:   Insert a string into a trie.
+/* Function name: treBPTFCursorFetch
+ * Description:   Fetch a batch of keys from a cursor in ascending order and move the cursor forward.
  * Parameters:
- *      ptrie Pointer to a trie of which you want to operate on.
+ *       pcur Pointer to a cursor.
+ *      pkeys Pointer to an array that receives pointers to keys inside the tree.
+ *        num Capacity of the array that pkeys pointed.
+ *     pupper Pointer to the upper bound of keys. Fetching stops before the first key greater than *pupper.
+ *            Input NULL to fetch keys until the end of key chain.
+ *     cbfcmp Pointer to a callback comparison function. It can be NULL if pupper is NULL.
+ * Return value:  Number of key pointers stored into pkeys. 0 indicates the scan is over.
+ * Caution:       Address of pcur Must Be Allocated first.
+ *                Call function treBPTFCursorSeek before fetching.
+ */
+size_t treBPTFCursorFetch(P_BPTCURSOR_F pcur, PUCHAR pkeys[], size_t num, const void * pupper, CBF_COMPARE cbfcmp)
+{
+	REGISTER size_t j = 0;
+	while (j < num && NULL != pcur->pnode)
+	{
+		while (j < num && pcur->index < pcur->pnode->num)
+		{
+			REGISTER PUCHAR pk = _BPTF_KEY(pcur->pbpt, pcur->pnode, pcur->index);
+			if (NULL != pupper && cbfcmp(pk, pupper) > 0)
+			{	/* Out of range. Stop scanning for good. */
+				pcur->pnode = NULL;
+				return j;
+			}
+			pkeys[j++] = pk;
+			++pcur->index;
+		}
+		if (pcur->index >= pcur->pnode->num)
+		{
+			pcur->pnode = pcur->pnode->pnext;
+			pcur->index = 0;
+		}
+	}
+	return j;
+}
+
+/* Function name: treInsertBPTF
+ * Description:   Insert a key into a B-plus tree.
+ * Parameters:
+ *       pbpt Pointer to the B-plus tree.
+ *       pkey Pointer to the key to insert. Key would be copied into the tree.
+ *     cbfcmp Pointer to a callback comparison function.
+ * Return value:  true:  Succeeded. A key that already existed would not be inserted again.
+ *                false: Allocation failure. The tree would not be altered.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ * Usage:         BPT_F bpt;
+ *                treInitBPTF(&bpt, sizeof(int), 0);
+ *                treInsertBPTF(&bpt, &a, cbfcmp);
+ *                if (NULL != treSearchBPTF(&bpt, &a, cbfcmp)) ...
+ *                treFreeBPTF(&bpt);
+ */
+bool treInsertBPTF(P_BPT_F pbpt, const void * pkey, CBF_COMPARE cbfcmp)
+{
+	P_BPTNODE_F path[_BPTF_MAX_HEIGHT], pnew[_BPTF_MAX_HEIGHT + 1];
+	size_t pos[_BPTF_MAX_HEIGHT];
+	REGISTER P_BPTNODE_F pnode = pbpt->proot;
+	REGISTER size_t i, j, depth = 0, splits = 0, top, bottom;
+	const size_t size = pbpt->size;
+	if (NULL == pnode)
+	{
+		if (NULL == (pnode = _treCreateNodeBPTF(pbpt, true)))
+			return false;
+		memcpy(_BPTF_KEYS(pnode), pkey, size);
+		pnode->num = 1;
+		_BPTF_FENCE();
+		_BPTF_ROOT(pbpt) = pnode;
+		return true;
+	}
+	/* Descend and record the path. */
+	while (! pnode->bleaf)
+	{
+		path[depth] = pnode;
+		pos[depth] = _treSearchKeysBPTF(pbpt, pnode, pkey, cbfcmp, true);
+		pnode = _BPTF_CHILDREN(pbpt, pnode)[pos[depth++]];
+	}
+	path[depth] = pnode;
+	i = _treSearchKeysBPTF(pbpt, pnode, pkey, cbfcmp, false);
+	if (i < pnode->num && CBF_CMP_EQUAL == cbfcmp(pkey, _BPTF_KEY(pbpt, pnode, i)))
+		return true;
+	/* Allocate every node that splitting needs in advance, so that a failure leaves the tree intact. */
+	for (j = depth + 1; j > 0 && path[j - 1]->num >= pbpt->degree; --j)
+	{
+		if (NULL == (pnew[splits++] = _treCreateNodeBPTF(pbpt, path[j - 1]->bleaf)))
+			goto Lbl_Allocation_Failure;
+	}
+	if (0 == j && NULL == (pnew[splits++] = _treCreateNodeBPTF(pbpt, false)))
+		goto Lbl_Allocation_Failure;
+	/* Nodes from path[top] down to the leaf are going to be altered. */
+	top = j > 0 ? j - 1 : 0;
+	bottom = depth;
+	for (j = top; j <= bottom; ++j)
+		_BPTF_LOCK(path[j]);
+	/* Insert the key into the leaf. */
+	memmove(_BPTF_KEY(pbpt, pnode, i + 1), _BPTF_KEY(pbpt, pnode, i), (pnode->num - i) * size);
+	memcpy(_BPTF_KEY(pbpt, pnode, i), pkey, size);
+	++pnode->num;
+	if (pnode->num <= pbpt->degree)
+		goto Lbl_Unlock;
+	{
+		REGISTER P_BPTNODE_F pright;
+		PUCHAR psep;
+		j = 0;
+		/* Split the leaf. The first key of the right half goes up. */
+		pright = pnew[j++];
+		i = pnode->num >> 1;
+		pright->num = pnode->num - i;
+		memcpy(_BPTF_KEYS(pright), _BPTF_KEY(pbpt, pnode, i), pright->num * size);
+		pnode->num = i;
+		pright->pnext = pnode->pnext;
+		pnode->pnext = pright;
+		psep = _BPTF_KEYS(pright);
+		while (depth > 0)
+		{
+			REGISTER P_BPTNODE_F pparent = path[--depth];
+			REGISTER size_t k = pos[depth];
+			REGISTER P_BPTNODE_F * ppc = _BPTF_CHILDREN(pbpt, pparent);
+			memmove(_BPTF_KEY(pbpt, pparent, k + 1), _BPTF_KEY(pbpt, pparent, k), (pparent->num - k) * size);
+			memcpy(_BPTF_KEY(pbpt, pparent, k), psep, size);
+			memmove(ppc + k + 2, ppc + k + 1, (pparent->num - k) * sizeof(P_BPTNODE_F));
+			ppc[k + 1] = pright;
+			if (++pparent->num <= pbpt->degree)
+				goto Lbl_Unlock;
+			/* Split an internal node. The middle key goes up and leaves both halves. */
+			pnode  = pparent;
+			pright = pnew[j++];
+			i = pnode->num >> 1;
+			pright->num = pnode->num - i - 1;
+			memcpy(_BPTF_KEYS(pright), _BPTF_KEY(pbpt, pnode, i + 1), pright->num * size);
+			memcpy(_BPTF_CHILDREN(pbpt, pright), ppc + i + 1, (pright->num + 1) * sizeof(P_BPTNODE_F));
+			pnode->num = i;
+			/* The middle key still lies in the left node beyond its count until it is copied up. */
+			psep = _BPTF_KEY(pbpt, pnode, i);
+		}
+		/* Grow a new root. */
+		pnode = pnew[j];
+		memcpy(_BPTF_KEYS(pnode), psep, size);
+		_BPTF_CHILDREN(pbpt, pnode)[0] = pbpt->proot;
+		_BPTF_CHILDREN(pbpt, pnode)[1] = pright;
+		pnode->num = 1;
+		_BPTF_FENCE();
+		_BPTF_ROOT(pbpt) = pnode;
+	}
+Lbl_Unlock:
+	for (j = top; j <= bottom; ++j)
+		_BPTF_UNLOCK(path[j]);
+	return true;
+Lbl_Allocation_Failure:
+	while (splits > 0)
+		if (NULL != pnew[--splits])
+			free(pnew[splits]);
+	return false;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treFixUnderflowBPTF
+ * Description:   Borrow keys from siblings or merge with a sibling for nodes that hold too few keys,
+ *                from path[depth] up to the root.
+ * Parameters:
+ *       pbpt Pointer to the B-plus tree.
+ *       path Nodes from the root to the leaf.
+ *        pos Index of the child chosen in each node of path.
+ *      depth Depth of the node that lost a key.
+ * Return value:  N/A.
+ * Caution:       path[depth] shall have been locked by caller and function would unlock it.
+ */
+void _treFixUnderflowBPTF(P_BPT_F pbpt, P_BPTNODE_F path[], size_t pos[], size_t depth)
+{
+	const size_t size = pbpt->size, hdeg = pbpt->degree >> 1;
+	while (depth > 0 && path[depth]->num < hdeg)
+	{
+		REGISTER P_BPTNODE_F pnode = path[depth], pparent = path[depth - 1], pleft, pright;
+		REGISTER P_BPTNODE_F * ppc = _BPTF_CHILDREN(pbpt, pparent);
+		REGISTER size_t k = pos[depth - 1];
+		pleft  = k > 0 ? ppc[k - 1] : NULL;
+		pright = k < pparent->num ? ppc[k + 1] : NULL;
+		_BPTF_LOCK(pparent);
+		if (NULL != pleft && pleft->num > hdeg)
+		{	/* Borrow the last key of the left sibling. */
+			_BPTF_LOCK(pleft);
+			memmove(_BPTF_KEY(pbpt, pnode, 1), _BPTF_KEYS(pnode), pnode->num * size);
+			if (pnode->bleaf)
+			{
+				memcpy(_BPTF_KEYS(pnode), _BPTF_KEY(pbpt, pleft, pleft->num - 1), size);
+				memcpy(_BPTF_KEY(pbpt, pparent, k - 1), _BPTF_KEYS(pnode), size);
+			}
+			else
+			{
+				memmove(_BPTF_CHILDREN(pbpt, pnode) + 1, _BPTF_CHILDREN(pbpt, pnode), (pnode->num + 1) * sizeof(P_BPTNODE_F));
+				_BPTF_CHILDREN(pbpt, pnode)[0] = _BPTF_CHILDREN(pbpt, pleft)[pleft->num];
+				memcpy(_BPTF_KEYS(pnode), _BPTF_KEY(pbpt, pparent, k - 1), size);
+				memcpy(_BPTF_KEY(pbpt, pparent, k - 1), _BPTF_KEY(pbpt, pleft, pleft->num - 1), size);
+			}
+			--pleft->num;
+			++pnode->num;
+			_BPTF_UNLOCK(pleft);
+			_BPTF_UNLOCK(pnode);
+			--depth;
+			break;
+		}
+		if (NULL != pright && pright->num > hdeg)
+		{	/* Borrow the first key of the right sibling. */
+			_BPTF_LOCK(pright);
+			if (pnode->bleaf)
+			{
+				memcpy(_BPTF_KEY(pbpt, pnode, pnode->num), _BPTF_KEYS(pright), size);
+				memmove(_BPTF_KEYS(pright), _BPTF_KEY(pbpt, pright, 1), (pright->num - 1) * size);
+				memcpy(_BPTF_KEY(pbpt, pparent, k), _BPTF_KEYS(pright), size);
+			}
+			else
+			{
+				memcpy(_BPTF_KEY(pbpt, pnode, pnode->num), _BPTF_KEY(pbpt, pparent, k), size);
+				_BPTF_CHILDREN(pbpt, pnode)[pnode->num + 1] = _BPTF_CHILDREN(pbpt, pright)[0];
+				memcpy(_BPTF_KEY(pbpt, pparent, k), _BPTF_KEYS(pright), size);
+				memmove(_BPTF_KEYS(pright), _BPTF_KEY(pbpt, pright, 1), (pright->num - 1) * size);
+				memmove(_BPTF_CHILDREN(pbpt, pright), _BPTF_CHILDREN(pbpt, pright) + 1, pright->num * sizeof(P_BPTNODE_F));
+			}
+			--pright->num;
+			++pnode->num;
+			_BPTF_UNLOCK(pright);
+			_BPTF_UNLOCK(pnode);
+			--depth;
+			break;
+		}
+		/* Merge the right one of two adjacent nodes into the left one. */
+		if (NULL == pleft)
+		{
+			pleft = pnode;
+			++k;
+			_BPTF_LOCK(pright);
+		}
+		else
+		{
+			pright = pnode;
+			_BPTF_LOCK(pleft);
+		}
+		/* Now pright is ppc[k] and pleft is ppc[k - 1]. */
+		if (pleft->bleaf)
+			pleft->pnext = pright->pnext;
+		else
+		{	/* The separator comes down between two halves. */
+			memcpy(_BPTF_KEY(pbpt, pleft, pleft->num), _BPTF_KEY(pbpt, pparent, k - 1), size);
+			memcpy(_BPTF_CHILDREN(pbpt, pleft) + pleft->num + 1, _BPTF_CHILDREN(pbpt, pright), (pright->num + 1) * sizeof(P_BPTNODE_F));
+			++pleft->num;
+		}
+		memcpy(_BPTF_KEY(pbpt, pleft, pleft->num), _BPTF_KEYS(pright), pright->num * size);
+		pleft->num += pright->num;
+		/* The left node survives. The right one stays locked, so that readers holding it would start over. */
+		_BPTF_UNLOCK(pleft);
+		_treRetireNodeBPTF(pbpt, pright);
+		/* Remove the separator and the pointer to the right node from the parent. */
+		memmove(_BPTF_KEY(pbpt, pparent, k - 1), _BPTF_KEY(pbpt, pparent, k), (pparent->num - k) * size);
+		memmove(ppc + k, ppc + k + 1, (pparent->num - k) * sizeof(P_BPTNODE_F));
+		--pparent->num;
+		--depth;
+	}
+	if (0 == depth && 0 == path[0]->num)
+	{	/* Shrink the tree. */
+		_BPTF_FENCE();
+		_BPTF_ROOT(pbpt) = path[0]->bleaf ? NULL : _BPTF_CHILDREN(pbpt, path[0])[0];
+		_treRetireNodeBPTF(pbpt, path[0]);
+	}
+	else
+		_BPTF_UNLOCK(path[depth]);
+}
+
+/* Function name: treRemoveBPTF
+ * Description:   Remove a key from a B-plus tree.
+ * Parameters:
+ *       pbpt Pointer to the B-plus tree.
+ *       pkey Pointer to the key to remove.
+ *     cbfcmp Pointer to a callback comparison function.
+ * Return value:  true:  pkey has been removed.
+ *                false: Cannot find pkey.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ */
+bool treRemoveBPTF(P_BPT_F pbpt, const void * pkey, CBF_COMPARE cbfcmp)
+{
+	P_BPTNODE_F path[_BPTF_MAX_HEIGHT];
+	size_t pos[_BPTF_MAX_HEIGHT];
+	REGISTER P_BPTNODE_F pnode = pbpt->proot;
+	REGISTER size_t i, depth = 0;
+	if (NULL == pnode)
+		return false;
+	while (! pnode->bleaf)
+	{
+		path[depth] = pnode;
+		pos[depth] = _treSearchKeysBPTF(pbpt, pnode, pkey, cbfcmp, true);
+		pnode = _BPTF_CHILDREN(pbpt, pnode)[pos[depth++]];
+	}
+	path[depth] = pnode;
+	i = _treSearchKeysBPTF(pbpt, pnode, pkey, cbfcmp, false);
+	if (i >= pnode->num || CBF_CMP_EQUAL != cbfcmp(pkey, _BPTF_KEY(pbpt, pnode, i)))
+		return false;
+	_BPTF_LOCK(pnode);
+	memmove(_BPTF_KEY(pbpt, pnode, i), _BPTF_KEY(pbpt, pnode, i + 1), (pnode->num - i - 1) * pbpt->size);
+	--pnode->num;
+	_treFixUnderflowBPTF(pbpt, path, pos, depth);
+	return true;
+}
+
+#ifdef SV_MEMORY_FENCE
+/* Function name: treSearchSharedBPTF
+ * Description:   Search a key in a B-plus tree that a writer may be altering at the same time.
+ * Parameters:
+ *       pbpt Pointer to the B-plus tree.
+ *       pkey Pointer to the key to search.
+ *       pbuf Pointer to a buffer that receives a copy of the key stored in the tree.
+ *            Its size shall be the same as keys.
+ *     cbfcmp Pointer to a callback comparison function.
+ * Return value:  true:  Found. The key has been copied into pbuf.
+ *                false: Cannot find pkey.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ *                Member bshared of the tree shall be true before readers and a writer share it.
+ *                Only one writer is supported. Writers shall be serialized by users, for example by a mutex that readers never take.
+ *                cbfcmp may see a key that a writer is moving. It shall only read the key and shall not crash on it.
+ *                This function is only provided when macro SV_MEMORY_FENCE is defined. Refer to the note of platform hooks in svdef.h.
+ * Tip:           Readers take no lock. Each node is read optimistically:
+ *                a reader records the version of a node, reads it and checks the version again.
+ *                The version of the parent is checked after the child pointer is read,
+ *                so that a reader never steps into a child that a writer detached from its parent before.
+ *                A reader that detected a change would start over from the root.
+ */
+bool treSearchSharedBPTF(P_BPT_F pbpt, const void * pkey, void * pbuf, CBF_COMPARE cbfcmp)
+{
+	REGISTER P_BPTNODE_F pnode, pchild;
+	REGISTER size_t ver, cver, i;
+	REGISTER bool bfound;
+Lbl_Restart:
+	if (NULL == (pnode = _BPTF_ROOT(pbpt)))
+		return false;
+	ver = _BPTF_VERSION(pnode);
+	SV_MEMORY_FENCE();
+	if (ver & 1)
+		goto Lbl_Restart;
+	while (! pnode->bleaf)
+	{
+		pchild = _BPTF_CHILDREN(pbpt, pnode)[_treSearchKeysBPTF(pbpt, pnode, pkey, cbfcmp, true)];
+		SV_MEMORY_FENCE();
+		if (_BPTF_VERSION(pnode) != ver)
+			goto Lbl_Restart;
+		cver = _BPTF_VERSION(pchild);
+		SV_MEMORY_FENCE();
+		if ((cver & 1) || _BPTF_VERSION(pnode) != ver)
+			goto Lbl_Restart;
+		pnode = pchild;
+		ver = cver;
+	}
+	i = _treSearchKeysBPTF(pbpt, pnode, pkey, cbfcmp, false);
+	if (0 != (bfound = (i < pnode->num && CBF_CMP_EQUAL == cbfcmp(pkey, _BPTF_KEY(pbpt, pnode, i)))))
+		memcpy(pbuf, _BPTF_KEY(pbpt, pnode, i), pbpt->size);
+	SV_MEMORY_FENCE();
+	if (_BPTF_VERSION(pnode) != ver)
+		goto Lbl_Restart;
+	return bfound;
+}
+#endif
+
+/* Function name: treReclaimBPTF
+ * Description:   Free nodes that had been retired from a shared B-plus tree.
+ * Parameter:
+ *      pbpt Pointer to the B-plus tree.
+ * Return value:  N/A.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ *                Call this function only when no reader is searching the tree, for example between two batches of queries.
+ */
+void treReclaimBPTF(P_BPT_F pbpt)
+{
+	REGISTER P_BPTNODE_F pnode;
+	while (NULL != (pnode = pbpt->pretired))
+	{
+		pbpt->pretired = pnode->pnext;
+		free(pnode);
+	}
+}
+
+#undef _BPTF_MAX_HEIGHT
+#undef _BPTF_KEYS
+#undef _BPTF_KEY
+#undef _BPTF_CHILDREN
+#undef _BPTF_FENCE
+#undef _BPTF_VERSION
+#undef _BPTF_LOCK
+#undef _BPTF_UNLOCK
+#undef _BPTF_ROOT
+/* Undefine used macros for this section. */
+
+/* This following section is for B-plus trees that store fixed-size keys in fixed-size pages of a file.
+ * Page 0 of the file is the header. Any other page is a leaf, an internal node or a free page.
+ * Pages are cached in a buffer pool with clock replacement, so memory usage depends on the number of frames only.
+ * A page that the last commit can reach is never overwritten. A change to such a page goes to a copy of it,
+ * and pages it replaced are freed only after the header that refers to the new root has been written.
+ * A crash would leave the file as it was at the last commit, except that some free pages might be lost.
+ */
+
+/* Maximum height of a paged B-plus tree. */
+#define _BPTP_MAX_HEIGHT (CHAR_BIT * sizeof(size_t))
+/* Minimum number of frames in the buffer pool. */
+#define _BPTP_MIN_FRAMES (8)
+/* Page size that would be chosen if users did not specify one. */
+#define _BPTP_PAGE_SIZE  (4096)
+/* This value indicates no frame. */
+#define _BPTP_NIL        (~(size_t)0)
+/* Magic number at the beginning of a file. */
+#define _BPTP_MAGIC      ((size_t)0x53564250UL)
+
+/* Fields of the header page. */
+#define _BPTP_H_MAGIC    0
+#define _BPTP_H_SIZE     1
+#define _BPTP_H_PAGESIZE 2
+#define _BPTP_H_ROOT     3
+#define _BPTP_H_PAGES    4
+#define _BPTP_H_FREE     5
+#define _BPTP_H_GEN      6
+#define _BPTP_H_NUM      7
+#define _BPTP_H_FIELDS   8
+
+/* Types of pages. */
+#define _BPTP_LEAF   ((size_t)0x4C)
+#define _BPTP_BRANCH ((size_t)0x42)
+#define _BPTP_FREE   ((size_t)0x46)
+
+/* Macros that access pages. A page begins with its generation, its type and the number of keys in it.
+ * A free page stores the next free page instead of the number of keys.
+ */
+#define _BPTP_DATA(pbpt, f)           ((pbpt)->pframe[f].pdata)
+#define _BPTP_GEN(pdata)              (((size_t *)(pdata))[0])
+#define _BPTP_TYPE(pdata)             (((size_t *)(pdata))[1])
+#define _BPTP_NUM(pdata)              (((size_t *)(pdata))[2])
+#define _BPTP_HDR                     (3 * sizeof(size_t))
+#define _BPTP_KEYS(pdata)             ((PUCHAR)(pdata) + _BPTP_HDR)
+#define _BPTP_KEY(pbpt, pdata, i)     (_BPTP_KEYS(pdata) + (i) * (pbpt)->size)
+#define _BPTP_CHILDREN(pbpt, pdata)   ((size_t *)(_BPTP_KEYS(pdata) + ALIGN_SIZET((pbpt)->fanout * (pbpt)->size)))
+#define _BPTP_FULL(pbpt, pdata)       (_BPTP_NUM(pdata) >= (_BPTP_LEAF == _BPTP_TYPE(pdata) ? (pbpt)->degree : (pbpt)->fanout))
+#define _BPTP_UNPIN(pbpt, f)          (--(pbpt)->pframe[f].pin)
+
+/* File level function declarations. */
+size_t _treSearchKeysBPTP    (P_BPT_P pbpt, PUCHAR       pdata,   const void * pkey,    CBF_COMPARE cbfcmp, bool bupper);
+bool   _treSeekPageBPTP      (P_BPT_P pbpt, size_t       page);
+bool   _treWriteFrameBPTP    (P_BPT_P pbpt, size_t       f);
+bool   _treWriteHeaderBPTP   (P_BPT_P pbpt);
+size_t _treFetchPageBPTP     (P_BPT_P pbpt, size_t       page,    bool         bread);
+bool   _treReserveLimboBPTP  (P_BPT_P pbpt, size_t       num);
+bool   _treReleasePageBPTP   (P_BPT_P pbpt, size_t       page);
+size_t _treAllocPageBPTP     (P_BPT_P pbpt, size_t       type);
+size_t _treOwnPageBPTP       (P_BPT_P pbpt, size_t       f,       size_t *     pslot);
+size_t _treSplitChildBPTP    (P_BPT_P pbpt, size_t       fp,      size_t       i,       size_t      fc);
+size_t _treFindLeafBPTP      (P_BPT_P pbpt, const void * pkey,    CBF_COMPARE  cbfcmp,  size_t *    pi);
+bool   _treHangPageBPTP      (P_BPT_P pbpt, size_t       spine[], size_t *     plevels, const void * pkey,  size_t page);
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treSearchKeysBPTP
+ * Description:   Search keys in a page without branches in the loop.
+ * Parameters:
+ *       pbpt Pointer to a paged B-plus tree.
+ *      pdata Pointer to the content of a page.
+ *       pkey Pointer to the key to search.
+ *     cbfcmp Pointer to a callback comparison function.
+ *     bupper Input true to count keys that are less than or equal to pkey;
+ *            Input false to count keys that are less than pkey.
+ * Return value:  Index of the first key greater than(bupper) or not less than(! bupper) pkey.
+ */
+size_t _treSearchKeysBPTP(P_BPT_P pbpt, PUCHAR pdata, const void * pkey, CBF_COMPARE cbfcmp, bool bupper)
+{
+	REGISTER PUCHAR pkeys = _BPTP_KEYS(pdata);
+	REGISTER size_t base = 0, n = _BPTP_NUM(pdata), half;
+	REGISTER int bias = bupper ? CBF_CMP_LT : CBF_CMP_EQUAL;
+	if (0 == n)
+		return 0;
+	while (n > 1)
+	{
+		half = n >> 1;
+		base += (size_t)(cbfcmp(pkey, pkeys + (base + half) * pbpt->size) > bias) * half;
+		n -= half;
+	}
+	return base + (size_t)(cbfcmp(pkey, pkeys + base * pbpt->size) > bias);
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treSeekPageBPTP
+ * Description:   Move the file position to the beginning of a page.
+ * Parameters:
+ *       pbpt Pointer to a paged B-plus tree.
+ *       page Page number.
+ * Return value:  true:  Succeeded.
+ *                false: The offset of the page could not be represented by a long integer or seeking failed.
+ */
+bool _treSeekPageBPTP(P_BPT_P pbpt, size_t page)
+{
+	if (page > (size_t)LONG_MAX / pbpt->pagesize)
+		return false;
+	return 0 == fseek(pbpt->fp, (long)(page * pbpt->pagesize), SEEK_SET);
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treWriteFrameBPTP
+ * Description:   Write the page in a frame back to the file.
+ * Parameters:
+ *       pbpt Pointer to a paged B-plus tree.
+ *          f Index of the frame.
+ * Return value:  true:  Succeeded.
+ *                false: I/O error.
+ */
+bool _treWriteFrameBPTP(P_BPT_P pbpt, size_t f)
+{
+	REGISTER P_BPTP_FRAME pf = &pbpt->pframe[f];
+	if (! _treSeekPageBPTP(pbpt, pf->page) || 1 != fwrite(pf->pdata, pbpt->pagesize, 1, pbpt->fp))
+		return false;
+	pf->bdirty = false;
+	return true;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treWriteHeaderBPTP
+ * Description:   Write the header of a paged B-plus tree and flush the file.
+ * Parameter:
+ *      pbpt Pointer to a paged B-plus tree.
+ * Return value:  true:  Succeeded.
+ *                false: I/O error.
+ */
+bool _treWriteHeaderBPTP(P_BPT_P pbpt)
+{
+	size_t h[_BPTP_H_FIELDS];
+	h[_BPTP_H_MAGIC]    = _BPTP_MAGIC;
+	h[_BPTP_H_SIZE]     = pbpt->size;
+	h[_BPTP_H_PAGESIZE] = pbpt->pagesize;
+	h[_BPTP_H_ROOT]     = pbpt->root;
+	h[_BPTP_H_PAGES]    = pbpt->pages;
+	h[_BPTP_H_FREE]     = pbpt->freelist;
+	h[_BPTP_H_GEN]      = pbpt->gen;
+	h[_BPTP_H_NUM]      = pbpt->num;
+	return _treSeekPageBPTP(pbpt, 0) && 1 == fwrite(h, sizeof(h), 1, pbpt->fp) && 0 == fflush(pbpt->fp);
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treFetchPageBPTP
+ * Description:   Pin a page in the buffer pool.
+ *                If the page were not in the pool, a frame that nobody pinned would be replaced by clock algorithm.
+ * Parameters:
+ *       pbpt Pointer to a paged B-plus tree.
+ *       page Page number.
+ *      bread Input true to read the page from the file if it is not in the pool;
+ *            Input false if the page is going to be overwritten wholly.
+ * Return value:  Index of the frame that holds the page.
+ *                _BPTP_NIL indicates every frame is pinned or an I/O error occurred.
+ * Caution:       Users shall call _BPTP_UNPIN after using the frame.
+ */
+size_t _treFetchPageBPTP(P_BPT_P pbpt, size_t page, bool bread)
+{
+	REGISTER size_t f, n;
+	REGISTER size_t * pb;
+	REGISTER P_BPTP_FRAME pf = pbpt->pframe;
+	for (f = pbpt->pbucket[page % pbpt->frames]; _BPTP_NIL != f; f = pbpt->pframe[f].hnext)
+	{
+		if (pbpt->pframe[f].page == page)
+		{
+			++pbpt->pframe[f].pin;
+			pbpt->pframe[f].bref = true;
+			return f;
+		}
+	}
+	/* Sweep the clock hand. Each frame would be visited twice at most. */
+	for (n = pbpt->frames << 1; n > 0; --n)
+	{
+		pf = &pbpt->pframe[f = pbpt->hand];
+		pbpt->hand = (pbpt->hand + 1) % pbpt->frames;
+		if (0 == pf->pin)
+		{
+			if (! pf->bref)
+				break;
+			pf->bref = false;
+		}
+	}
+	if (0 == n)
+		return _BPTP_NIL;
+	if (pf->bdirty && ! _treWriteFrameBPTP(pbpt, f))
+		return _BPTP_NIL;
+	if (0 != pf->page)
+	{	/* Unlink the victim from its bucket. */
+		for (pb = &pbpt->pbucket[pf->page % pbpt->frames]; *pb != f; pb = &pbpt->pframe[*pb].hnext)
+			;
+		*pb = pf->hnext;
+		pf->page = 0;
+	}
+	if (bread && (! _treSeekPageBPTP(pbpt, page) || 1 != fread(pf->pdata, pbpt->pagesize, 1, pbpt->fp)))
+		return _BPTP_NIL;
+	pf->page  = page;
+	pf->pin   = 1;
+	pf->bref  = true;
+	pf->hnext = pbpt->pbucket[page % pbpt->frames];
+	pbpt->pbucket[page % pbpt->frames] = f;
+	return f;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treReserveLimboBPTP
+ * Description:   Make sure that limbo could hold num more pages.
+ * Parameters:
+ *       pbpt Pointer to a paged B-plus tree.
+ *        num Number of pages.
+ * Return value:  true:  Succeeded.
+ *                false: Allocation failure.
+ */
+bool _treReserveLimboBPTP(P_BPT_P pbpt, size_t num)
+{
+	if (pbpt->nlimbo + num <= strLevelArrayZ(&pbpt->limbo))
+		return true;
+	return NULL != strResizeArrayZ(&pbpt->limbo, ((pbpt->nlimbo + num) << 1) + _BPTP_MIN_FRAMES, sizeof(size_t));
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treReleasePageBPTP
+ * Description:   Put a page that the tree no longer refers to into limbo.
+ *                Pages in limbo would become free pages at the next commit.
+ * Parameters:
+ *       pbpt Pointer to a paged B-plus tree.
+ *       page Page number.
+ * Return value:  true:  Succeeded.
+ *                false: Allocation failure.
+ */
+bool _treReleasePageBPTP(P_BPT_P pbpt, size_t page)
+{
+	if (! _treReserveLimboBPTP(pbpt, 1))
+		return false;
+	((size_t *)pbpt->limbo.pdata)[pbpt->nlimbo++] = page;
+	return true;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treAllocPageBPTP
+ * Description:   Allocate an empty page from free page list or from the end of the file.
+ * Parameters:
+ *       pbpt Pointer to a paged B-plus tree.
+ *       type _BPTP_LEAF or _BPTP_BRANCH.
+ * Return value:  Index of the frame that holds the new page. The frame is pinned.
+ *                _BPTP_NIL indicates a failure.
+ */
+size_t _treAllocPageBPTP(P_BPT_P pbpt, size_t type)
+{
+	REGISTER size_t f, page;
+	REGISTER PUCHAR pdata;
+	while (0 != (page = pbpt->freelist))
+	{
+		if (_BPTP_NIL == (f = _treFetchPageBPTP(pbpt, page, true)))
+			return _BPTP_NIL;
+		pdata = _BPTP_DATA(pbpt, f);
+		if (_BPTP_FREE == _BPTP_TYPE(pdata) && _BPTP_NUM(pdata) < pbpt->pages)
+		{
+			pbpt->freelist = _BPTP_NUM(pdata);
+			goto Lbl_Initialize;
+		}
+		/* A crash broke free page list after the page had been reused. Give up the rest of the list. */
+		_BPTP_UNPIN(pbpt, f);
+		pbpt->freelist = 0;
+	}
+	if (_BPTP_NIL == (f = _treFetchPageBPTP(pbpt, pbpt->pages, false)))
+		return _BPTP_NIL;
+	++pbpt->pages;
+	pdata = _BPTP_DATA(pbpt, f);
+Lbl_Initialize:
+	_BPTP_GEN(pdata)  = pbpt->gen + 1;
+	_BPTP_TYPE(pdata) = type;
+	_BPTP_NUM(pdata)  = 0;
+	pbpt->pframe[f].bdirty = true;
+	return f;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treOwnPageBPTP
+ * Description:   Make a pinned page writable.
+ *                A page that was written after the last commit is returned directly,
+ *                otherwise the page is copied to a new page and the old one goes to limbo.
+ * Parameters:
+ *       pbpt Pointer to a paged B-plus tree.
+ *          f Index of a pinned frame.
+ *      pslot Pointer to the place that refers to the page, that is either the root or a child slot of a writable parent.
+ *            It would be updated if the page moved.
+ * Return value:  Index of the pinned frame to write. Frame f would be unpinned if it differs from the returned one.
+ *                _BPTP_NIL indicates a failure. Frame f is still pinned in this case.
+ */
+size_t _treOwnPageBPTP(P_BPT_P pbpt, size_t f, size_t * pslot)
+{
+	REGISTER size_t n;
+	if (_BPTP_GEN(_BPTP_DATA(pbpt, f)) > pbpt->gen)
+	{
+		pbpt->pframe[f].bdirty = true;
+		return f;
+	}
+	if (! _treReleasePageBPTP(pbpt, pbpt->pframe[f].page))
+		return _BPTP_NIL;
+	if (_BPTP_NIL == (n = _treAllocPageBPTP(pbpt, _BPTP_TYPE(_BPTP_DATA(pbpt, f)))))
+	{
+		--pbpt->nlimbo;
+		return _BPTP_NIL;
+	}
+	memcpy(_BPTP_DATA(pbpt, n), _BPTP_DATA(pbpt, f), pbpt->pagesize);
+	_BPTP_GEN(_BPTP_DATA(pbpt, n)) = pbpt->gen + 1;
+	*pslot = pbpt->pframe[n].page;
+	_BPTP_UNPIN(pbpt, f);
+	return n;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treSplitChildBPTP
+ * Description:   Split a full child into two pages and insert a separator into its parent.
+ * Parameters:
+ *       pbpt Pointer to a paged B-plus tree.
+ *         fp Frame of the writable parent which is not full.
+ *          i Index of the child in the parent.
+ *         fc Frame of the writable child which is full.
+ * Return value:  Frame of the right half. It is pinned.
+ *                _BPTP_NIL indicates a failure. Nothing would be changed in this case.
+ */
+size_t _treSplitChildBPTP(P_BPT_P pbpt, size_t fp, size_t i, size_t fc)
+{
+	REGISTER PUCHAR pp = _BPTP_DATA(pbpt, fp), pc = _BPTP_DATA(pbpt, fc), pr;
+	REGISTER size_t * ppc = _BPTP_CHILDREN(pbpt, pp);
+	REGISTER size_t fr, m, n = _BPTP_NUM(pc);
+	const size_t size = pbpt->size;
+	if (_BPTP_NIL == (fr = _treAllocPageBPTP(pbpt, _BPTP_TYPE(pc))))
+		return _BPTP_NIL;
+	pr = _BPTP_DATA(pbpt, fr);
+	m = n >> 1;
+	/* Make room for the separator and the right half in the parent. */
+	memmove(_BPTP_KEY(pbpt, pp, i + 1), _BPTP_KEY(pbpt, pp, i), (_BPTP_NUM(pp) - i) * size);
+	memmove(ppc + i + 2, ppc + i + 1, (_BPTP_NUM(pp) - i) * sizeof(size_t));
+	ppc[i + 1] = pbpt->pframe[fr].page;
+	++_BPTP_NUM(pp);
+	if (_BPTP_LEAF == _BPTP_TYPE(pc))
+	{	/* The first key of the right half goes up. */
+		_BPTP_NUM(pr) = n - m;
+		memcpy(_BPTP_KEYS(pr), _BPTP_KEY(pbpt, pc, m), (n - m) * size);
+		memcpy(_BPTP_KEY(pbpt, pp, i), _BPTP_KEYS(pr), size);
+	}
+	else
+	{	/* The middle key goes up and leaves both halves. */
+		_BPTP_NUM(pr) = n - m - 1;
+		memcpy(_BPTP_KEYS(pr), _BPTP_KEY(pbpt, pc, m + 1), (n - m - 1) * size);
+		memcpy(_BPTP_CHILDREN(pbpt, pr), _BPTP_CHILDREN(pbpt, pc) + m + 1, (n - m) * sizeof(size_t));
+		memcpy(_BPTP_KEY(pbpt, pp, i), _BPTP_KEY(pbpt, pc, m), size);
+	}
+	_BPTP_NUM(pc) = m;
+	pbpt->pframe[fp].bdirty = pbpt->pframe[fc].bdirty = true;
+	return fr;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treFindLeafBPTP
+ * Description:   Find the leaf that may contain a key.
+ * Parameters:
+ *       pbpt Pointer to a non-empty paged B-plus tree.
+ *       pkey Pointer to a key.
+ *     cbfcmp Pointer to a callback comparison function.
+ *         pi Pointer to a size_t that receives the index of the first key that is not less than pkey in the leaf.
+ * Return value:  Frame of the leaf. It is pinned.
+ *                _BPTP_NIL indicates a failure.
+ */
+size_t _treFindLeafBPTP(P_BPT_P pbpt, const void * pkey, CBF_COMPARE cbfcmp, size_t * pi)
+{
+	REGISTER size_t f, page = pbpt->root;
+	REGISTER PUCHAR pdata;
+	for ( ;; )
+	{
+		if (_BPTP_NIL == (f = _treFetchPageBPTP(pbpt, page, true)))
+			return _BPTP_NIL;
+		pdata = _BPTP_DATA(pbpt, f);
+		if (_BPTP_LEAF == _BPTP_TYPE(pdata))
+			break;
+		page = _BPTP_CHILDREN(pbpt, pdata)[_treSearchKeysBPTP(pbpt, pdata, pkey, cbfcmp, true)];
+		_BPTP_UNPIN(pbpt, f);
+	}
+	*pi = _treSearchKeysBPTP(pbpt, pdata, pkey, cbfcmp, false);
+	return f;
+}
+
+/* Function name: treOpenBPTP
+ * Description:   Open a paged B-plus tree in a file. A new file would be created if it did not exist.
+ * Parameters:
+ *       pbpt Pointer to the paged B-plus tree you want to initialize.
+ *       name File name.
+ *       size Size of each key. Input 0 to use the size that an existing file recorded.
+ *   pagesize Size of each page. Input 0 to use the size that an existing file recorded or 4096 for a new file.
+ *            A page shall be able to hold at least 3 keys with their child pointers.
+ *     frames Number of pages that the buffer pool caches. It would be raised to 8 if it were less than 8.
+ * Return value:  true:  Succeeded.
+ *                false: The file could not be opened, or it did not match size and pagesize, or allocation failed.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ *                Call function treCloseBPTP to close a tree that was opened successfully.
+ *                A file can only be opened on the platform that created it.
+ * Usage:         BPT_P bpt;
+ *                if (treOpenBPTP(&bpt, "index.bpt", sizeof(int), 0, 1024))
+ *                {
+ *                    treInsertBPTP(&bpt, &a, cbfcmp);
+ *                    treCommitBPTP(&bpt);
+ *                    if (treSearchBPTP(&bpt, &a, cbfcmp)) ...
+ *                    treCloseBPTP(&bpt);
+ *                }
+ */
+bool treOpenBPTP(P_BPT_P pbpt, const char * name, size_t size, size_t pagesize, size_t frames)
+{
+	size_t h[_BPTP_H_FIELDS];
+	REGISTER size_t f, hdr = _BPTP_HDR;
+	REGISTER bool bnew = false;
+	if (0 != pagesize)
+		pagesize = ALIGN_SIZET(pagesize);
+	if (NULL == (pbpt->fp = fopen(name, "r+b")))
+	{
+		if (0 == size || NULL == (pbpt->fp = fopen(name, "w+b")))
+			return false;
+		bnew = true;
+		h[_BPTP_H_SIZE]     = size;
+		h[_BPTP_H_PAGESIZE] = 0 == pagesize ? _BPTP_PAGE_SIZE : pagesize;
+		h[_BPTP_H_ROOT]     = 0;
+		h[_BPTP_H_PAGES]    = 1;
+		h[_BPTP_H_FREE]     = 0;
+		h[_BPTP_H_GEN]      = 0;
+		h[_BPTP_H_NUM]      = 0;
+	}
+	else if
+	(
+		1 != fread(h, sizeof(h), 1, pbpt->fp) || _BPTP_MAGIC != h[_BPTP_H_MAGIC] ||
+		(0 != size && size != h[_BPTP_H_SIZE]) || (0 != pagesize && pagesize != h[_BPTP_H_PAGESIZE])
+	)
+		goto Lbl_Bad_File;
+	pbpt->size     = h[_BPTP_H_SIZE];
+	pbpt->pagesize = h[_BPTP_H_PAGESIZE];
+	pbpt->root     = h[_BPTP_H_ROOT];
+	pbpt->pages    = h[_BPTP_H_PAGES];
+	pbpt->freelist = h[_BPTP_H_FREE];
+	pbpt->gen      = h[_BPTP_H_GEN];
+	pbpt->num      = h[_BPTP_H_NUM];
+	if (pbpt->pagesize < sizeof(h) || pbpt->pagesize <= hdr + sizeof(size_t) + pbpt->size)
+		goto Lbl_Bad_File;
+	/* A leaf holds keys only. An internal page holds one more child pointer than keys. */
+	pbpt->degree = (pbpt->pagesize - hdr) / pbpt->size;
+	pbpt->fanout = (pbpt->pagesize - hdr - sizeof(size_t)) / (pbpt->size + sizeof(size_t));
+	while (pbpt->fanout > 0 && hdr + ALIGN_SIZET(pbpt->fanout * pbpt->size) + (pbpt->fanout + 1) * sizeof(size_t) > pbpt->pagesize)
+		--pbpt->fanout;
+	if (pbpt->degree < 2 || pbpt->fanout < 3)
+		goto Lbl_Bad_File;
+	pbpt->frames = frames < _BPTP_MIN_FRAMES ? _BPTP_MIN_FRAMES : frames;
+	pbpt->hand   = 0;
+	pbpt->nlimbo = 0;
+	strInitArrayZ(&pbpt->limbo, 0, sizeof(size_t));
+	if (NULL == (pbpt->pframe = (P_BPTP_FRAME) malloc(pbpt->frames * sizeof(BPTP_FRAME))))
+		goto Lbl_Bad_File;
+	if (NULL == (pbpt->pbucket = (size_t *) malloc(pbpt->frames * sizeof(size_t))))
+		goto Lbl_Allocation_Failure;
+	if (NULL == (pbpt->pframe[0].pdata = (PUCHAR) malloc(pbpt->frames * pbpt->pagesize)))
+	{
+		free(pbpt->pbucket);
+		goto Lbl_Allocation_Failure;
+	}
+	for (f = 0; f < pbpt->frames; ++f)
+	{
+		pbpt->pframe[f].page   = 0;
+		pbpt->pframe[f].pin    = 0;
+		pbpt->pframe[f].hnext  = _BPTP_NIL;
+		pbpt->pframe[f].bdirty = false;
+		pbpt->pframe[f].bref   = false;
+		pbpt->pframe[f].pdata  = pbpt->pframe[0].pdata + f * pbpt->pagesize;
+		pbpt->pbucket[f]       = _BPTP_NIL;
+	}
+	if (bnew)
+	{	/* Write a whole header page, so that the first page to append starts at the end of the file. */
+		memset(pbpt->pframe[0].pdata, 0, pbpt->pagesize);
+		if (! _treSeekPageBPTP(pbpt, 0) || 1 != fwrite(pbpt->pframe[0].pdata, pbpt->pagesize, 1, pbpt->fp) || ! _treWriteHeaderBPTP(pbpt))
+		{
+			free(pbpt->pframe[0].pdata);
+			free(pbpt->pbucket);
+			goto Lbl_Allocation_Failure;
+		}
+	}
+	return true;
+Lbl_Allocation_Failure:
+	free(pbpt->pframe);
+Lbl_Bad_File:
+	fclose(pbpt->fp);
+	return false;
+}
+
+/* Function name: treCommitBPTP
+ * Description:   Make every change since the last commit durable.
+ * Parameter:
+ *      pbpt Pointer to a paged B-plus tree.
+ * Return value:  true:  Succeeded.
+ *                false: I/O error or allocation failure. The file still holds the tree of the last commit.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ *                Writing order is: new pages, then the header that refers to the new root,
+ *                then pages that had been replaced are linked into free page list, then the header again.
+ *                Function fflush hands data to the operating system only.
+ *                Data would survive a crash of the process,
+ *                while surviving a power failure needs the operating system to write its cache in order.
+ */
+bool treCommitBPTP(P_BPT_P pbpt)
+{
+	REGISTER size_t f, i;
+	for (f = 0; f < pbpt->frames; ++f)
+		if (pbpt->pframe[f].bdirty && ! _treWriteFrameBPTP(pbpt, f))
+			return false;
+	++pbpt->gen;
+	if (0 != fflush(pbpt->fp) || ! _treWriteHeaderBPTP(pbpt))
+	{
+		--pbpt->gen;
+		return false;
+	}
+	/* The new tree is on disk. No committed page refers to pages in limbo any longer. */
+	for (i = 0; i < pbpt->nlimbo; ++i)
+	{
+		REGISTER PUCHAR pdata;
+		if (_BPTP_NIL == (f = _treFetchPageBPTP(pbpt, ((size_t *)pbpt->limbo.pdata)[i], false)))
+			return false;
+		pdata = _BPTP_DATA(pbpt, f);
+		_BPTP_GEN(pdata)  = pbpt->gen;
+		_BPTP_TYPE(pdata) = _BPTP_FREE;
+		_BPTP_NUM(pdata)  = pbpt->freelist;
+		pbpt->freelist = pbpt->pframe[f].page;
+		pbpt->pframe[f].bdirty = true;
+		_BPTP_UNPIN(pbpt, f);
+	}
+	pbpt->nlimbo = 0;
+	for (f = 0; f < pbpt->frames; ++f)
+		if (pbpt->pframe[f].bdirty && ! _treWriteFrameBPTP(pbpt, f))
+			return false;
+	return 0 == fflush(pbpt->fp) && _treWriteHeaderBPTP(pbpt);
+}
+
+/* Function name: treCloseBPTP
+ * Description:   Commit changes and close a paged B-plus tree.
+ * Parameter:
+ *      pbpt Pointer to a paged B-plus tree that was opened by function treOpenBPTP.
+ * Return value:  true:  Succeeded.
+ *                false: Committing or closing the file failed.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ *                Memory would be released even if function returned false.
+ */
+bool treCloseBPTP(P_BPT_P pbpt)
+{
+	REGISTER bool r = treCommitBPTP(pbpt);
+	free(pbpt->pframe[0].pdata);
+	free(pbpt->pframe);
+	free(pbpt->pbucket);
+	if (NULL != pbpt->limbo.pdata)
+		strFreeArrayZ(&pbpt->limbo);
+	return 0 == fclose(pbpt->fp) && r;
+}
+
+/* Function name: treTraverseKeyBPTP
+ * Description:   Traverse each key in a paged B-plus tree in ascending order.
+ * Parameters:
+ *       pbpt Pointer to a paged B-plus tree.
+ *     cbftvs Pointer to a callback function to traverse.
+ *            Parameter pitem of callback function points to a key in the buffer pool.
+ *      param A size_t value which can be transferred into callback function.
+ * Return value:  The same value as callback function returns.
+ *                CBF_TERMINATE would also be returned if a page could not be read.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ *                Callback function shall not alter the tree.
+ */
+int treTraverseKeyBPTP(P_BPT_P pbpt, CBF_TRAVERSE cbftvs, size_t param)
+{
+	size_t path[_BPTP_MAX_HEIGHT], pos[_BPTP_MAX_HEIGHT];
+	REGISTER size_t f, i, depth = 0, page = pbpt->root;
+	REGISTER PUCHAR pdata;
+	if (0 == page)
+		return CBF_CONTINUE;
+	for ( ;; )
+	{
+		if (_BPTP_NIL == (f = _treFetchPageBPTP(pbpt, page, true)))
+			return CBF_TERMINATE;
+		pdata = _BPTP_DATA(pbpt, f);
+		if (_BPTP_BRANCH == _BPTP_TYPE(pdata))
+		{	/* Go down to the first child. Only one page is pinned at a time. */
+			path[depth]  = page;
+			pos[depth++] = 0;
+			page = _BPTP_CHILDREN(pbpt, pdata)[0];
+			_BPTP_UNPIN(pbpt, f);
+			continue;
+		}
+		for (i = 0; i < _BPTP_NUM(pdata); ++i)
+		{
+			if (CBF_CONTINUE != cbftvs(_BPTP_KEY(pbpt, pdata, i), param))
+			{
+				_BPTP_UNPIN(pbpt, f);
+				return CBF_TERMINATE;
+			}
+		}
+		_BPTP_UNPIN(pbpt, f);
+		/* Climb up to the nearest ancestor that has children left. */
+		for ( ;; )
+		{
+			if (0 == depth)
+				return CBF_CONTINUE;
+			if (_BPTP_NIL == (f = _treFetchPageBPTP(pbpt, path[depth - 1], true)))
+				return CBF_TERMINATE;
+			pdata = _BPTP_DATA(pbpt, f);
+			if (pos[depth - 1] < _BPTP_NUM(pdata))
+			{
+				page = _BPTP_CHILDREN(pbpt, pdata)[++pos[depth - 1]];
+				_BPTP_UNPIN(pbpt, f);
+				break;
+			}
+			_BPTP_UNPIN(pbpt, f);
+			--depth;
+		}
+	}
+}
+
+/* Function name: treSearchBPTP
+ * Description:   Search a key in a paged B-plus tree.
+ * Parameters:
+ *       pbpt Pointer to a paged B-plus tree.
+ *       pkey Pointer to the key to search. The key stored in the tree would be copied here if it were found.
+ *     cbfcmp Pointer to a callback comparison function.
+ * Return value:  true:  Found.
+ *                false: Cannot find pkey or a page could not be read.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ * Tip:           Keys that carry payload beyond the part cbfcmp compares could be fetched wholly in this way.
+ */
+bool treSearchBPTP(P_BPT_P pbpt, void * pkey, CBF_COMPARE cbfcmp)
+{
+	size_t i;
+	REGISTER size_t f;
+	REGISTER bool r = false;
+	if (0 != pbpt->root && _BPTP_NIL != (f = _treFindLeafBPTP(pbpt, pkey, cbfcmp, &i)))
+	{
+		REGISTER PUCHAR pdata = _BPTP_DATA(pbpt, f);
+		if (i < _BPTP_NUM(pdata) && CBF_CMP_EQUAL == cbfcmp(pkey, _BPTP_KEY(pbpt, pdata, i)))
+		{
+			memcpy(pkey, _BPTP_KEY(pbpt, pdata, i), pbpt->size);
+			r = true;
+		}
+		_BPTP_UNPIN(pbpt, f);
+	}
+	return r;
+}
+
+/* Function name: treInsertBPTP
+ * Description:   Insert a key into a paged B-plus tree.
+ * Parameters:
+ *       pbpt Pointer to a paged B-plus tree.
+ *       pkey Pointer to the key to insert. Key would be copied into the tree.
+ *     cbfcmp Pointer to a callback comparison function.
+ * Return value:  true:  Succeeded. A key that already existed would not be inserted again.
+ *                false: I/O error or allocation failure. The tree is still valid but pkey might not be in it.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ * Tip:           Full pages are split on the way down, so that at most three pages are pinned at a time.
+ */
+bool treInsertBPTP(P_BPT_P pbpt, const void * pkey, CBF_COMPARE cbfcmp)
+{
+	size_t i;
+	REGISTER size_t f, fc, fr;
+	REGISTER PUCHAR pdata;
+	REGISTER bool bfound;
+	if (0 == pbpt->root)
+	{
+		if (_BPTP_NIL == (f = _treAllocPageBPTP(pbpt, _BPTP_LEAF)))
+			return false;
+		pbpt->root = pbpt->pframe[f].page;
+	}
+	else
+	{
+		if (_BPTP_NIL == (f = _treFindLeafBPTP(pbpt, pkey, cbfcmp, &i)))
+			return false;
+		pdata = _BPTP_DATA(pbpt, f);
+		bfound = i < _BPTP_NUM(pdata) && CBF_CMP_EQUAL == cbfcmp(pkey, _BPTP_KEY(pbpt, pdata, i));
+		_BPTP_UNPIN(pbpt, f);
+		if (bfound)
+			return true;
+		if (_BPTP_NIL == (f = _treFetchPageBPTP(pbpt, pbpt->root, true)))
+			return false;
+		if (_BPTP_NIL == (fc = _treOwnPageBPTP(pbpt, f, &pbpt->root)))
+			goto Lbl_Failure;
+		f = fc;
+		if (_BPTP_FULL(pbpt, _BPTP_DATA(pbpt, f)))
+		{	/* Grow a new root above the full one. */
+			if (_BPTP_NIL == (fc = _treAllocPageBPTP(pbpt, _BPTP_BRANCH)))
+				goto Lbl_Failure;
+			_BPTP_CHILDREN(pbpt, _BPTP_DATA(pbpt, fc))[0] = pbpt->root;
+			pbpt->root = pbpt->pframe[fc].page;
+			if (_BPTP_NIL == (fr = _treSplitChildBPTP(pbpt, fc, 0, f)))
+			{
+				_BPTP_UNPIN(pbpt, fc);
+				goto Lbl_Failure;
+			}
+			if (cbfcmp(pkey, _BPTP_KEYS(_BPTP_DATA(pbpt, fc))) >= 0)
+			{
+				_BPTP_UNPIN(pbpt, f);
+				f = fr;
+			}
+			else
+				_BPTP_UNPIN(pbpt, fr);
+			_BPTP_UNPIN(pbpt, fc);
+		}
+		while (_BPTP_BRANCH == _BPTP_TYPE(pdata = _BPTP_DATA(pbpt, f)))
+		{
+			i = _treSearchKeysBPTP(pbpt, pdata, pkey, cbfcmp, true);
+			if (_BPTP_NIL == (fc = _treFetchPageBPTP(pbpt, _BPTP_CHILDREN(pbpt, pdata)[i], true)))
+				goto Lbl_Failure;
+			if (_BPTP_NIL == (fr = _treOwnPageBPTP(pbpt, fc, &_BPTP_CHILDREN(pbpt, pdata)[i])))
+			{
+				_BPTP_UNPIN(pbpt, fc);
+				goto Lbl_Failure;
+			}
+			fc = fr;
+			if (_BPTP_FULL(pbpt, _BPTP_DATA(pbpt, fc)))
+			{
+				if (_BPTP_NIL == (fr = _treSplitChildBPTP(pbpt, f, i, fc)))
+				{
+					_BPTP_UNPIN(pbpt, fc);
+					goto Lbl_Failure;
+				}
+				if (cbfcmp(pkey, _BPTP_KEY(pbpt, pdata, i)) >= 0)
+				{
+					_BPTP_UNPIN(pbpt, fc);
+					fc = fr;
+				}
+				else
+					_BPTP_UNPIN(pbpt, fr);
+			}
+			_BPTP_UNPIN(pbpt, f);
+			f = fc;
+		}
+	}
+	pdata = _BPTP_DATA(pbpt, f);
+	i = _treSearchKeysBPTP(pbpt, pdata, pkey, cbfcmp, false);
+	memmove(_BPTP_KEY(pbpt, pdata, i + 1), _BPTP_KEY(pbpt, pdata, i), (_BPTP_NUM(pdata) - i) * pbpt->size);
+	memcpy(_BPTP_KEY(pbpt, pdata, i), pkey, pbpt->size);
+	++_BPTP_NUM(pdata);
+	_BPTP_UNPIN(pbpt, f);
+	++pbpt->num;
+	return true;
+Lbl_Failure:
+	_BPTP_UNPIN(pbpt, f);
+	return false;
+}
+
+/* Function name: treRemoveBPTP
+ * Description:   Remove a key from a paged B-plus tree.
+ * Parameters:
+ *       pbpt Pointer to a paged B-plus tree.
+ *       pkey Pointer to the key to remove.
+ *     cbfcmp Pointer to a callback comparison function.
+ * Return value:  true:  pkey has been removed.
+ *                false: Cannot find pkey, or I/O error or allocation failure. The tree is still valid.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ * Tip:           Pages are not merged. A page would be freed when it became empty.
+ */
+bool treRemoveBPTP(P_BPT_P pbpt, const void * pkey, CBF_COMPARE cbfcmp)
+{
+	size_t path[_BPTP_MAX_HEIGHT + 1], pos[_BPTP_MAX_HEIGHT];
+	size_t i;
+	REGISTER size_t f, fc, j, depth = 0;
+	REGISTER PUCHAR pdata;
+	REGISTER bool bfound;
+	if (0 == pbpt->root || _BPTP_NIL == (f = _treFindLeafBPTP(pbpt, pkey, cbfcmp, &i)))
+		return false;
+	pdata = _BPTP_DATA(pbpt, f);
+	bfound = i < _BPTP_NUM(pdata) && CBF_CMP_EQUAL == cbfcmp(pkey, _BPTP_KEY(pbpt, pdata, i));
+	_BPTP_UNPIN(pbpt, f);
+	if (! bfound)
+		return false;
+	/* Copy the path to the leaf. */
+	if (_BPTP_NIL == (f = _treFetchPageBPTP(pbpt, pbpt->root, true)))
+		return false;
+	if (_BPTP_NIL == (fc = _treOwnPageBPTP(pbpt, f, &pbpt->root)))
+		goto Lbl_Failure;
+	f = fc;
+	while (_BPTP_BRANCH == _BPTP_TYPE(pdata = _BPTP_DATA(pbpt, f)))
+	{
+		path[depth] = pbpt->pframe[f].page;
+		i = pos[depth++] = _treSearchKeysBPTP(pbpt, pdata, pkey, cbfcmp, true);
+		if (_BPTP_NIL == (fc = _treFetchPageBPTP(pbpt, _BPTP_CHILDREN(pbpt, pdata)[i], true)))
+			goto Lbl_Failure;
+		if (_BPTP_NIL == (j = _treOwnPageBPTP(pbpt, fc, &_BPTP_CHILDREN(pbpt, pdata)[i])))
+		{
+			_BPTP_UNPIN(pbpt, fc);
+			goto Lbl_Failure;
+		}
+		_BPTP_UNPIN(pbpt, f);
+		f = j;
+	}
+	path[depth] = pbpt->pframe[f].page;
+	i = _treSearchKeysBPTP(pbpt, pdata, pkey, cbfcmp, false);
+	memmove(_BPTP_KEY(pbpt, pdata, i), _BPTP_KEY(pbpt, pdata, i + 1), (_BPTP_NUM(pdata) - i - 1) * pbpt->size);
+	j = --_BPTP_NUM(pdata);
+	_BPTP_UNPIN(pbpt, f);
+	--pbpt->num;
+	/* An empty leaf stays in the tree if limbo could not hold pages to free. */
+	if (0 == j && _treReserveLimboBPTP(pbpt, depth + 2))
+	{	/* Find the lowest ancestor that has other children and unlink the empty branch from it. */
+		for (j = depth; j > 0; --j)
+		{
+			if (_BPTP_NIL == (f = _treFetchPageBPTP(pbpt, path[j - 1], true)))
+				return true;
+			pdata = _BPTP_DATA(pbpt, f);
+			if (_BPTP_NUM(pdata) > 0)
+			{
+				REGISTER size_t k = pos[j - 1], * ppc = _BPTP_CHILDREN(pbpt, pdata);
+				i = k > 0 ? k - 1 : 0;
+				memmove(_BPTP_KEY(pbpt, pdata, i), _BPTP_KEY(pbpt, pdata, i + 1), (_BPTP_NUM(pdata) - i - 1) * pbpt->size);
+				memmove(ppc + k, ppc + k + 1, (_BPTP_NUM(pdata) - k) * sizeof(size_t));
+				--_BPTP_NUM(pdata);
+				/* The page may have been evicted since it was owned during the descent. */
+				pbpt->pframe[f].bdirty = true;
+				_BPTP_UNPIN(pbpt, f);
+				break;
+			}
+			_BPTP_UNPIN(pbpt, f);
+		}
+		if (0 == j)
+			pbpt->root = 0;
+		for (i = j; i <= depth; ++i)
+			_treReleasePageBPTP(pbpt, path[i]);
+		/* Shrink the tree while the root has only one child. */
+		while (0 != pbpt->root && _treReserveLimboBPTP(pbpt, 1))
+		{
+			if (_BPTP_NIL == (f = _treFetchPageBPTP(pbpt, pbpt->root, true)))
+				break;
+			pdata = _BPTP_DATA(pbpt, f);
+			if (_BPTP_BRANCH != _BPTP_TYPE(pdata) || 0 != _BPTP_NUM(pdata))
+			{
+				_BPTP_UNPIN(pbpt, f);
+				break;
+			}
+			j = _BPTP_CHILDREN(pbpt, pdata)[0];
+			_BPTP_UNPIN(pbpt, f);
+			_treReleasePageBPTP(pbpt, pbpt->root);
+			pbpt->root = j;
+		}
+	}
+	return true;
+Lbl_Failure:
+	_BPTP_UNPIN(pbpt, f);
+	return false;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treHangPageBPTP
+ * Description:   Hang a new page at the right end of the level above it while bulk loading.
+ * Parameters:
+ *       pbpt Pointer to a paged B-plus tree.
+ *      spine Page numbers of the rightmost page of each level. spine[0] is a leaf.
+ *    plevels Pointer to the number of internal levels.
+ *       pkey Pointer to the smallest key under the new page.
+ *       page Number of the new page that is the right neighbor of spine[0].
+ * Return value:  true:  Succeeded.
+ *                false: I/O error or allocation failure. The tree under spine[*plevels] is still valid.
+ */
+bool _treHangPageBPTP(P_BPT_P pbpt, size_t spine[], size_t * plevels, const void * pkey, size_t page)
+{
+	REGISTER size_t f, l;
+	REGISTER PUCHAR pdata;
+	for (l = 1; ; ++l)
+	{
+		if (l > *plevels)
+		{	/* Grow a new level above the highest one. */
+			if (l >= _BPTP_MAX_HEIGHT || _BPTP_NIL == (f = _treAllocPageBPTP(pbpt, _BPTP_BRANCH)))
+				return false;
+			pdata = _BPTP_DATA(pbpt, f);
+			memcpy(_BPTP_KEYS(pdata), pkey, pbpt->size);
+			_BPTP_CHILDREN(pbpt, pdata)[0] = spine[l - 1];
+			_BPTP_CHILDREN(pbpt, pdata)[1] = page;
+			_BPTP_NUM(pdata) = 1;
+			spine[l] = pbpt->pframe[f].page;
+			_BPTP_UNPIN(pbpt, f);
+			*plevels = l;
+			spine[l - 1] = page;
+			return true;
+		}
+		if (_BPTP_NIL == (f = _treFetchPageBPTP(pbpt, spine[l], true)))
+			return false;
+		pdata = _BPTP_DATA(pbpt, f);
+		if (_BPTP_NUM(pdata) < pbpt->fanout)
+		{
+			memcpy(_BPTP_KEY(pbpt, pdata, _BPTP_NUM(pdata)), pkey, pbpt->size);
+			_BPTP_CHILDREN(pbpt, pdata)[_BPTP_NUM(pdata) + 1] = page;
+			++_BPTP_NUM(pdata);
+			pbpt->pframe[f].bdirty = true;
+			_BPTP_UNPIN(pbpt, f);
+			spine[l - 1] = page;
+			return true;
+		}
+		_BPTP_UNPIN(pbpt, f);
+		/* The internal page is full. Start a new one with page as its first child and hang it one level higher. */
+		if (_BPTP_NIL == (f = _treAllocPageBPTP(pbpt, _BPTP_BRANCH)))
+			return false;
+		_BPTP_CHILDREN(pbpt, _BPTP_DATA(pbpt, f))[0] = page;
+		spine[l - 1] = page;
+		page = pbpt->pframe[f].page;
+		_BPTP_UNPIN(pbpt, f);
+	}
+}
+
+/* Function name: treBulkLoadBPTP
+ * Description:   Bulk load sorted keys into an empty paged B-plus tree.
+ * Parameters:
+ *       pbpt Pointer to an empty paged B-plus tree.
+ *      pkeys Pointer to an array of keys in ascending order without duplicates.
+ *        num Number of keys in the array.
+ * Return value:  true:  Succeeded.
+ *                false: I/O error or allocation failure. Keys that had been loaded stay in the tree.
+ * Caution:       Address of pbpt Must Be Allocated first and the tree shall be empty.
+ * Tip:           Pages are packed bottom up as function treBulkLoadBPT does.
+ *                Instead of queuing every node of a level, only the rightmost page of each level is kept,
+ *                so that loading takes memory for the buffer pool only.
+ */
+bool treBulkLoadBPTP(P_BPT_P pbpt, const void * pkeys, size_t num)
+{
+	size_t spine[_BPTP_MAX_HEIGHT], levels = 0;
+	REGISTER size_t f, i;
+	REGISTER PUCHAR pk = (PUCHAR)pkeys;
+	if (! SV_ASSERT(0 == pbpt->root))
+		return false;
+	if (0 == num)
+		return true;
+	if (_BPTP_NIL == (f = _treAllocPageBPTP(pbpt, _BPTP_LEAF)))
+		return false;
+	spine[0] = pbpt->pframe[f].page;
+	for (i = 0; i < num; ++i, pk += pbpt->size)
+	{
+		if (_BPTP_NUM(_BPTP_DATA(pbpt, f)) >= pbpt->degree)
+		{	/* The leaf is full. Start a new leaf and hang it up. */
+			REGISTER size_t fn;
+			if (_BPTP_NIL == (fn = _treAllocPageBPTP(pbpt, _BPTP_LEAF)))
+				break;
+			if (! _treHangPageBPTP(pbpt, spine, &levels, pk, pbpt->pframe[fn].page))
+			{
+				_treReleasePageBPTP(pbpt, pbpt->pframe[fn].page);
+				_BPTP_UNPIN(pbpt, fn);
+				break;
+			}
+			_BPTP_UNPIN(pbpt, f);
+			f = fn;
+		}
+		memcpy(_BPTP_KEY(pbpt, _BPTP_DATA(pbpt, f), _BPTP_NUM(_BPTP_DATA(pbpt, f))), pk, pbpt->size);
+		++_BPTP_NUM(_BPTP_DATA(pbpt, f));
+	}
+	_BPTP_UNPIN(pbpt, f);
+	pbpt->root = spine[levels];
+	pbpt->num  = i;
+	return i == num;
+}
+
+#undef _BPTP_MAX_HEIGHT
+#undef _BPTP_MIN_FRAMES
+#undef _BPTP_PAGE_SIZE
+#undef _BPTP_NIL
+#undef _BPTP_MAGIC
+#undef _BPTP_H_MAGIC
+#undef _BPTP_H_SIZE
+#undef _BPTP_H_PAGESIZE
+#undef _BPTP_H_ROOT
+#undef _BPTP_H_PAGES
+#undef _BPTP_H_FREE
+#undef _BPTP_H_GEN
+#undef _BPTP_H_NUM
+#undef _BPTP_H_FIELDS
+#undef _BPTP_LEAF
+#undef _BPTP_BRANCH
+#undef _BPTP_FREE
+#undef _BPTP_DATA
+#undef _BPTP_GEN
+#undef _BPTP_TYPE
+#undef _BPTP_NUM
+#undef _BPTP_HDR
+#undef _BPTP_KEYS
+#undef _BPTP_KEY
+#undef _BPTP_CHILDREN
+#undef _BPTP_FULL
+#undef _BPTP_UNPIN
+/* Undefine used macros for this section. */
+
+/* This following section is for B-plus trees that store string keys with prefix compression.
+ * Keys of a node are front coded in a byte area right after the node header.
+ * An entry holds the number of leading bytes that a key shares with its previous key,
+ * the number of the rest bytes and the rest bytes. The first entry shares nothing and holds a whole key.
+ * Keys of a node all begin with a prefix, the head of the first key, whose length is recorded in the header.
+ * Internal nodes hold the shortest separators that tell two leaves apart and their child pointers follow the byte area.
+ * Keys are compared byte by byte as unsigned chars, the same order as strcmp.
+ */
+
+/* Size of an entry header. Each length takes 2 bytes in big-endian. */
+#define _BPTS_HDR (4)
+#define _BPTS_GET2(p)    (((size_t)(p)[0] << 8) | (size_t)(p)[1])
+#define _BPTS_PUT2(p, v) ((p)[0] = (UCHART)((v) >> 8), (p)[1] = (UCHART)(v))
+
+/* Maximum height of a B-plus tree with string keys. */
+#define _BPTS_MAX_HEIGHT (CHAR_BIT * sizeof(size_t))
+
+/* The longest key that a tree accepts. Three entries of any length fit in a node. */
+#define _BPTS_MAX_KEY(pbpt) ((pbpt)->nodesize / 4 > 0xFFFF ? (size_t)0xFFFF : (pbpt)->nodesize / 4)
+
+/* Capacity of the byte area of the work node. It holds a full node and one more entry. */
+#define _BPTS_WORK_CAP(pbpt) ((pbpt)->nodesize + _BPTS_HDR + _BPTS_MAX_KEY(pbpt))
+
+/* Maximum number of children of a node whose byte area holds cap bytes.
+ * Every entry takes at least _BPTS_HDR + 1 bytes except the first one.
+ */
+#define _BPTS_FANOUT(cap) ((cap) / (_BPTS_HDR + 1) + 2)
+
+/* Macros that locate the byte area and children in a node. */
+#define _BPTS_AREA(pnode)          ((PUCHAR)(pnode) + ALIGN_SIZET(sizeof(BPTNODE_S)))
+#define _BPTS_CHILDREN(pnode, cap) ((P_BPTNODE_S *)(_BPTS_AREA(pnode) + ALIGN_SIZET(cap)))
+#define _BPTS_SPARE_LINK(pnode)    (*(P_BPTNODE_S *)_BPTS_AREA(pnode))
+
+/* Macros that locate parts of the work area. It holds 3 key buffers and a work node.
+ * Buffer 0 and 1 are used to rebuild nodes and buffer 2 holds a separator.
+ */
+#define _BPTS_KEYBUF(pbpt, i) ((pbpt)->pwork + (i) * ALIGN_SIZET(_BPTS_MAX_KEY(pbpt) + 1))
+#define _BPTS_WORK(pbpt)      ((P_BPTNODE_S)_BPTS_KEYBUF(pbpt, 3))
+#define _BPTS_WORK_SIZE(pbpt) ((size_t)(_BPTS_KEYBUF(pbpt, 3) - (pbpt)->pwork) + ALIGN_SIZET(sizeof(BPTNODE_S)) + \
+	ALIGN_SIZET(_BPTS_WORK_CAP(pbpt)) + _BPTS_FANOUT(_BPTS_WORK_CAP(pbpt)) * sizeof(P_BPTNODE_S))
+
+/* Index that no key in a node has. */
+#define _BPTS_NONE (~(size_t)0)
+
+/* File level function declarations. */
+size_t      _treCommonBPTS        (const UCHART * px,    size_t       xlen,  const UCHART * py,    size_t       ylen);
+size_t      _treScanBPTS          (P_BPTNODE_S    pnode, const UCHART * pkey, size_t       klen,  bool *       pfound);
+size_t      _treKeyAtBPTS         (P_BPTNODE_S    pnode, size_t       k,     PUCHAR         pbuf,  size_t *     pshared);
+void        _treBuildBPTS         (P_BPT_S        pbpt,  P_BPTNODE_S  pdst,  P_BPTNODE_S    psrc,  size_t       a,
+                                   size_t         b,     size_t       at,    const UCHART * pins,  size_t       inslen);
+size_t      _treSplitPointBPTS    (P_BPTNODE_S    pnode);
+P_BPTNODE_S _treCreateNodeBPTS    (P_BPT_S        pbpt,  bool         bleaf);
+bool        _treReserveBPTS       (P_BPT_S        pbpt,  size_t       num);
+P_BPTNODE_S _treTakeNodeBPTS      (P_BPT_S        pbpt,  bool         bleaf);
+void        _treFreeNodesBPTS     (P_BPT_S        pbpt,  P_BPTNODE_S  pnode);
+int         _treTraverseNodeBPTS  (P_BPT_S        pbpt,  P_BPTNODE_S  pnode, CBF_TRAVERSE   cbftvs, size_t      param);
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treCommonBPTS
+ * Description:   Measure the common prefix of two strings.
+ * Parameters:
+ *         px Pointer to a string.
+ *       xlen Length of px.
+ *         py Pointer to another string.
+ *       ylen Length of py.
+ * Return value:  Number of leading bytes that px and py share.
+ */
+size_t _treCommonBPTS(const UCHART * px, size_t xlen, const UCHART * py, size_t ylen)
+{
+	REGISTER size_t i, n = xlen < ylen ? xlen : ylen;
+	for (i = 0; i < n && px[i] == py[i]; ++i)
+		;
+	return i;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treScanBPTS
+ * Description:   Find the first key that is not less than a string in a node.
+ * Parameters:
+ *      pnode Pointer to a node.
+ *       pkey Pointer to the string.
+ *       klen Length of pkey.
+ *     pfound Pointer to a bool that receives whether the key found equals pkey.
+ * Return value:  Number of keys that are less than pkey.
+ * Tip:           The prefix of the node is compared only once. After that, function keeps the length of
+ *                the common prefix of pkey and the previous key. An entry that shares more with the previous key
+ *                must be less than pkey and an entry that shares less must be greater,
+ *                so that only entries that share exactly that many bytes are compared, from that byte on.
+ */
+size_t _treScanBPTS(P_BPTNODE_S pnode, const UCHART * pkey, size_t klen, bool * pfound)
+{
+	REGISTER PUCHAR pe = _BPTS_AREA(pnode), ps;
+	REGISTER size_t i, j, m, s, l, r;
+	*pfound = false;
+	if (0 == pnode->num)
+		return 0;
+	/* Compare the prefix of the node that is the head of the first key. */
+	m = _treCommonBPTS(pkey, klen, pe + _BPTS_HDR, pnode->plen);
+	if (m < pnode->plen)
+		return (m == klen || pkey[m] < pe[_BPTS_HDR + m]) ? 0 : pnode->num;
+	for (i = 0; i < pnode->num; ++i, pe += _BPTS_HDR + l)
+	{
+		l = _BPTS_GET2(pe + 2);
+		s = i > 0 ? _BPTS_GET2(pe) : m;
+		if (s > m)
+			continue;
+		if (s < m)
+			return i;
+		/* The entry shares exactly m bytes with pkey so far. Compare the rest. */
+		ps = pe + _BPTS_HDR + (i > 0 ? 0 : m);
+		r  = i > 0 ? l : l - m;
+		j  = _treCommonBPTS(pkey + m, klen - m, ps, r);
+		if (j == r)
+		{
+			if (m + j == klen)
+			{
+				*pfound = true;
+				return i;
+			}
+		}
+		else if (m + j == klen || pkey[m + j] < ps[j])
+			return i;
+		m += j;
+	}
+	return pnode->num;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treKeyAtBPTS
+ * Description:   Decode a key in a node.
+ * Parameters:
+ *      pnode Pointer to a node.
+ *          k Index of the key.
+ *       pbuf Pointer to a buffer that receives the key.
+ *    pshared Pointer to a size_t that receives the number of bytes the key shares with its previous key.
+ *            Input NULL if you do not need it.
+ * Return value:  Length of the key.
+ */
+size_t _treKeyAtBPTS(P_BPTNODE_S pnode, size_t k, PUCHAR pbuf, size_t * pshared)
+{
+	REGISTER PUCHAR pe = _BPTS_AREA(pnode);
+	REGISTER size_t i, s, l;
+	for (i = 0; ; ++i, pe += _BPTS_HDR + l)
+	{
+		s = _BPTS_GET2(pe);
+		l = _BPTS_GET2(pe + 2);
+		memcpy(pbuf + s, pe + _BPTS_HDR, l);
+		if (i == k)
+			break;
+	}
+	if (NULL != pshared)
+		*pshared = s;
+	return s + l;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treBuildBPTS
+ * Description:   Front code keys a to b - 1 of a node into another node.
+ * Parameters:
+ *       pbpt Pointer to a B-plus tree.
+ *       pdst Pointer to the node to build. Its former content would be dropped.
+ *       psrc Pointer to the source node. It could be pdst only if a equaled b.
+ *          a Index of the first source key.
+ *          b Index after the last source key.
+ *         at If pins were NULL, source key at would be dropped;
+ *            otherwise pins would be put before source key at.
+ *            Input _BPTS_NONE to copy keys only.
+ *       pins Pointer to a string to put in.
+ *     inslen Length of pins.
+ * Return value:  N/A.
+ * Caution:       Key buffer 0 and 1 are used.
+ */
+void _treBuildBPTS(P_BPT_S pbpt, P_BPTNODE_S pdst, P_BPTNODE_S psrc, size_t a, size_t b, size_t at, const UCHART * pins, size_t inslen)
+{
+	REGISTER PUCHAR pe = _BPTS_AREA(psrc), pout = _BPTS_AREA(pdst);
+	REGISTER const UCHART * pkey;
+	REGISTER size_t i, s, l, klen, num = 0;
+	const PUCHAR pcur = _BPTS_KEYBUF(pbpt, 0), pprev = _BPTS_KEYBUF(pbpt, 1);
+	size_t prevlen = 0, curlen = 0;
+	for (i = 0; ; ++i)
+	{
+		if (i == at && NULL != pins)
+		{
+			pkey = pins;
+			klen = inslen;
+			at   = _BPTS_NONE;
+			--i; /* Visit source key i on the next turn. */
+		}
+		else
+		{
+			if (i >= b)
+				break;
+			/* Decode source keys from the first one, because each key depends on its previous key. */
+			s = _BPTS_GET2(pe);
+			l = _BPTS_GET2(pe + 2);
+			memcpy(pcur + s, pe + _BPTS_HDR, l);
+			curlen = s + l;
+			pe += _BPTS_HDR + l;
+			if (i < a || i == at)
+				continue;
+			pkey = pcur;
+			klen = curlen;
+		}
+		s = num > 0 ? _treCommonBPTS(pprev, prevlen, pkey, klen) : 0;
+		_BPTS_PUT2(pout, s);
+		_BPTS_PUT2(pout + 2, klen - s);
+		memcpy(pout + _BPTS_HDR, pkey + s, klen - s);
+		memcpy(pprev + s, pkey + s, klen - s);
+		pout += _BPTS_HDR + klen - s;
+		prevlen = klen;
+		++num;
+	}
+	pdst->num  = num;
+	pdst->used = (size_t)(pout - _BPTS_AREA(pdst));
+	/* Keys are sorted, so the prefix that every key shares is the common prefix of the first key and the last key. */
+	pout = _BPTS_AREA(pdst);
+	pdst->plen = num > 0 ? _treCommonBPTS(pout + _BPTS_HDR, _BPTS_GET2(pout + 2), pprev, prevlen) : 0;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treSplitPointBPTS
+ * Description:   Choose a key that halves the bytes of an overflowing node.
+ * Parameter:
+ *      pnode Pointer to the node.
+ * Return value:  Index of the first key of the right half for a leaf,
+ *                or index of the separator that goes up for an internal node.
+ */
+size_t _treSplitPointBPTS(P_BPTNODE_S pnode)
+{
+	REGISTER PUCHAR pe = _BPTS_AREA(pnode);
+	REGISTER size_t k, bytes = 0, last = pnode->bleaf ? pnode->num - 1 : pnode->num - 2;
+	for (k = 0; k < last && bytes < (pnode->used >> 1); ++k)
+	{
+		bytes += _BPTS_HDR + _BPTS_GET2(pe + 2);
+		pe = _BPTS_AREA(pnode) + bytes;
+	}
+	return k > 0 ? k : 1;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treCreateNodeBPTS
+ * Description:   Allocate a node with its byte area and children in one block.
+ * Parameters:
+ *       pbpt Pointer to a B-plus tree.
+ *      bleaf Input true to create a leaf node.
+ * Return value:  Pointer to the new node. NULL indicates an allocation failure.
+ */
+P_BPTNODE_S _treCreateNodeBPTS(P_BPT_S pbpt, bool bleaf)
+{
+	REGISTER P_BPTNODE_S pnode;
+	REGISTER size_t bytes = ALIGN_SIZET(sizeof(BPTNODE_S)) + ALIGN_SIZET(pbpt->nodesize);
+	if (! bleaf) /* Leaves do not need child pointers. */
+		bytes += _BPTS_FANOUT(pbpt->nodesize) * sizeof(P_BPTNODE_S);
+	if (NULL != (pnode = (P_BPTNODE_S) malloc(bytes)))
+	{
+		pnode->num   = 0;
+		pnode->plen  = 0;
+		pnode->used  = 0;
+		pnode->bleaf = bleaf;
+	}
+	return pnode;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treReserveBPTS
+ * Description:   Keep a spare leaf and some spare internal nodes for splitting.
+ * Parameters:
+ *       pbpt Pointer to a B-plus tree.
+ *        num Number of spare internal nodes to keep.
+ * Return value:  true:  Succeeded.
+ *                false: Allocation failure. Nodes that have been allocated stay spare.
+ * Tip:           Spare nodes are kept after splitting, so that most inserts allocate nothing here.
+ */
+bool _treReserveBPTS(P_BPT_S pbpt, size_t num)
+{
+	REGISTER P_BPTNODE_S pnode;
+	REGISTER size_t i = 0;
+	if (NULL == pbpt->pspare[1])
+	{
+		if (NULL == (pnode = _treCreateNodeBPTS(pbpt, true)))
+			return false;
+		_BPTS_SPARE_LINK(pnode) = NULL;
+		pbpt->pspare[1] = pnode;
+	}
+	for (pnode = pbpt->pspare[0]; NULL != pnode && i < num; pnode = _BPTS_SPARE_LINK(pnode))
+		++i;
+	for (; i < num; ++i)
+	{
+		if (NULL == (pnode = _treCreateNodeBPTS(pbpt, false)))
+			return false;
+		_BPTS_SPARE_LINK(pnode) = pbpt->pspare[0];
+		pbpt->pspare[0] = pnode;
+	}
+	return true;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treTakeNodeBPTS
+ * Description:   Take a node that function _treReserveBPTS kept.
+ * Parameters:
+ *       pbpt Pointer to a B-plus tree.
+ *      bleaf Input true to take a leaf.
+ * Return value:  Pointer to the node.
+ */
+P_BPTNODE_S _treTakeNodeBPTS(P_BPT_S pbpt, bool bleaf)
+{
+	REGISTER P_BPTNODE_S pnode = pbpt->pspare[bleaf];
+	pbpt->pspare[bleaf] = _BPTS_SPARE_LINK(pnode);
+	pnode->bleaf = bleaf;
+	return pnode;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treFreeNodesBPTS
+ * Description:   Free a node and all its descendants.
+ * Parameters:
+ *       pbpt Pointer to a B-plus tree.
+ *      pnode Pointer to a node.
+ * Return value:  N/A.
+ */
+void _treFreeNodesBPTS(P_BPT_S pbpt, P_BPTNODE_S pnode)
+{
+	if (! pnode->bleaf)
+	{
+		REGISTER size_t i;
+		for (i = 0; i <= pnode->num; ++i)
+			_treFreeNodesBPTS(pbpt, _BPTS_CHILDREN(pnode, pbpt->nodesize)[i]);
+	}
+	free(pnode);
+}
+
+/* Function name: treInitBPTS
+ * Description:   Initialize a B-plus tree that stores string keys with prefix compression.
+ * Parameters:
+ *       pbpt Pointer to the B-plus tree you want to initialize.
+ *   nodesize Number of bytes that keys of a node occupy at most. It would be raised to 64 if it were less than 64.
+ *            Input 0 to use BPTS_NODE_BYTES.
+ *            Keys longer than a quarter of nodesize or 65535 bytes could not be inserted.
+ * Return value:  N/A.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ */
+void treInitBPTS(P_BPT_S pbpt, size_t nodesize)
+{
+	if (0 == nodesize)
+		nodesize = BPTS_NODE_BYTES;
+	pbpt->proot     = NULL;
+	pbpt->nodesize  = nodesize < 64 ? 64 : nodesize;
+	pbpt->num       = 0;
+	pbpt->pspare[0] = NULL;
+	pbpt->pspare[1] = NULL;
+	pbpt->pwork     = NULL;
+}
+
+/* Function name: treFreeBPTS
+ * Description:   Retract a B-plus tree which is allocated by function treInitBPTS.
+ * Parameter:
+ *      pbpt Pointer to the B-plus tree you want to release.
+ * Return value:  N/A.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ */
+void treFreeBPTS(P_BPT_S pbpt)
+{
+	REGISTER P_BPTNODE_S pnode;
+	REGISTER int i;
+	if (NULL != pbpt->proot)
+		_treFreeNodesBPTS(pbpt, pbpt->proot);
+	pbpt->proot = NULL;
+	pbpt->num = 0;
+	for (i = 0; i < 2; ++i)
+	{
+		while (NULL != (pnode = pbpt->pspare[i]))
+		{
+			pbpt->pspare[i] = _BPTS_SPARE_LINK(pnode);
+			free(pnode);
+		}
+	}
+	if (NULL != pbpt->pwork)
+		free(pbpt->pwork);
+	pbpt->pwork = NULL;
+}
+
+/* Function name: treCreateBPTS
+ * Description:   Dynamically allocate a B-plus tree that stores string keys with prefix compression.
+ * Parameter:
+ *   nodesize Number of bytes that keys of a node occupy at most. Input 0 to use BPTS_NODE_BYTES.
+ * Return value:  Pointer to the new allocated tree.
+ *                If function could not create a structure, it would return NULL.
+ */
+P_BPT_S treCreateBPTS(size_t nodesize)
+{
+	REGISTER P_BPT_S pbpt = (P_BPT_S) malloc(sizeof(BPT_S));
+	if (NULL != pbpt)
+		treInitBPTS(pbpt, nodesize);
+	return pbpt;
+}
+
+/* Function name: treDeleteBPTS
+ * Description:   Retract a B-plus tree which is allocated by function treCreateBPTS.
+ * Parameter:
+ *      pbpt Pointer to the tree you want to release.
+ * Return value:  N/A.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ */
+void treDeleteBPTS(P_BPT_S pbpt)
+{
+	treFreeBPTS(pbpt);
+	free(pbpt);
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treTraverseNodeBPTS
+ * Description:   Traverse keys under a node in ascending order.
+ * Parameters:
+ *       pbpt Pointer to the B-plus tree.
+ *      pnode Pointer to a node.
+ *     cbftvs Pointer to a callback function to traverse.
+ *      param A size_t value which can be transferred into callback function.
+ * Return value:  The same value as callback function returns.
+ */
+int _treTraverseNodeBPTS(P_BPT_S pbpt, P_BPTNODE_S pnode, CBF_TRAVERSE cbftvs, size_t param)
+{
+	REGISTER size_t i, s, l, len;
+	if (pnode->bleaf)
+	{
+		REGISTER PUCHAR pe = _BPTS_AREA(pnode), pkey = _BPTS_KEYBUF(pbpt, 0);
+		for (i = 0; i < pnode->num; ++i, pe += _BPTS_HDR + l)
+		{
+			s = _BPTS_GET2(pe);
+			l = _BPTS_GET2(pe + 2);
+			memcpy(pkey + s, pe + _BPTS_HDR, l);
+			len = s + l;
+			pkey[len] = '\0'; /* The next key would overwrite the terminator if it needed the byte. */
+			if (CBF_CONTINUE != cbftvs(pkey, param))
+				return CBF_TERMINATE;
+		}
+	}
+	else
+	{
+		for (i = 0; i <= pnode->num; ++i)
+			if (CBF_CONTINUE != _treTraverseNodeBPTS(pbpt, _BPTS_CHILDREN(pnode, pbpt->nodesize)[i], cbftvs, param))
+				return CBF_TERMINATE;
+	}
+	return CBF_CONTINUE;
+}
+
+/* Function name: treTraverseKeyBPTS
+ * Description:   Traverse each key in ascending order.
+ * Parameters:
+ *       pbpt Pointer to the B-plus tree.
+ *     cbftvs Pointer to a callback function to traverse.
+ *            Parameter pitem of callback function points to a decoded copy of a key that ends with '\0'.
+ *      param A size_t value which can be transferred into callback function.
+ * Return value:  The same value as callback function returns.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ *                Do not insert keys into or remove keys from the tree in callback function.
+ */
+int treTraverseKeyBPTS(P_BPT_S pbpt, CBF_TRAVERSE cbftvs, size_t param)
+{
+	if (NULL == pbpt->proot)
+		return CBF_CONTINUE;
+	return _treTraverseNodeBPTS(pbpt, pbpt->proot, cbftvs, param);
+}
+
+/* Function name: treSearchBPTS
+ * Description:   Search a string in a B-plus tree with string keys.
+ * Parameters:
+ *       pbpt Pointer to the B-plus tree.
+ *       pstr Pointer to the string to search.
+ * Return value:  true:  pstr is in the tree.
+ *                false: Cannot find pstr.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ */
+bool treSearchBPTS(P_BPT_S pbpt, const char * pstr)
+{
+	REGISTER P_BPTNODE_S pnode = pbpt->proot;
+	REGISTER size_t i, klen = strlen(pstr);
+	bool bfound;
+	if (NULL == pnode)
+		return false;
+	while (! pnode->bleaf)
+	{
+		i = _treScanBPTS(pnode, (const UCHART *) pstr, klen, &bfound);
+		pnode = _BPTS_CHILDREN(pnode, pbpt->nodesize)[i + bfound];
+	}
+	DISUSE(_treScanBPTS(pnode, (const UCHART *) pstr, klen, &bfound));
+	return bfound;
+}
+
+/* Function name: treInsertBPTS
+ * Description:   Insert a string into a B-plus tree with string keys.
+ * Parameters:
+ *       pbpt Pointer to the B-plus tree.
+ *       pstr Pointer to the string to insert. The tree keeps a copy of it.
+ * Return value:  true:  Succeeded or pstr has already been in the tree.
+ *                false: pstr is too long, or allocation failure. The tree would not be altered.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ * Tip:           A split leaf sends up the shortest head of its right half
+ *                that is still greater than the last key of its left half.
+ * Usage:         BPT_S bpt;
+ *                treInitBPTS(&bpt, 0);
+ *                treInsertBPTS(&bpt, "https://example.com/a");
+ *                if (treSearchBPTS(&bpt, "https://example.com/a")) ...
+ *                treFreeBPTS(&bpt);
+ */
+bool treInsertBPTS(P_BPT_S pbpt, const char * pstr)
+{
+	P_BPTNODE_S path[_BPTS_MAX_HEIGHT];
+	size_t pos[_BPTS_MAX_HEIGHT];
+	REGISTER P_BPTNODE_S pnode = pbpt->proot, pwork, pright;
+	REGISTER size_t i, k, depth = 0;
+	const UCHART * pkey = (const UCHART *) pstr;
+	const size_t klen = strlen(pstr);
+	size_t seplen, s;
+	PUCHAR psep;
+	bool bfound;
+	if (klen > _BPTS_MAX_KEY(pbpt))
+		return false;
+	if (NULL == pbpt->pwork && NULL == (pbpt->pwork = (PUCHAR) malloc(_BPTS_WORK_SIZE(pbpt))))
+		return false;
+	if (NULL == pnode)
+	{
+		if (NULL == (pnode = _treCreateNodeBPTS(pbpt, true)))
+			return false;
+		_treBuildBPTS(pbpt, pnode, pnode, 0, 0, 0, pkey, klen);
+		pbpt->proot = pnode;
+		pbpt->num = 1;
+		return true;
+	}
+	/* Descend and record the path. */
+	while (! pnode->bleaf)
+	{
+		path[depth] = pnode;
+		i = _treScanBPTS(pnode, pkey, klen, &bfound);
+		pos[depth] = i + bfound;
+		pnode = _BPTS_CHILDREN(pnode, pbpt->nodesize)[pos[depth++]];
+	}
+	i = _treScanBPTS(pnode, pkey, klen, &bfound);
+	if (bfound)
+		return true;
+	/* Rebuild the leaf with the new key in the work node. */
+	pwork = _BPTS_WORK(pbpt);
+	pwork->bleaf = true;
+	_treBuildBPTS(pbpt, pwork, pnode, 0, pnode->num, i, pkey, klen);
+	if (pwork->used <= pbpt->nodesize)
+	{
+		memcpy(pnode, pwork, ALIGN_SIZET(sizeof(BPTNODE_S)) + pwork->used);
+		++pbpt->num;
+		return true;
+	}
+	/* Keep every node that splitting needs in advance, so that a failure leaves the tree intact. */
+	if (! _treReserveBPTS(pbpt, depth + 1))
+		return false;
+	/* Split the leaf. */
+	k = _treSplitPointBPTS(pwork);
+	pright = _treTakeNodeBPTS(pbpt, true);
+	_treBuildBPTS(pbpt, pright, pwork, k, pwork->num, _BPTS_NONE, NULL, 0);
+	_treBuildBPTS(pbpt, pnode, pwork, 0, k, _BPTS_NONE, NULL, 0);
+	psep = _BPTS_KEYBUF(pbpt, 2);
+	DISUSE(_treKeyAtBPTS(pwork, k, psep, &s));
+	seplen = s + 1;
+	while (depth > 0)
+	{
+		REGISTER P_BPTNODE_S pparent = path[--depth];
+		REGISTER P_BPTNODE_S * ppc = _BPTS_CHILDREN(pparent, pbpt->nodesize);
+		REGISTER P_BPTNODE_S * ppw = _BPTS_CHILDREN(pwork, _BPTS_WORK_CAP(pbpt));
+		k = pos[depth];
+		pwork->bleaf = false;
+		_treBuildBPTS(pbpt, pwork, pparent, 0, pparent->num, k, psep, seplen);
+		memcpy(ppw, ppc, (k + 1) * sizeof(P_BPTNODE_S));
+		ppw[k + 1] = pright;
+		memcpy(ppw + k + 2, ppc + k + 1, (pparent->num - k) * sizeof(P_BPTNODE_S));
+		if (pwork->used <= pbpt->nodesize)
+		{
+			memcpy(pparent, pwork, ALIGN_SIZET(sizeof(BPTNODE_S)) + pwork->used);
+			memcpy(ppc, ppw, (pwork->num + 1) * sizeof(P_BPTNODE_S));
+			++pbpt->num;
+			return true;
+		}
+		/* Split an internal node. The middle separator goes up and leaves both halves. */
+		k = _treSplitPointBPTS(pwork);
+		pright = _treTakeNodeBPTS(pbpt, false);
+		_treBuildBPTS(pbpt, pright, pwork, k + 1, pwork->num, _BPTS_NONE, NULL, 0);
+		memcpy(_BPTS_CHILDREN(pright, pbpt->nodesize), ppw + k + 1, (pwork->num - k) * sizeof(P_BPTNODE_S));
+		_treBuildBPTS(pbpt, pparent, pwork, 0, k, _BPTS_NONE, NULL, 0);
+		memcpy(ppc, ppw, (k + 1) * sizeof(P_BPTNODE_S));
+		seplen = _treKeyAtBPTS(pwork, k, psep, NULL);
+	}
+	/* Grow a new root. */
+	pnode = _treTakeNodeBPTS(pbpt, false);
+	_treBuildBPTS(pbpt, pnode, pnode, 0, 0, 0, psep, seplen);
+	_BPTS_CHILDREN(pnode, pbpt->nodesize)[0] = pbpt->proot;
+	_BPTS_CHILDREN(pnode, pbpt->nodesize)[1] = pright;
+	pbpt->proot = pnode;
+	++pbpt->num;
+	return true;
+}
+
+/* Function name: treRemoveBPTS
+ * Description:   Remove a string from a B-plus tree with string keys.
+ * Parameters:
+ *       pbpt Pointer to the B-plus tree.
+ *       pstr Pointer to the string to remove.
+ * Return value:  true:  pstr has been removed.
+ *                false: Cannot find pstr.
+ * Caution:       Address of pbpt Must Be Allocated first.
+ * Tip:           Nodes are not merged. A node would be freed when it became empty.
+ *                Removing a key never makes a node longer, so that removal needs no allocation.
+ */
+bool treRemoveBPTS(P_BPT_S pbpt, const char * pstr)
+{
+	P_BPTNODE_S path[_BPTS_MAX_HEIGHT];
+	size_t pos[_BPTS_MAX_HEIGHT];
+	REGISTER P_BPTNODE_S pnode = pbpt->proot, pwork;
+	REGISTER size_t i, depth = 0;
+	const UCHART * pkey = (const UCHART *) pstr;
+	const size_t klen = strlen(pstr);
+	bool bfound;
+	if (NULL == pnode)
+		return false;
+	while (! pnode->bleaf)
+	{
+		path[depth] = pnode;
+		i = _treScanBPTS(pnode, pkey, klen, &bfound);
+		pos[depth] = i + bfound;
+		pnode = _BPTS_CHILDREN(pnode, pbpt->nodesize)[pos[depth++]];
+	}
+	i = _treScanBPTS(pnode, pkey, klen, &bfound);
+	if (! bfound)
+		return false;
+	pwork = _BPTS_WORK(pbpt);
+	pwork->bleaf = true;
+	_treBuildBPTS(pbpt, pwork, pnode, 0, pnode->num, i, NULL, 0);
+	memcpy(pnode, pwork, ALIGN_SIZET(sizeof(BPTNODE_S)) + pwork->used);
+	--pbpt->num;
+	if (pnode->num > 0)
+		return true;
+	/* Free the empty leaf and every ancestor that is left without children,
+	 * then unlink the empty branch from the lowest ancestor that has other children.
+	 */
+	for (;;)
+	{
+		REGISTER P_BPTNODE_S pparent;
+		REGISTER P_BPTNODE_S * ppc;
+		REGISTER size_t k;
+		free(pnode);
+		if (0 == depth)
+		{
+			pbpt->proot = NULL;
+			return true;
+		}
+		pparent = path[--depth];
+		if (0 == pparent->num)
+		{
+			pnode = pparent;
+			continue;
+		}
+		k = pos[depth];
+		ppc = _BPTS_CHILDREN(pparent, pbpt->nodesize);
+		pwork->bleaf = false;
+		_treBuildBPTS(pbpt, pwork, pparent, 0, pparent->num, k > 0 ? k - 1 : 0, NULL, 0);
+		memmove(ppc + k, ppc + k + 1, (pparent->num - k) * sizeof(P_BPTNODE_S));
+		memcpy(pparent, pwork, ALIGN_SIZET(sizeof(BPTNODE_S)) + pwork->used);
+		break;
+	}
+	/* Shrink the tree while the root has only one child. */
+	while (! (pnode = pbpt->proot)->bleaf && 0 == pnode->num)
+	{
+		pbpt->proot = _BPTS_CHILDREN(pnode, pbpt->nodesize)[0];
+		free(pnode);
+	}
+	return true;
+}
+
+#undef _BPTS_HDR
+#undef _BPTS_GET2
+#undef _BPTS_PUT2
+#undef _BPTS_MAX_HEIGHT
+#undef _BPTS_MAX_KEY
+#undef _BPTS_WORK_CAP
+#undef _BPTS_FANOUT
+#undef _BPTS_AREA
+#undef _BPTS_CHILDREN
+#undef _BPTS_SPARE_LINK
+#undef _BPTS_KEYBUF
+#undef _BPTS_WORK
+#undef _BPTS_WORK_SIZE
+#undef _BPTS_NONE
+/* Undefine used macros for this section. */
+
+/* Functions that implemented tries are listed here. */
+#include "svstack.h"
+
+/* A macro used to calculate the length of an element in a trie's array. */
+#define _ELESIZ(size) (ALIGN_SIZET(size) + sizeof(TRIE_A) + sizeof(size_t) + sizeof(size_t) + sizeof(size_t))
+/**                                ^              ^                ^                ^                ^
+ * An element consists of: --------data--------next_trie---reference_counter--------appendix---------flag.
+ * We make the flag sign as size_t to further align structure to a suitable size.
+ */
+
+/* Modes of walking a trie. */
+#define _TRIE_WALK_ALL  (0) /* Report every string. */
+#define _TRIE_WALK_RANK (1) /* Rank appendixes of strings without reporting. */
+#define _TRIE_WALK_TOP  (2) /* Report strings whose appendixes are ranked in top k. */
+
+/* State of walking a trie. */
+typedef struct _st_TRIEWALK {
+	ARRAY_Z      path;   /* Elements of the current string. */
+	size_t       size;   /* Size of each element. */
+	size_t       limit;  /* Maximum number of strings to report. 0 means no limit. */
+	size_t       count;  /* Number of strings reported. */
+	size_t       bound;  /* The least appendix in top k. */
+	size_t       ties;   /* Number of strings whose appendixes equal bound that are still to report. */
+	int          mode;   /* Mode of walking. */
+	P_HEAP_A     pheap;  /* A min heap that ranks appendixes. */
+	CBF_TRAVERSE cbftvs; /* Callback function that receives strings. */
+	size_t       param;  /* Parameter of cbftvs. */
+} _TRIEWALK, * _P_TRIEWALK;
+
+/* State of searching strings within an edit distance in a trie. */
+typedef struct _st_TRIEFUZZY {
+	ARRAY_Z      path;   /* Elements of the current string. */
+	ARRAY_Z      rows;   /* Rows of edit distances. A row for each element in path and a row for the empty string. */
+	PUCHAR       pstr;   /* The queried string. */
+	size_t       num;    /* Number of elements in pstr. */
+	size_t       size;   /* Size of each element. */
+	size_t       bound;  /* Maximum edit distance. */
+	size_t       count;  /* Number of strings reported. */
+	CBF_COMPARE  cbfcmp; /* Callback function that compares elements. */
+	CBF_TRAVERSE cbftvs; /* Callback function that receives strings. */
+	size_t       param;  /* Parameter of cbftvs. */
+} _TRIEFUZZY, * _P_TRIEFUZZY;
+
+/* File level function declarations. */
+void   _treFreeTrieNode       (P_TRIE_A    ptrie, size_t       size);
+PUCHAR _treSeekElementTrieA   (P_TRIE_A    ptrie, const void * pstr,   size_t      num,   size_t size, CBF_COMPARE cbfcmp);
+bool   _treReservePathTrieA   (_P_TRIEWALK pw,    size_t       num);
+int    _treReportTrieA        (_P_TRIEWALK pw,    size_t       vapdx,  size_t      num);
+int    _treWalkTrieA          (_P_TRIEWALK pw,    TRIE_A       trie,   size_t      depth);
+void   _treStartWalkTrieA     (_P_TRIEWALK pw,    P_TRIE_A     ptrie,  const void * pstr, size_t num, CBF_COMPARE cbfcmp);
+int    _treFuzzySearchTrieA   (_P_TRIEFUZZY pf,   TRIE_A       trie,   size_t      depth);
+size_t _treSizeFlatTrieA      (TRIE_A      trie,  size_t       size);
+size_t _treFlattenNodeTrieA   (TRIE_A      trie,  size_t       size,   PUCHAR      pbuf,  size_t * ppos);
+
+/* Function name: treInitTrieA_O
+ * Description:   Initialize an array implemented trie.
+ * Parameters:
+ *      ptrie Pointer to a trie you want to initialize.
+ * Return value:  N/A.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ * Tip:           A macro version of this function named treInitTrieA_M is available.
+ */
+void treInitTrieA_O(P_TRIE_A ptrie)
+{
+	*ptrie = NULL;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treFreeTrieNode
+ * Description:   This function is used to free array implemented nodes in a trie.
+ * Parameters:
+ *      ptrie Pointer to a trie you want to release.
+ *       size Size of an element in the string which had been inserted into trie before.
+ * Return value:  N/A.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ *                Size shall not equal to 0.
+ */
+void _treFreeTrieNode(P_TRIE_A ptrie, size_t size)
+{
+	if (NULL != *ptrie)
+	{
+		REGISTER size_t i;
+		REGISTER PUCHAR pdat = (*ptrie)->pdata;
+		for (i = 0; i < strLevelArrayZ(*ptrie); ++i, pdat += _ELESIZ(size))
+		{
+			P_TRIE_A pt = (P_TRIE_A) (pdat + size);
+			if (NULL != *pt)
+				_treFreeTrieNode(pt, size);
+		}
+		strDeleteArrayZ(*ptrie);
+	}
+}
+
+/* Function name: treFreeTrieA_O
+ * Description:   Retract a trie which is allocated by function treInitTrieA_O.
+ * Parameters:
+ *      ptrie Pointer to a trie you want to release.
+ *       size Size of an element in the string which had been inserted into trie before.
+ * Return value:  N/A.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ *                Size shall not equal to 0.
+ * Tip:           A macro version of this function named treFreeTrieA_M is available.
+ */
+void treFreeTrieA_O(P_TRIE_A ptrie, size_t size)
+{
+	_treFreeTrieNode(ptrie, size);
+	*ptrie = NULL;
+}
+
+/* Function name: treCreateTrieA
+ * Description:   Allocate a new array implemented trie dynamically.
+ * Parameters:    N/A.
+ * Return value:  Pointer to the new allocated trie.
+ */
+P_TRIE_A treCreateTrieA(void)
+{
+	REGISTER P_TRIE_A ptrie = (P_TRIE_A) malloc(sizeof(TRIE_A));
+	if (NULL != ptrie)
+		treInitTrieA(ptrie);
+	return ptrie;
+}
+
+/* Function name: treDeleteTrieA_O
+ * Description:   Delete a trie which is allocated by function treCreateTrieA.
+ * Parameters:
+ *      ptrie Pointer to a trie you want to allocate.
+ *       size Size of an element in the string which had been inserted into trie before.
+ * Return value:  N/A.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ *                Size shall not equal to 0.
+ * Tip:           A macro version of this function named treDeleteTrieA_M is available.
+ */
+void treDeleteTrieA_O(P_TRIE_A ptrie, size_t size)
+{
+	_treFreeTrieNode(ptrie, size);
+	free(ptrie);
+}
+
+/* Function name: treSearchTrieA
+ * Description:   Search a string in a trie.
+ * Parameters:
+ *      ptrie Pointer to a trie of which you want to operate on.
+ *       pstr Pointer to the first element to a string and cast it into (const void *).
+ *        num Number of elements in the string.
+ *       size Size of each element in the string.
+ *     cbfcmp Pointer to a callback comparison function.
+ *            Two parameters of this callback function may point to any element in the string and in the trie.
+ *            Please refer to the prototype of callback function CBF_COMPARE in file svdef.h.
+ * Return value:  Pointer to the value that contains vapdx stored in a trie.
+ *                If this function returned value NULL, it should indicate that the string pstr pointed cannot be found in trie.
+ * Caution:       ptrie must be allocated first.
+ * Tip:           The following codes may give you an example for the usage of tries:
+ *                const char ptip[] = "lynx"; size_t apdx = (size_t)ptip; P_TRIE_A pt = treCreateTrieA();
+ *                treInsertTrieA(pt, "cat", strlen("cat"), sizeof(char), apdx, cbfcmp);
+ *                apdx = *treSearchTrieA(pt, "cat", strlen("cat"), sizeof(char), cbfcmp);
+ *                printf("%s\n", (const char *)apdx); treDeleteTrieA(pt, sizeof(char));
+ */
+size_t * treSearchTrieA(P_TRIE_A ptrie, const void * pstr, size_t num, size_t size, CBF_COMPARE cbfcmp)
+{
+	if (SV_ASSERT(0 != num && 0 != size))
+	{
+		REGISTER PUCHAR pbase = (PUCHAR) pstr;
+		while (NULL != *ptrie && 0 != num)
+		{
+			REGISTER PUCHAR pdat;
+			if (NULL == (pdat = (PUCHAR) strBinarySearchArrayZ(*ptrie, pbase, _ELESIZ(size), cbfcmp)))
+				return NULL;
+			ptrie = (P_TRIE_A) &pdat[size];
+			--num;
+			pbase += size;
+		}
+		if (0 == num) /* Searching reaches at the end of string. */
+			if (BOOLIZE(*((size_t *) &(sizeof(TRIE_A) + sizeof(size_t) + sizeof(size_t))[(PUCHAR) ptrie])))
+				return ((size_t *) &(sizeof(TRIE_A) + sizeof(size_t))[(PUCHAR) ptrie]);
+	}
+	return NULL;
+}
+
+/* Function name: treInsertTrieA
+ * Description:   Insert a string into a trie.
+ * Parameters:
+ *      ptrie Pointer to a trie of which you want to operate on.
+ *       pstr Pointer to the first element to a string and cast the pointer into (const void *).
+ *        num Number of elements in the string.
+ *       size Size of each element in the string.
+ *      vapdx An integer in size_t as an appendix that can store a pointer in a trie.
+ *            You may get a pointer to the value that contains vapdx stored in a trie after calling function treSearchTrieA.
+ *     cbfcmp Pointer to a callback comparison function.
+ *            Two parameters of this callback function may point to any element in the string and in the trie.
+ *            Please refer to the prototype of callback function CBF_COMPARE in file svdef.h.
+ * Return value:  true  Insertion succeeded.
+ *                false Insertion failed.
+ * Caution:       ptrie must be allocated first.
+ *                Value vapdx that stored with a string in trie will be replaced if users insert the same string repeatedly.
+ * Tip:           Inserting the same string in multiple times is allowed for this trie implementation;
+ *                Then deletion of the same string needs to be perform on the same trie in the same times.
+ */
+bool treInsertTrieA(P_TRIE_A ptrie, const void * pstr, size_t num, size_t size, size_t vapdx, CBF_COMPARE cbfcmp)
+{
+	REGISTER size_t j;
+	REGISTER PUCHAR pdat;
+	REGISTER PUCHAR pbase = (PUCHAR) pstr;
+	for (j = 0; j < num; ++j, pbase += size, ptrie = (P_TRIE_A) &pdat[size])
+	{
+		if (NULL != *ptrie)
+		{
+			if (NULL != (pdat = (PUCHAR) strBinarySearchArrayZ(*ptrie, pbase, _ELESIZ(size), cbfcmp)))
+			{
+				++ *(size_t *) &pdat[size + sizeof(TRIE_A)]; /* Increase reference counter. */
+				continue; /* Found, then search the next element in string. */
+			}
+			else
+			{	/* Find the maximal value that is less than (*pbase) to index i.
+				 * This procedure would reduce the worst case of searching complexity to approximately O(log n),
+				 * but not restrict to the worst case of O(n) by using linear search.
+				 */
+				REGISTER PUCHAR p = (PUCHAR)svBinarySearchDispatch
+				(
+					pbase,
+					(*ptrie)->pdata,
+					strLevelArrayZ(*ptrie),
+					_ELESIZ(size),
+					cbfcmp,
+					EBS_LAST_LESS_THAN_OR_EQUAL_TO_KEY
+				);
+				REGISTER size_t i = NULL == p ? 0 : (size_t)svIndexOf((*ptrie)->pdata, p, _ELESIZ(size)) + 1;
+				if (NULL == strResizeArrayZ(*ptrie, strLevelArrayZ(*ptrie) + 1, _ELESIZ(size)))
+					return false; /* Allocation failure. */
+				else
+				{	/* Insert new item. */
+					pdat = (PUCHAR)memcpy
+					(	/* Leave spaces to the new element. */
+						(PUCHAR)memmove
+						(
+							(*ptrie)->pdata + (i + 1) * _ELESIZ(size),
+							(*ptrie)->pdata + i * _ELESIZ(size),
+							(strLevelArrayZ(*ptrie) - 1 - i) * _ELESIZ(size)
+						) - _ELESIZ(size),
+						pbase,
+						size
+					);
+				}
+			}
+		}
+		else
+		{
+			if (NULL == (*ptrie = strCreateArrayZ(1, _ELESIZ(size))))
+				return false; /* Allocation failure. */
+			else
+				pdat = (PUCHAR) memcpy((*ptrie)->pdata, pbase, size);
+		}
+		/* Initialize new block. */
+		*(P_TRIE_A)  &pdat[size] = NULL; /* pnext. */
+		*(size_t *)  &pdat[size + sizeof(TRIE_A)] = 1; /* Reference counter. */
+		*((size_t *) &pdat[size + sizeof(TRIE_A) + sizeof(size_t)]) = 0; /* Appendix. */
+		*((size_t *) &pdat[size + sizeof(TRIE_A) + sizeof(size_t) + sizeof(size_t)]) = false; /* Flag. */
+	}
+	/* Bypass reference counter and assign appendix onto the right position. */
+	*((size_t *) &(sizeof(TRIE_A) + sizeof(size_t))[(PUCHAR) ptrie]) = vapdx;
+	/* Set the flag on the tail of string in trie into valid. */
+	*((size_t *) &(sizeof(TRIE_A) + sizeof(size_t) + sizeof(size_t))[(PUCHAR) ptrie]) = true;
+	return true;
+}
+
+/* Function name: treRemoveTrieA
+ * Description:   Remove a string from a trie.
+ * Parameters:
+ *      ptrie Pointer to a trie that you want to operate on.
+ *       pstr Pointer to the first element to a string and cast the pointer into (const void *).
+ *        num Number of elements in the string.
+ *       size Size of each element in the string.
+ *     cbfcmp Pointer to a callback comparison function.
+ *            Two parameters of this callback function may point to any element in the string and in the trie.
+ *            Please refer to the prototype of callback function CBF_COMPARE in file svdef.h.
+ * Return value:  true  Removal succeeded.
+ *                false Removal failed.
+ * Caution:       ptrie must be allocated first.
+ */
+bool treRemoveTrieA(P_TRIE_A ptrie, const void * pstr, size_t num, size_t size, CBF_COMPARE cbfcmp)
+{
+	bool r = false;
+	P_STACK_L pstk; /* Stores every data to be erased. */
+	const P_TRIE_A pot = ptrie; /* Stores the original header of trie. */
+	REGISTER PUCHAR pbase = (PUCHAR) pstr;
+	/* In the following structure, pdat is the pointer that leads data in array (*trie). */
+	struct { TRIE_A trie; PUCHAR pdat; } eleset;
+	if ((0 == num || 0 == size) || NULL == (pstk = stkCreateL()))
+		return false; /* Allocation failure. */
+	/* Traverse trie to pick elements that to be deleted into a stack. */
+	while (NULL != *ptrie && 0 != num)
+	{
+		REGISTER PUCHAR pdat = (PUCHAR) strBinarySearchArrayZ(*ptrie, pbase, _ELESIZ(size), cbfcmp);
+		if (NULL == pdat)
+			goto Lbl_Clear;
+		else
+		{
+			eleset.trie = *ptrie;
+			eleset.pdat = pdat;
+			if (NULL == stkPushL(pstk, &eleset, sizeof(eleset)))
+				goto Lbl_Clear;
+		}
+		ptrie = (P_TRIE_A) &pdat[size];
+		--num;
+		pbase += size;
+	}
+	if (0 == num)
+	{
+		size_t * pflag = ((size_t *) &(sizeof(TRIE_A) + sizeof(size_t) + sizeof(size_t))[(PUCHAR) ptrie]);
+		if (! (*pflag)) /* Avoid to delete a found sub string. false == *pflag */
+			goto Lbl_Clear;
+		else
+		{
+			REGISTER TRIE_A tprev = NULL; /* Previous trie record. */
+			if (*((size_t *) &(sizeof(TRIE_A))[(PUCHAR) ptrie]) < 2)
+				*pflag = false; /* Unflag. */
+			while (! stkIsEmptyL(pstk))
+			{	/* Pop elements to be deleted one by one that previously collected in the stack. */
+				stkPopL(&eleset, sizeof(eleset), pstk);
+				/* Erase the previous child pointer in parent node. */
+				if (NULL != tprev)
+				{
+					*(P_TRIE_A)&eleset.pdat[size] = NULL;
+					tprev = NULL;
+				}
+				/* Pick an element in array away by reducing reference counter. */
+				if (0 == --*(size_t *)&eleset.pdat[size + sizeof(TRIE_A)])
+				{
+					strRemoveItemArrayZ
+					(
+						eleset.trie,
+						_ELESIZ(size),
+						(size_t)svIndexOf(eleset.trie->pdata, eleset.pdat, _ELESIZ(size)),
+						true
+					);
+					/* If there are not exist elements in the set, then remove array entity either. */
+					if (0 == strLevelArrayZ(eleset.trie))
+					{
+						tprev = eleset.trie; /* Save a deleted pointer and remove it in its parent later. */
+						strDeleteArrayZ(eleset.trie);
+						if (*pot == tprev)
+							*pot = NULL; /* Removal reaches at the root of trie. */
+					}
+				}
+			}
+			r = true;
+		}
+	}
+Lbl_Clear:
+	stkDeleteL(pstk);
+	return r;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treSeekElementTrieA
+ * Description:   Find the element of the last element of a string in a trie.
+ * Parameters:
+ *      ptrie Pointer to a trie.
+ *       pstr Pointer to the first element to a string.
+ *        num Number of elements in the string. It shall be greater than 0.
+ *       size Size of each element in the string.
+ *     cbfcmp Pointer to a callback comparison function.
+ * Return value:  Pointer to the element in the trie. NULL means the trie has no string that begins with pstr.
+ */
+PUCHAR _treSeekElementTrieA(P_TRIE_A ptrie, const void * pstr, size_t num, size_t size, CBF_COMPARE cbfcmp)
+{
+	REGISTER PUCHAR pbase = (PUCHAR) pstr, pdat = NULL;
+	for (; num > 0; --num, pbase += size, ptrie = (P_TRIE_A) &pdat[size])
+		if (NULL == *ptrie || NULL == (pdat = (PUCHAR) strBinarySearchArrayZ(*ptrie, pbase, _ELESIZ(size), cbfcmp)))
+			return NULL;
+	return pdat;
+}
+
+/* Function name: treSeekPrefixTrieA
+ * Description:   Position on the node of a prefix in a trie.
+ * Parameters:
+ *      ptrie Pointer to a trie of which you want to operate on.
+ *       pstr Pointer to the first element to a prefix and cast it into (const void *).
+ *        num Number of elements in the prefix. Input 0 to position on the root.
+ *       size Size of each element in the prefix.
+ *     cbfcmp Pointer to a callback comparison function.
+ *            Please refer to the prototype of callback function CBF_COMPARE in file svdef.h.
+ * Return value:  Pointer to the trie that holds the rest elements of strings that begin with pstr.
+ *                It points to NULL if pstr is a string with no longer strings in the trie.
+ *                NULL means no string in the trie begins with pstr.
+ * Caution:       ptrie must be allocated first.
+ *                The returned trie is a part of ptrie. Do not alter it.
+ * Tip:           Users may search or complete the rest of a string from the returned trie,
+ *                so that a prefix that grows along typing needs not be walked again from the root.
+ */
+P_TRIE_A treSeekPrefixTrieA(P_TRIE_A ptrie, const void * pstr, size_t num, size_t size, CBF_COMPARE cbfcmp)
+{
+	REGISTER PUCHAR pdat;
+	if (0 == num)
+		return ptrie;
+	if (NULL == (pdat = _treSeekElementTrieA(ptrie, pstr, num, size, cbfcmp)))
+		return NULL;
+	return (P_TRIE_A) &pdat[size];
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treReservePathTrieA
+ * Description:   Make the path buffer of a walk hold a number of elements.
+ * Parameters:
+ *         pw Pointer to a walk.
+ *        num Number of elements.
+ * Return value:  true:  Succeeded.
+ *                false: Allocation failure.
+ */
+bool _treReservePathTrieA(_P_TRIEWALK pw, size_t num)
+{
+	if (strLevelArrayZ(&pw->path) >= num * pw->size)
+		return true;
+	return NULL != strResizeArrayZ(&pw->path, 2 * num * pw->size, sizeof(UCHART));
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treReportTrieA
+ * Description:   Rank or report a string that a walk reaches.
+ * Parameters:
+ *         pw Pointer to a walk. The string lies in its path buffer.
+ *      vapdx Appendix of the string.
+ *        num Number of elements in the string.
+ * Return value:  CBF_CONTINUE or CBF_TERMINATE to stop walking.
+ */
+int _treReportTrieA(_P_TRIEWALK pw, size_t vapdx, size_t num)
+{
+	TRIE_ITEM item;
+	size_t temp;
+	switch (pw->mode)
+	{
+	case _TRIE_WALK_RANK:
+		if (! treIsFullHeapA(pw->pheap))
+			treInsertHeapA(pw->pheap, &vapdx, &temp, sizeof(size_t), svCBFCompareSizeTInteger, false);
+		else if (*(size_t *)pw->pheap->hdarr.pdata < vapdx)
+		{	/* Replace the least one. */
+			treRemoveHeapA(NULL, &temp, sizeof(size_t), pw->pheap, svCBFCompareSizeTInteger, false);
+			treInsertHeapA(pw->pheap, &vapdx, &temp, sizeof(size_t), svCBFCompareSizeTInteger, false);
+		}
+		return CBF_CONTINUE;
+	case _TRIE_WALK_TOP:
+		if (vapdx < pw->bound)
+			return CBF_CONTINUE;
+		if (vapdx == pw->bound)
+		{
+			if (0 == pw->ties)
+				return CBF_CONTINUE;
+			--pw->ties;
+		}
+		break;
+	}
+	item.pstr  = pw->path.pdata;
+	item.num   = num;
+	item.vapdx = vapdx;
+	item.dist  = 0;
+	++pw->count;
+	if (CBF_CONTINUE != pw->cbftvs(&item, pw->param))
+		return CBF_TERMINATE;
+	return (0 != pw->limit && pw->count >= pw->limit) ? CBF_TERMINATE : CBF_CONTINUE;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treWalkTrieA
+ * Description:   Walk strings in a trie in lexicographic order.
+ * Parameters:
+ *         pw Pointer to a walk.
+ *       trie A trie that is not NULL.
+ *      depth Number of elements in the path buffer before elements of trie.
+ * Return value:  CBF_CONTINUE or CBF_TERMINATE if walking stopped.
+ */
+int _treWalkTrieA(_P_TRIEWALK pw, TRIE_A trie, size_t depth)
+{
+	REGISTER size_t i;
+	REGISTER PUCHAR pdat = trie->pdata;
+	const size_t size = pw->size;
+	const bool bpath = _TRIE_WALK_RANK != pw->mode;
+	if (bpath && ! _treReservePathTrieA(pw, depth + 1))
+		return CBF_TERMINATE;
+	for (i = 0; i < strLevelArrayZ(trie); ++i, pdat += _ELESIZ(size))
+	{
+		if (bpath)
+			memcpy(pw->path.pdata + depth * size, pdat, size);
+		if (*(size_t *) &pdat[size + sizeof(TRIE_A) + sizeof(size_t) + sizeof(size_t)] &&
+			CBF_CONTINUE != _treReportTrieA(pw, *(size_t *) &pdat[size + sizeof(TRIE_A) + sizeof(size_t)], depth + 1))
+			return CBF_TERMINATE;
+		if (NULL != *(P_TRIE_A) &pdat[size] && CBF_CONTINUE != _treWalkTrieA(pw, *(P_TRIE_A) &pdat[size], depth + 1))
+			return CBF_TERMINATE;
+	}
+	return CBF_CONTINUE;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treStartWalkTrieA
+ * Description:   Walk strings that begin with a prefix in a trie, the prefix itself first.
+ * Parameters:
+ *         pw Pointer to a walk.
+ *      ptrie Pointer to a trie.
+ *       pstr Pointer to the first element to a prefix.
+ *        num Number of elements in the prefix.
+ *     cbfcmp Pointer to a callback comparison function.
+ * Return value:  N/A.
+ */
+void _treStartWalkTrieA(_P_TRIEWALK pw, P_TRIE_A ptrie, const void * pstr, size_t num, CBF_COMPARE cbfcmp)
+{
+	if (num > 0)
+	{
+		REGISTER PUCHAR pdat = _treSeekElementTrieA(ptrie, pstr, num, pw->size, cbfcmp);
+		if (NULL == pdat)
+			return;
+		if (_TRIE_WALK_RANK != pw->mode)
+		{
+			if (! _treReservePathTrieA(pw, num))
+				return;
+			memcpy(pw->path.pdata, pstr, num * pw->size);
+		}
+		if (*(size_t *) &pdat[pw->size + sizeof(TRIE_A) + sizeof(size_t) + sizeof(size_t)] &&
+			CBF_CONTINUE != _treReportTrieA(pw, *(size_t *) &pdat[pw->size + sizeof(TRIE_A) + sizeof(size_t)], num))
+			return;
+		ptrie = (P_TRIE_A) &pdat[pw->size];
+	}
+	if (NULL != *ptrie)
+		DISUSE(_treWalkTrieA(pw, *ptrie, num));
+}
+
+/* Function name: treCompleteTrieA
+ * Description:   Enumerate strings that begin with a prefix in a trie in lexicographic order.
+ * Parameters:
+ *      ptrie Pointer to a trie of which you want to operate on.
+ *       pstr Pointer to the first element to a prefix and cast it into (const void *).
+ *        num Number of elements in the prefix. Input 0 to enumerate every string.
+ *       size Size of each element in the prefix.
+ *      limit Maximum number of strings to report. Input 0 to report all of them.
+ *     cbfcmp Pointer to a callback comparison function.
+ *            Please refer to the prototype of callback function CBF_COMPARE in file svdef.h.
+ *     cbftvs Pointer to a callback function that receives strings.
+ *            Parameter pitem of callback function points to a TRIE_ITEM structure
+ *            whose string, the prefix included, is valid only during the call.
+ *            Enumeration stops if callback function returns CBF_TERMINATE.
+ *      param A size_t value which can be transferred into callback function.
+ * Return value:  Number of strings reported. Allocation failure stops enumeration early.
+ * Caution:       ptrie must be allocated first.
+ *                The order of elements is the order of cbfcmp.
+ * Tip:           Only the prefix and the strings reported are visited, so that
+ *                autocompletion costs O(prefix + limit) steps besides elements shared by reported strings.
+ */
+size_t treCompleteTrieA(P_TRIE_A ptrie, const void * pstr, size_t num, size_t size, size_t limit, CBF_COMPARE cbfcmp, CBF_TRAVERSE cbftvs, size_t param)
+{
+	_TRIEWALK w;
+	DISUSE(strInitArrayZ(&w.path, 0, sizeof(UCHART)));
+	w.size   = size;
+	w.limit  = limit;
+	w.count  = 0;
+	w.mode   = _TRIE_WALK_ALL;
+	w.pheap  = NULL;
+	w.cbftvs = cbftvs;
+	w.param  = param;
+	_treStartWalkTrieA(&w, ptrie, pstr, num, cbfcmp);
+	if (NULL != w.path.pdata)
+		strFreeArrayZ(&w.path);
+	return w.count;
+}
+
+/* Function name: treTopKTrieA
+ * Description:   Report k strings that begin with a prefix and have the greatest appendixes in a trie.
+ * Parameters:
+ *      ptrie Pointer to a trie of which you want to operate on.
+ *       pstr Pointer to the first element to a prefix and cast it into (const void *).
+ *        num Number of elements in the prefix. Input 0 to rank every string.
+ *       size Size of each element in the prefix.
+ *          k Number of strings to report.
+ *     cbfcmp Pointer to a callback comparison function.
+ *            Please refer to the prototype of callback function CBF_COMPARE in file svdef.h.
+ *     cbftvs Pointer to a callback function that receives strings.
+ *            Parameter pitem of callback function points to a TRIE_ITEM structure
+ *            whose string, the prefix included, is valid only during the call.
+ *      param A size_t value which can be transferred into callback function.
+ * Return value:  Number of strings reported. It is less than k if fewer strings begin with pstr.
+ *                0 also indicates an allocation failure.
+ * Caution:       ptrie must be allocated first.
+ * Tip:           Store frequencies or scores as vapdx when inserting strings to use this function for autocompletion.
+ *                Strings are reported in lexicographic order. Among strings that tie on the k-th appendix,
+ *                the lexicographically smaller ones are chosen.
+ *                The first pass ranks appendixes in a min heap of k elements and the second pass reports strings,
+ *                so that it costs O(n log k) for n strings under the prefix.
+ */
+size_t treTopKTrieA(P_TRIE_A ptrie, const void * pstr, size_t num, size_t size, size_t k, CBF_COMPARE cbfcmp, CBF_TRAVERSE cbftvs, size_t param)
+{
+	_TRIEWALK w;
+	HEAP_A heap;
+	REGISTER size_t i;
+	if (0 == k)
+		return 0;
+	treInitHeapA(&heap, k, sizeof(size_t));
+	if (NULL == heap.hdarr.pdata)
+		return 0;
+	DISUSE(strInitArrayZ(&w.path, 0, sizeof(UCHART)));
+	w.size   = size;
+	w.limit  = 0;
+	w.count  = 0;
+	w.mode   = _TRIE_WALK_RANK;
+	w.pheap  = &heap;
+	w.cbftvs = cbftvs;
+	w.param  = param;
+	_treStartWalkTrieA(&w, ptrie, pstr, num, cbfcmp);
+	if (! treIsEmptyHeapA(&heap))
+	{	/* Strings above the least appendix in the heap are all in top k, and so are ties of it that the heap holds. */
+		w.bound = *(size_t *)heap.hdarr.pdata;
+		w.ties  = 0;
+		for (i = 0; i < heap.irear; ++i)
+			if (w.bound == ((size_t *)heap.hdarr.pdata)[i])
+				++w.ties;
+		w.limit = heap.irear;
+		w.mode  = _TRIE_WALK_TOP;
+		_treStartWalkTrieA(&w, ptrie, pstr, num, cbfcmp);
+	}
+	treFreeHeapA(&heap);
+	if (NULL != w.path.pdata)
+		strFreeArrayZ(&w.path);
+	return w.count;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treFuzzySearchTrieA
+ * Description:   Search strings within an edit distance in a trie.
+ * Parameters:
+ *         pf Pointer to a search.
+ *       trie A trie that is not NULL.
+ *      depth Number of elements in the path buffer before elements of trie.
+ *            Row depth of edit distances has been filled.
+ * Return value:  CBF_CONTINUE or CBF_TERMINATE if searching stopped.
+ */
+int _treFuzzySearchTrieA(_P_TRIEFUZZY pf, TRIE_A trie, size_t depth)
+{
+	REGISTER size_t j, d, m;
+	REGISTER size_t * pprev, * pcur;
+	REGISTER PUCHAR pdat = trie->pdata;
+	size_t i;
+	const size_t n = pf->num + 1;
+	if (strLevelArrayZ(&pf->path) < (depth + 1) * pf->size &&
+		NULL == strResizeArrayZ(&pf->path, 2 * (depth + 1) * pf->size, sizeof(UCHART)))
+		return CBF_TERMINATE;
+	if (strLevelArrayZ(&pf->rows) < (depth + 2) * n &&
+		NULL == strResizeArrayZ(&pf->rows, 2 * (depth + 2) * n, sizeof(size_t)))
+		return CBF_TERMINATE;
+	for (i = 0; i < strLevelArrayZ(trie); ++i, pdat += _ELESIZ(pf->size))
+	{	/* Rows are fetched in each loop, for recursion may move them. */
+		pprev = (size_t *)pf->rows.pdata + depth * n;
+		pcur  = pprev + n;
+		m = pcur[0] = depth + 1;
+		for (j = 1; j < n; ++j)
+		{	/* Substitution, deletion or insertion. */
+			d = pprev[j - 1] + (0 == pf->cbfcmp(pdat, pf->pstr + (j - 1) * pf->size) ? 0 : 1);
+			if (pprev[j] + 1 < d)
+				d = pprev[j] + 1;
+			if (pcur[j - 1] + 1 < d)
+				d = pcur[j - 1] + 1;
+			pcur[j] = d;
+			if (d < m)
+				m = d;
+		}
+		if (m > pf->bound)
+			continue; /* No string that begins with the path is close enough. */
+		memcpy(pf->path.pdata + depth * pf->size, pdat, pf->size);
+		if (*(size_t *) &pdat[pf->size + sizeof(TRIE_A) + sizeof(size_t) + sizeof(size_t)] && pcur[n - 1] <= pf->bound)
+		{
+			TRIE_ITEM item;
+			item.pstr  = pf->path.pdata;
+			item.num   = depth + 1;
+			item.vapdx = *(size_t *) &pdat[pf->size + sizeof(TRIE_A) + sizeof(size_t)];
+			item.dist  = pcur[n - 1];
+			++pf->count;
+			if (CBF_CONTINUE != pf->cbftvs(&item, pf->param))
+				return CBF_TERMINATE;
+		}
+		if (NULL != *(P_TRIE_A) &pdat[pf->size] && CBF_CONTINUE != _treFuzzySearchTrieA(pf, *(P_TRIE_A) &pdat[pf->size], depth + 1))
+			return CBF_TERMINATE;
+	}
+	return CBF_CONTINUE;
+}
+
+/* Function name: treFuzzySearchTrieA
+ * Description:   Search strings within an edit distance from a string in a trie.
+ * Parameters:
+ *      ptrie Pointer to a trie of which you want to operate on.
+ *       pstr Pointer to the first element to a string and cast it into (const void *).
+ *        num Number of elements in the string.
+ *       size Size of each element in the string.
+ *      bound Maximum edit distance. Input 0 to search pstr exactly.
+ *     cbfcmp Pointer to a callback comparison function.
+ *            Please refer to the prototype of callback function CBF_COMPARE in file svdef.h.
+ *     cbftvs Pointer to a callback function that receives strings.
+ *            Parameter pitem of callback function points to a TRIE_ITEM structure
+ *            whose member dist is the edit distance of the string. The string is valid only during the call.
+ *            Searching stops if callback function returns CBF_TERMINATE.
+ *      param A size_t value which can be transferred into callback function.
+ * Return value:  Number of strings reported. Allocation failure stops searching early.
+ * Caution:       ptrie must be allocated first.
+ * Tip:           Edit distance is Levenshtein distance that counts insertions, deletions and substitutions of elements.
+ *                Strings are reported in lexicographic order.
+ *                A row of distances is computed for each element on the walk and shared by all strings under it.
+ *                Branches whose rows exceed bound are pruned, so that spelling correction with a small bound
+ *                only touches elements near the queried string instead of the whole dictionary.
+ */
+size_t treFuzzySearchTrieA(P_TRIE_A ptrie, const void * pstr, size_t num, size_t size, size_t bound, CBF_COMPARE cbfcmp, CBF_TRAVERSE cbftvs, size_t param)
+{
+	_TRIEFUZZY f;
+	REGISTER size_t j;
+	if (NULL == *ptrie)
+		return 0;
+	if (NULL == strInitArrayZ(&f.rows, 2 * (num + 1), sizeof(size_t)))
+		return 0;
+	DISUSE(strInitArrayZ(&f.path, 0, sizeof(UCHART)));
+	for (j = 0; j <= num; ++j) /* Distances from the empty string. */
+		((size_t *)f.rows.pdata)[j] = j;
+	f.pstr   = (PUCHAR) pstr;
+	f.num    = num;
+	f.size   = size;
+	f.bound  = bound;
+	f.count  = 0;
+	f.cbfcmp = cbfcmp;
+	f.cbftvs = cbftvs;
+	f.param  = param;
+	DISUSE(_treFuzzySearchTrieA(&f, *ptrie, 0));
+	if (NULL != f.path.pdata)
+		strFreeArrayZ(&f.path);
+	strFreeArrayZ(&f.rows);
+	return f.count;
+}
+
+/* Size of an entry in a flattened trie. The element is followed by the offset of its child node, the appendix and the flag. */
+#define _FLATSIZ(size) (ALIGN_SIZET(size) + sizeof(size_t) + sizeof(size_t) + sizeof(size_t))
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treSizeFlatTrieA
+ * Description:   Calculate the size of a trie in flat form.
+ * Parameters:
+ *       trie A trie that is not NULL.
+ *       size Size of each element.
+ * Return value:  Size in bytes of nodes of the trie.
+ */
+size_t _treSizeFlatTrieA(TRIE_A trie, size_t size)
+{
+	REGISTER size_t i, len = sizeof(size_t) + strLevelArrayZ(trie) * _FLATSIZ(size);
+	REGISTER PUCHAR pdat = trie->pdata;
+	for (i = 0; i < strLevelArrayZ(trie); ++i, pdat += _ELESIZ(size))
+		if (NULL != *(P_TRIE_A) &pdat[size])
+			len += _treSizeFlatTrieA(*(P_TRIE_A) &pdat[size], size);
+	return len;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treFlattenNodeTrieA
+ * Description:   Write a trie in flat form.
+ * Parameters:
+ *       trie A trie that is not NULL.
+ *       size Size of each element.
+ *       pbuf Pointer to the buffer.
+ *       ppos Pointer to the offset where the node is written. It is advanced past the trie.
+ * Return value:  Offset of the node.
+ */
+size_t _treFlattenNodeTrieA(TRIE_A trie, size_t size, PUCHAR pbuf, size_t * ppos)
+{
+	REGISTER size_t i;
+	REGISTER PUCHAR pent, pdat = trie->pdata;
+	const size_t pos = *ppos;
+	*(size_t *) &pbuf[pos] = strLevelArrayZ(trie);
+	pent = &pbuf[pos + sizeof(size_t)];
+	*ppos += sizeof(size_t) + strLevelArrayZ(trie) * _FLATSIZ(size);
+	for (i = 0; i < strLevelArrayZ(trie); ++i, pdat += _ELESIZ(size), pent += _FLATSIZ(size))
+	{	/* Children follow their parent. */
+		REGISTER size_t * pofs = (size_t *) &pent[ALIGN_SIZET(size)];
+		memset(pent, 0, ALIGN_SIZET(size));
+		memcpy(pent, pdat, size);
+		pofs[0] = NULL == *(P_TRIE_A) &pdat[size] ? 0 : _treFlattenNodeTrieA(*(P_TRIE_A) &pdat[size], size, pbuf, ppos);
+		pofs[1] = *(size_t *) &pdat[size + sizeof(TRIE_A) + sizeof(size_t)];
+		pofs[2] = *(size_t *) &pdat[size + sizeof(TRIE_A) + sizeof(size_t) + sizeof(size_t)];
+	}
+	return pos;
+}
+
+/* Function name: treFlattenTrieA
+ * Description:   Flatten a trie into a single position independent buffer.
+ * Parameters:
+ *      ptrie Pointer to a trie of which you want to flatten.
+ *       size Size of each element in strings.
+ *       plen Pointer to a size_t that receives the size of the buffer in bytes.
+ * Return value:  Pointer to the buffer. NULL indicates an allocation failure.
+ * Caution:       ptrie must be allocated first.
+ *                Users shall call free to release the buffer.
+ *                Nodes refer to each other by offsets from the beginning of the buffer,
+ *                but elements, offsets and appendixes are stored in native byte order and native size of size_t.
+ *                Thus a buffer can only be loaded on the platform that writes it.
+ * Tip:           Write the buffer into a file once, then map the file into memory or read it with a single fread
+ *                and query it by function treSearchFlatTrieA. Loading costs no insertion and no allocation per node.
+ *                The buffer begins with the size of elements and the offset of the root node.
+ *                Each node is a count followed by sorted entries of ALIGN_SIZET(size) + 3 * sizeof(size_t) bytes.
+ */
+void * treFlattenTrieA(P_TRIE_A ptrie, size_t size, size_t * plen)
+{
+	REGISTER PUCHAR pbuf;
+	size_t pos = sizeof(size_t) + sizeof(size_t);
+	*plen = pos + (NULL == *ptrie ? 0 : _treSizeFlatTrieA(*ptrie, size));
+	if (NULL == (pbuf = (PUCHAR) malloc(*plen)))
+		return NULL;
+	((size_t *) pbuf)[0] = size;
+	((size_t *) pbuf)[1] = NULL == *ptrie ? 0 : _treFlattenNodeTrieA(*ptrie, size, pbuf, &pos);
+	return pbuf;
+}
+
+/* Function name: treSearchFlatTrieA
+ * Description:   Search a string in a flattened trie.
+ * Parameters:
+ *      pflat Pointer to a buffer that function treFlattenTrieA made.
+ *       pstr Pointer to the first element to a string and cast it into (const void *).
+ *        num Number of elements in the string.
+ *     cbfcmp Pointer to a callback comparison function.
+ *            Please refer to the prototype of callback function CBF_COMPARE in file svdef.h.
+ * Return value:  Pointer to the appendix of the string. NULL means pstr is not in the trie.
+ * Caution:       pflat shall be aligned to size_t, as the return value of malloc and a mapped file are.
+ *                cbfcmp shall be the function that built the trie.
+ *                The buffer is only read, so that it can be shared among threads and processes.
+ */
+const size_t * treSearchFlatTrieA(const void * pflat, const void * pstr, size_t num, CBF_COMPARE cbfcmp)
+{
+	const size_t size = ((const size_t *) pflat)[0];
+	REGISTER size_t pos = ((const size_t *) pflat)[1];
+	REGISTER const UCHART * pbase = (const UCHART *) pstr, * pent = NULL;
+	if (0 == num)
+		return NULL;
+	for (; 0 != num && 0 != pos; --num, pbase += size)
+	{
+		REGISTER const UCHART * pnode = (const UCHART *) pflat + pos;
+		if (NULL == (pent = (const UCHART *) svBinarySearch(pbase, pnode + sizeof(size_t), *(const size_t *) pnode, _FLATSIZ(size), cbfcmp)))
+			return NULL;
+		pos = *(const size_t *) &pent[ALIGN_SIZET(size)];
+	}
+	if (0 != num || 0 == ((const size_t *) &pent[ALIGN_SIZET(size)])[2])
+		return NULL;
+	return &((const size_t *) &pent[ALIGN_SIZET(size)])[1];
+}
+
+#undef _FLATSIZ
+#undef _TRIE_WALK_ALL
+#undef _TRIE_WALK_RANK
+#undef _TRIE_WALK_TOP
+#undef _ELESIZ /* Undefine a used macro here to avert users mistakenly touching it. */
+
+
+/* This following section is for double-array tries over bytes.
+ * All cells of a trie lie in one array. A cell s reaches its child for symbol c at cell t = base[s] + c
+ * if check[t] equals s, so that each step costs two array loads and no comparison callback.
+ * Symbol 0 leads to a terminal cell that holds the appendix of a string ending at s.
+ * Byte x is symbol x + 1.
+ * Free cells in the array are linked into circular lists through their base and vapdx fields.
+ * A base search tries free cells of the open list for the first symbol. A cell that fails is shut:
+ * it moves to the other list, from which only a single child is placed, since it always fits.
+ * Each cell fails at most once after it is freed, so that crowded parts of the array are not scanned over and over.
+ */
+
+/* Number of symbols. */
+#define _TRIED_SYMBOLS (UCHAR_MAX + 2)
+
+/* Check value of a free cell. It also stands for an empty list of free cells. */
+#define _TRIED_FREE (~(size_t)0)
+
+/* Minimum number of cells that a trie allocates. */
+#define _TRIED_MIN_CELLS (2 * _TRIED_SYMBOLS)
+
+/* Macros that access cells. */
+#define _TRIED_CELLS(ptrie)   ((P_TRIED_CELL)(ptrie)->cells.pdata)
+#define _TRIED_SIZE(ptrie)    ((ptrie)->cells.num)
+#define _TRIED_USED(ptrie, t) ((t) < _TRIED_SIZE(ptrie) && _TRIED_FREE != _TRIED_CELLS(ptrie)[t].check)
+#define _TRIED_NEXT(ptrie, t) (_TRIED_CELLS(ptrie)[t].base)  /* Next free cell of a free cell. */
+#define _TRIED_PREV(ptrie, t) (_TRIED_CELLS(ptrie)[t].vapdx) /* Previous free cell of a free cell. */
+
+/* File level function declarations. */
+bool   _treGrowTrieD         (P_TRIE_D ptrie, size_t         num);
+bool   _trePlantTrieD        (P_TRIE_D ptrie);
+void   _treLinkCellTrieD     (P_TRIE_D ptrie, size_t *       phead,   size_t       t);
+void   _treUnlinkCellTrieD   (P_TRIE_D ptrie, size_t         t);
+void   _treTakeCellTrieD     (P_TRIE_D ptrie, size_t         t,       size_t       s);
+void   _treFreeCellTrieD     (P_TRIE_D ptrie, size_t         t);
+size_t _treChildrenTrieD     (P_TRIE_D ptrie, size_t         s,       unsigned short codes[]);
+size_t _treFindBaseTrieD     (P_TRIE_D ptrie, unsigned short codes[], size_t       n);
+size_t _treAddChildTrieD     (P_TRIE_D ptrie, size_t         s,       size_t       c);
+void   _trePruneTrieD        (P_TRIE_D ptrie, size_t         s);
+bool   _treBuildNodeTrieD    (P_TRIE_D ptrie, size_t         s,       const void * pstrs[], const size_t lens[], const size_t vapdx[],
+                              size_t   lo,    size_t         hi,      size_t       depth);
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treGrowTrieD
+ * Description:   Make a double-array trie hold at least num cells.
+ * Parameters:
+ *      ptrie Pointer to a double-array trie.
+ *        num Number of cells.
+ * Return value:  true:  Succeeded.
+ *                false: Allocation failure. The trie is intact.
+ * Tip:           The array at least doubles each time, so that growing costs amortized O(1) per cell.
+ *                New cells join the tail of the open list.
+ */
+bool _treGrowTrieD(P_TRIE_D ptrie, size_t num)
+{
+	REGISTER size_t i = _TRIED_SIZE(ptrie);
+	if (num <= i)
+		return true;
+	if (num < 2 * i)
+		num = 2 * i;
+	if (num < _TRIED_MIN_CELLS)
+		num = _TRIED_MIN_CELLS;
+	if (NULL == strResizeArrayZ(&ptrie->cells, num, sizeof(TRIED_CELL)))
+		return false;
+	for (; i < num; ++i)
+		_treLinkCellTrieD(ptrie, &ptrie->hopen, i);
+	return true;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _trePlantTrieD
+ * Description:   Allocate cells for an empty double-array trie and plant the root.
+ * Parameter:
+ *      ptrie Pointer to a double-array trie that has no cells.
+ * Return value:  true:  Succeeded.
+ *                false: Allocation failure.
+ * Tip:           The base of the root is never 0, so that symbol 0 of the root would not lead to the root itself.
+ */
+bool _trePlantTrieD(P_TRIE_D ptrie)
+{
+	if (! _treGrowTrieD(ptrie, _TRIED_MIN_CELLS))
+		return false;
+	_treTakeCellTrieD(ptrie, 0, 0);
+	_TRIED_CELLS(ptrie)[0].base = 1;
+	return true;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treLinkCellTrieD
+ * Description:   Mark a cell free and append it to a list of free cells.
+ * Parameters:
+ *      ptrie Pointer to a double-array trie.
+ *      phead Pointer to the head of the list. It is either &ptrie->hopen or &ptrie->hshut.
+ *          t Index of the cell. It shall be less than the number of cells and in no list.
+ * Return value:  N/A.
+ */
+void _treLinkCellTrieD(P_TRIE_D ptrie, size_t * phead, size_t t)
+{
+	REGISTER size_t h = *phead;
+	_TRIED_CELLS(ptrie)[t].check = _TRIED_FREE;
+	if (_TRIED_FREE == h)
+	{
+		_TRIED_NEXT(ptrie, t) = _TRIED_PREV(ptrie, t) = t;
+		*phead = t;
+	}
+	else
+	{
+		_TRIED_NEXT(ptrie, t) = h;
+		_TRIED_PREV(ptrie, t) = _TRIED_PREV(ptrie, h);
+		_TRIED_NEXT(ptrie, _TRIED_PREV(ptrie, h)) = t;
+		_TRIED_PREV(ptrie, h) = t;
+	}
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treUnlinkCellTrieD
+ * Description:   Remove a free cell from the list it is in.
+ * Parameters:
+ *      ptrie Pointer to a double-array trie.
+ *          t Index of the free cell.
+ * Return value:  N/A.
+ */
+void _treUnlinkCellTrieD(P_TRIE_D ptrie, size_t t)
+{
+	REGISTER size_t n = _TRIED_NEXT(ptrie, t);
+	if (n == t)
+		n = _TRIED_FREE; /* t is alone in its list. */
+	else
+	{
+		_TRIED_NEXT(ptrie, _TRIED_PREV(ptrie, t)) = n;
+		_TRIED_PREV(ptrie, n) = _TRIED_PREV(ptrie, t);
+	}
+	if (ptrie->hopen == t)
+		ptrie->hopen = n;
+	else if (ptrie->hshut == t)
+		ptrie->hshut = n;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treTakeCellTrieD
+ * Description:   Make a free cell a child of another cell.
+ * Parameters:
+ *      ptrie Pointer to a double-array trie.
+ *          t Index of the free cell. It shall be less than the number of cells.
+ *          s Index of the parent cell.
+ * Return value:  N/A.
+ */
+void _treTakeCellTrieD(P_TRIE_D ptrie, size_t t, size_t s)
+{
+	REGISTER P_TRIED_CELL pc = _TRIED_CELLS(ptrie);
+	_treUnlinkCellTrieD(ptrie, t);
+	pc[t].base  = 0;
+	pc[t].check = s;
+	pc[t].vapdx = 0;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treFreeCellTrieD
+ * Description:   Free a cell.
+ * Parameters:
+ *      ptrie Pointer to a double-array trie.
+ *          t Index of the cell.
+ * Return value:  N/A.
+ */
+void _treFreeCellTrieD(P_TRIE_D ptrie, size_t t)
+{
+	_treLinkCellTrieD(ptrie, &ptrie->hopen, t);
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treChildrenTrieD
+ * Description:   List symbols of children of a cell.
+ * Parameters:
+ *      ptrie Pointer to a double-array trie.
+ *          s Index of the cell.
+ *      codes An array of _TRIED_SYMBOLS elements that receives symbols in ascending order.
+ * Return value:  Number of children.
+ */
+size_t _treChildrenTrieD(P_TRIE_D ptrie, size_t s, unsigned short codes[])
+{
+	REGISTER size_t c, n = 0, b = _TRIED_CELLS(ptrie)[s].base;
+	if (0 != b)
+		for (c = 0; c < _TRIED_SYMBOLS && b + c < _TRIED_SIZE(ptrie); ++c)
+			if (s == _TRIED_CELLS(ptrie)[b + c].check)
+				codes[n++] = (unsigned short)c;
+	return n;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treFindBaseTrieD
+ * Description:   Find a base with which cells for every symbol are free.
+ * Parameters:
+ *      ptrie Pointer to a double-array trie.
+ *      codes Symbols in ascending order.
+ *          n Number of symbols. It shall be greater than 0.
+ * Return value:  The base. It is greater than 0 and cells beyond the array are counted as free.
+ * Tip:           Only free cells are tried for the first symbol. A cell of the open list that does not fit is shut.
+ *                If no cell fits, children would be placed after the end of the array.
+ */
+size_t _treFindBaseTrieD(P_TRIE_D ptrie, unsigned short codes[], size_t n)
+{
+	REGISTER size_t t, b, i;
+	if (1 == n && _TRIED_FREE != (t = ptrie->hshut))
+	{	/* A single child fits in any shut cell but those that would make the base 0. */
+		do
+		{
+			if (t > (size_t)codes[0])
+				return t - codes[0];
+			t = _TRIED_NEXT(ptrie, t);
+		}
+		while (t != ptrie->hshut);
+	}
+	while (_TRIED_FREE != (t = ptrie->hopen))
+	{
+		if (t > (size_t)codes[0])
+		{
+			b = t - codes[0];
+			for (i = 1; i < n && ! _TRIED_USED(ptrie, b + codes[i]); ++i)
+				;
+			if (i == n)
+				return b;
+		}
+		_treUnlinkCellTrieD(ptrie, t);
+		_treLinkCellTrieD(ptrie, &ptrie->hshut, t);
+	}
+	return _TRIED_SIZE(ptrie) > (size_t)codes[0] ? _TRIED_SIZE(ptrie) - codes[0] : 1;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treAddChildTrieD
+ * Description:   Add a child to a cell. Children would move to a new base if the cell for the new one were taken.
+ * Parameters:
+ *      ptrie Pointer to a double-array trie.
+ *          s Index of the parent cell.
+ *          c Symbol of the new child.
+ * Return value:  Index of the new child. 0 indicates an allocation failure and the trie is intact.
+ */
+size_t _treAddChildTrieD(P_TRIE_D ptrie, size_t s, size_t c)
+{
+	unsigned short codes[_TRIED_SYMBOLS];
+	REGISTER P_TRIED_CELL pc;
+	REGISTER size_t i, n, b = _TRIED_CELLS(ptrie)[s].base, nb, old, nw, g;
+	if (0 != b && ! _TRIED_USED(ptrie, b + c))
+	{
+		if (! _treGrowTrieD(ptrie, b + c + 1))
+			return 0;
+		_treTakeCellTrieD(ptrie, b + c, s);
+		return b + c;
+	}
+	/* Move children to a base that also leaves a cell for symbol c. */
+	n = _treChildrenTrieD(ptrie, s, codes);
+	for (i = n; i > 0 && codes[i - 1] > c; --i)
+		codes[i] = codes[i - 1];
+	codes[i] = (unsigned short)c;
+	++n;
+	nb = _treFindBaseTrieD(ptrie, codes, n);
+	if (! _treGrowTrieD(ptrie, nb + codes[n - 1] + 1))
+		return 0;
+	pc = _TRIED_CELLS(ptrie);
+	for (i = 0; i < n; ++i)
+	{
+		if (codes[i] == c)
+			continue;
+		old = b + codes[i];
+		nw  = nb + codes[i];
+		_treTakeCellTrieD(ptrie, nw, s);
+		pc[nw].base  = pc[old].base;
+		pc[nw].vapdx = pc[old].vapdx;
+		/* Grandchildren follow their parent. */
+		if (0 != pc[old].base)
+			for (g = pc[old].base; g < pc[old].base + _TRIED_SYMBOLS && g < _TRIED_SIZE(ptrie); ++g)
+				if (old == pc[g].check)
+					pc[g].check = nw;
+		_treFreeCellTrieD(ptrie, old);
+	}
+	pc[s].base = nb;
+	_treTakeCellTrieD(ptrie, nb + c, s);
+	return nb + c;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _trePruneTrieD
+ * Description:   Free a cell and its ancestors up to a cell that has other children.
+ * Parameters:
+ *      ptrie Pointer to a double-array trie.
+ *          s Index of the lowest cell. It would be kept if it had children.
+ * Return value:  N/A.
+ */
+void _trePruneTrieD(P_TRIE_D ptrie, size_t s)
+{
+	unsigned short codes[_TRIED_SYMBOLS];
+	REGISTER size_t p;
+	while (0 != s && 0 == _treChildrenTrieD(ptrie, s, codes))
+	{
+		p = _TRIED_CELLS(ptrie)[s].check;
+		_treFreeCellTrieD(ptrie, s);
+		s = p;
+	}
+}
+
+/* Function name: treInitTrieD
+ * Description:   Initialize a double-array trie.
+ * Parameter:
+ *      ptrie Pointer to a trie you want to initialize.
+ * Return value:  N/A.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ */
+void treInitTrieD(P_TRIE_D ptrie)
+{
+	DISUSE(strInitArrayZ(&ptrie->cells, 0, sizeof(TRIED_CELL)));
+	ptrie->hopen = _TRIED_FREE;
+	ptrie->hshut = _TRIED_FREE;
+	ptrie->num   = 0;
+}
+
+/* Function name: treFreeTrieD
+ * Description:   Retract a double-array trie which is allocated by function treInitTrieD.
+ * Parameter:
+ *      ptrie Pointer to a trie you want to release.
+ * Return value:  N/A.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ */
+void treFreeTrieD(P_TRIE_D ptrie)
+{
+	if (NULL != ptrie->cells.pdata)
+		strFreeArrayZ(&ptrie->cells);
+	treInitTrieD(ptrie);
+}
+
+/* Function name: treCreateTrieD
+ * Description:   Allocate a new double-array trie dynamically.
+ * Parameters:    N/A.
+ * Return value:  Pointer to the new allocated trie.
+ */
+P_TRIE_D treCreateTrieD(void)
+{
+	REGISTER P_TRIE_D ptrie = (P_TRIE_D) malloc(sizeof(TRIE_D));
+	if (NULL != ptrie)
+		treInitTrieD(ptrie);
+	return ptrie;
+}
+
+/* Function name: treDeleteTrieD
+ * Description:   Delete a double-array trie which is allocated by function treCreateTrieD.
+ * Parameter:
+ *      ptrie Pointer to a trie you want to delete.
+ * Return value:  N/A.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ */
+void treDeleteTrieD(P_TRIE_D ptrie)
+{
+	treFreeTrieD(ptrie);
+	free(ptrie);
+}
+
+/* Function name: treSearchTrieD
+ * Description:   Search a string in a double-array trie.
+ * Parameters:
+ *      ptrie Pointer to a trie of which you want to operate on.
+ *       pstr Pointer to the first byte of a string.
+ *        num Number of bytes in the string.
+ * Return value:  Pointer to the value that contains vapdx stored in the trie.
+ *                NULL indicates that the string cannot be found in the trie.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ *                The returned pointer would be invalid after the trie was altered.
+ */
+size_t * treSearchTrieD(P_TRIE_D ptrie, const void * pstr, size_t num)
+{
+	REGISTER const TRIED_CELL * pc = _TRIED_CELLS(ptrie);
+	REGISTER const UCHART * p = (const UCHART *) pstr;
+	REGISTER size_t s = 0, t;
+	const size_t size = _TRIED_SIZE(ptrie);
+	if (0 == size)
+		return NULL;
+	for (; num > 0; --num, s = t)
+	{
+		t = pc[s].base + *p++ + 1;
+		if (t >= size || s != pc[t].check)
+			return NULL;
+	}
+	t = pc[s].base;
+	return (t < size && s == pc[t].check) ? (size_t *) &pc[t].vapdx : NULL;
+}
+
+/* Function name: treInsertTrieD
+ * Description:   Insert a string into a double-array trie.
+ * Parameters:
+ *      ptrie Pointer to a trie of which you want to operate on.
+ *       pstr Pointer to the first byte of a string.
+ *        num Number of bytes in the string.
+ *      vapdx An integer in size_t as an appendix that can store a pointer in a trie.
+ * Return value:  true  Insertion succeeded.
+ *                false Allocation failure. The trie holds the same strings as before.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ *                Value vapdx that stored with a string in trie will be replaced if users insert the same string repeatedly.
+ */
+bool treInsertTrieD(P_TRIE_D ptrie, const void * pstr, size_t num, size_t vapdx)
+{
+	REGISTER const UCHART * p = (const UCHART *) pstr;
+	REGISTER size_t s = 0, t, i;
+	size_t * pv;
+	if (NULL != (pv = treSearchTrieD(ptrie, pstr, num)))
+	{
+		*pv = vapdx;
+		return true;
+	}
+	if (0 == _TRIED_SIZE(ptrie) && ! _trePlantTrieD(ptrie))
+		return false;
+	for (i = 0; i <= num; ++i, s = t)
+	{
+		REGISTER size_t c = i < num ? (size_t)p[i] + 1 : 0;
+		t = _TRIED_CELLS(ptrie)[s].base + c;
+		if (0 != _TRIED_CELLS(ptrie)[s].base && t < _TRIED_SIZE(ptrie) && s == _TRIED_CELLS(ptrie)[t].check)
+			continue;
+		if (0 == (t = _treAddChildTrieD(ptrie, s, c)))
+		{
+			_trePruneTrieD(ptrie, s);
+			return false;
+		}
+	}
+	_TRIED_CELLS(ptrie)[s].vapdx = vapdx;
+	++ptrie->num;
+	return true;
+}
+
+/* Function name: treRemoveTrieD
+ * Description:   Remove a string from a double-array trie.
+ * Parameters:
+ *      ptrie Pointer to a trie of which you want to operate on.
+ *       pstr Pointer to the first byte of a string.
+ *        num Number of bytes in the string.
+ * Return value:  true  Removal succeeded.
+ *                false Cannot find the string.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ */
+bool treRemoveTrieD(P_TRIE_D ptrie, const void * pstr, size_t num)
+{
+	REGISTER size_t * pv = treSearchTrieD(ptrie, pstr, num);
+	REGISTER size_t t, s;
+	if (NULL == pv)
+		return false;
+	t = (size_t)((P_TRIED_CELL)((PUCHAR)pv - offsetof(TRIED_CELL, vapdx)) - _TRIED_CELLS(ptrie));
+	s = _TRIED_CELLS(ptrie)[t].check;
+	_treFreeCellTrieD(ptrie, t);
+	_trePruneTrieD(ptrie, s);
+	--ptrie->num;
+	return true;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treBuildNodeTrieD
+ * Description:   Place children of a cell for sorted strings that share their leading bytes, then their descendants.
+ * Parameters:
+ *      ptrie Pointer to a double-array trie.
+ *          s Index of the cell.
+ *      pstrs Strings in strictly ascending order.
+ *       lens Lengths of strings.
+ *      vapdx Appendixes of strings. NULL means the index of each string in pstrs.
+ *         lo Index of the first string under the cell.
+ *         hi Index after the last string under the cell.
+ *      depth Number of leading bytes that strings lo to hi - 1 share.
+ * Return value:  true:  Succeeded.
+ *                false: Allocation failure.
+ */
+bool _treBuildNodeTrieD(P_TRIE_D ptrie, size_t s, const void * pstrs[], const size_t lens[], const size_t vapdx[],
+                        size_t lo, size_t hi, size_t depth)
+{
+	unsigned short codes[_TRIED_SYMBOLS];
+	REGISTER size_t i, j, c, b, n = 0;
+	/* Each symbol at depth begins a run of strings. A string that ends at depth has symbol 0 and comes first. */
+	for (i = lo; i < hi; i = j)
+	{
+		c = lens[i] > depth ? (size_t)((const UCHART *) pstrs[i])[depth] + 1 : 0;
+		for (j = i + 1; j < hi && c == (size_t)((const UCHART *) pstrs[j])[depth] + 1; ++j)
+			;
+		codes[n++] = (unsigned short)c;
+	}
+	b = _treFindBaseTrieD(ptrie, codes, n);
+	if (! _treGrowTrieD(ptrie, b + codes[n - 1] + 1))
+		return false;
+	_TRIED_CELLS(ptrie)[s].base = b;
+	for (i = 0; i < n; ++i)
+		_treTakeCellTrieD(ptrie, b + codes[i], s);
+	for (i = lo; i < hi; i = j)
+	{
+		c = lens[i] > depth ? (size_t)((const UCHART *) pstrs[i])[depth] + 1 : 0;
+		for (j = i + 1; j < hi && c == (size_t)((const UCHART *) pstrs[j])[depth] + 1; ++j)
+			;
+		if (0 == c)
+		{
+			_TRIED_CELLS(ptrie)[b].vapdx = NULL != vapdx ? vapdx[i] : i;
+			++ptrie->num;
+		}
+		else if (! _treBuildNodeTrieD(ptrie, b + c, pstrs, lens, vapdx, i, j, depth + 1))
+			return false;
+	}
+	return true;
+}
+
+/* Function name: treBuildTrieD
+ * Description:   Build a double-array trie from sorted strings at once.
+ * Parameters:
+ *      ptrie Pointer to a trie of which you want to operate on. Its former strings would be dropped.
+ *      pstrs Pointers to strings. They shall be in strictly ascending order as unsigned bytes, the order of memcmp,
+ *            where a string is less than the strings that it is a head of.
+ *       lens Number of bytes of each string.
+ *      vapdx Appendixes of strings. Input NULL to store the index of each string in pstrs as its appendix.
+ *        num Number of strings.
+ * Return value:  true  Building succeeded.
+ *                false Strings are not in order, or allocation failure. The trie is intact.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ * Tip:           Each cell is placed once and never moves, so that building is much faster than
+ *                inserting strings one by one and leaves cells packed more densely.
+ */
+bool treBuildTrieD(P_TRIE_D ptrie, const void * pstrs[], const size_t lens[], const size_t vapdx[], size_t num)
+{
+	TRIE_D trie;
+	REGISTER size_t i, n;
+	REGISTER int r;
+	for (i = 1; i < num; ++i)
+	{
+		n = lens[i - 1] < lens[i] ? lens[i - 1] : lens[i];
+		r = memcmp(pstrs[i - 1], pstrs[i], n);
+		if (r > 0 || (0 == r && lens[i - 1] >= lens[i]))
+			return false;
+	}
+	treInitTrieD(&trie);
+	if (! _trePlantTrieD(&trie))
+		return false;
+	if (num > 0 && ! _treBuildNodeTrieD(&trie, 0, pstrs, lens, vapdx, 0, num, 0))
+	{
+		treFreeTrieD(&trie);
+		return false;
+	}
+	treFreeTrieD(ptrie);
+	*ptrie = trie;
+	return true;
+}
+
+#undef _TRIED_SYMBOLS
+#undef _TRIED_FREE
+#undef _TRIED_MIN_CELLS
+#undef _TRIED_CELLS
+#undef _TRIED_SIZE
+#undef _TRIED_USED
+#undef _TRIED_NEXT
+#undef _TRIED_PREV
+/* Undefine used macros for this section. */
+
+/* This following section is for adaptive radix tries.
+ * An inner node has room for 4, 16, 48 or 256 children and turns into the smallest kind that fits its children.
+ * A node that would have only one child is merged into the child, whose prefix records the bytes skipped.
+ * Only the first _TRIER_PREFIX bytes of a prefix are stored. A search skips the rest optimistically and
+ * compares the whole key at the leaf, while an update reads the rest from any leaf under the node.
+ * A key that is alone in a subtree is a leaf right under the node where it departs from other keys,
+ * and a key that ends where a node branches hangs on the node as its terminal leaf.
+ */
+
+/* Number of prefix bytes stored in an inner node. */
+#define _TRIER_PREFIX (8)
+
+/* Kinds of nodes. */
+#define _TRIER_LEAF (0)
+#define _TRIER_N4   (1)
+#define _TRIER_N16  (2)
+#define _TRIER_N48  (3)
+#define _TRIER_N256 (4)
+
+/* Header of inner nodes. */
+typedef struct _st_TRIERNODE {
+	UCHART       kind;                  /* Kind of node. */
+	UCHART       prefix[_TRIER_PREFIX]; /* Leading bytes of the prefix. */
+	size_t       num;                   /* Number of children. */
+	size_t       plen;                  /* Length of the prefix. */
+	P_TRIER_LEAF pterm;                 /* Leaf of the key that ends right after the prefix. */
+} _TRIERNODE, * _P_TRIERNODE;
+
+/* Inner nodes with 4 and 16 children keep bytes of children in ascending order. */
+typedef struct _st_TRIERNODE4 {
+	_TRIERNODE hdr;
+	UCHART     keys[4];
+	void *     pchild[4];
+} _TRIERNODE4, * _P_TRIERNODE4;
+
+typedef struct _st_TRIERNODE16 {
+	_TRIERNODE hdr;
+	UCHART     keys[16];
+	void *     pchild[16];
+} _TRIERNODE16, * _P_TRIERNODE16;
+
+/* An inner node with 48 children maps each byte to a slot of children. 0 means no child. */
+typedef struct _st_TRIERNODE48 {
+	_TRIERNODE hdr;
+	UCHART     index[UCHAR_MAX + 1];
+	void *     pchild[48];
+} _TRIERNODE48, * _P_TRIERNODE48;
+
+typedef struct _st_TRIERNODE256 {
+	_TRIERNODE hdr;
+	void *     pchild[UCHAR_MAX + 1];
+} _TRIERNODE256, * _P_TRIERNODE256;
+
+/* Macros that access nodes. */
+#define _TRIER_KIND(p)     (*(PUCHAR)(p))
+#define _TRIER_LEAFKEY(pl) ((PUCHAR)((P_TRIER_LEAF)(pl) + 1))
+#define _TRIER_KEYS(pn)    (_TRIER_N4 == (pn)->kind ? ((_P_TRIERNODE4)(pn))->keys : ((_P_TRIERNODE16)(pn))->keys)
+#define _TRIER_KIDS(pn)    (_TRIER_N4 == (pn)->kind ? ((_P_TRIERNODE4)(pn))->pchild : ((_P_TRIERNODE16)(pn))->pchild)
+
+/* File level function declarations. */
+P_TRIER_LEAF _treCreateLeafTrieR     (const UCHART * pkey,  size_t         klen,  size_t       vapdx);
+bool         _treMatchLeafTrieR      (P_TRIER_LEAF   pl,    const UCHART * pkey,  size_t       klen);
+_P_TRIERNODE _treCreateNodeTrieR     (UCHART         kind);
+void **      _treFindChildTrieR      (_P_TRIERNODE   pn,    UCHART         c);
+void **      _treNextChildTrieR      (_P_TRIERNODE   pn,    size_t *       pi,    PUCHAR       pc);
+bool         _treIsFullTrieR         (_P_TRIERNODE   pn);
+void         _treAddChildTrieR       (_P_TRIERNODE   pn,    UCHART         c,     void *       pchild);
+void         _treRemoveChildTrieR    (_P_TRIERNODE   pn,    UCHART         c);
+_P_TRIERNODE _treResizeNodeTrieR     (_P_TRIERNODE   pn,    UCHART         kind);
+P_TRIER_LEAF _treMinLeafTrieR        (void *         p);
+size_t       _trePrefixMismatchTrieR (_P_TRIERNODE   pn,    const UCHART * pkey,  size_t       klen,   size_t       depth);
+void         _treHangLeafTrieR       (_P_TRIERNODE   pn,    P_TRIER_LEAF   pl,    size_t       depth);
+void         _treTidyNodeTrieR       (void **        pref);
+bool         _treRemoveNodeTrieR     (void **        pref,  const UCHART * pkey,  size_t       klen,   size_t       depth);
+void         _treFreeNodesTrieR      (void *         p);
+int          _treTraverseNodeTrieR   (void *         p,     CBF_TRAVERSE   cbftvs, size_t      param);
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treCreateLeafTrieR
+ * Description:   Allocate a leaf with its key in one block.
+ * Parameters:
+ *       pkey Pointer to the key.
+ *       klen Number of bytes in the key.
+ *      vapdx Appendix.
+ * Return value:  Pointer to the new leaf. NULL indicates an allocation failure.
+ */
+P_TRIER_LEAF _treCreateLeafTrieR(const UCHART * pkey, size_t klen, size_t vapdx)
+{
+	REGISTER P_TRIER_LEAF pl = (P_TRIER_LEAF) malloc(sizeof(TRIER_LEAF) + klen);
+	if (NULL != pl)
+	{
+		pl->kind  = _TRIER_LEAF;
+		pl->vapdx = vapdx;
+		pl->len   = klen;
+		memcpy(_TRIER_LEAFKEY(pl), pkey, klen);
+	}
+	return pl;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treMatchLeafTrieR
+ * Description:   Compare the key of a leaf with a key.
+ * Parameters:
+ *         pl Pointer to the leaf.
+ *       pkey Pointer to the key.
+ *       klen Number of bytes in the key.
+ * Return value:  true if the two keys are the same.
+ */
+bool _treMatchLeafTrieR(P_TRIER_LEAF pl, const UCHART * pkey, size_t klen)
+{
+	return pl->len == klen && 0 == memcmp(_TRIER_LEAFKEY(pl), pkey, klen);
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treCreateNodeTrieR
+ * Description:   Allocate an empty inner node.
+ * Parameter:
+ *       kind Kind of the node.
+ * Return value:  Pointer to the new node. NULL indicates an allocation failure.
+ */
+_P_TRIERNODE _treCreateNodeTrieR(UCHART kind)
+{
+	REGISTER _P_TRIERNODE pn;
+	REGISTER size_t i;
+	switch (kind)
+	{
+	case _TRIER_N4:   pn = (_P_TRIERNODE) malloc(sizeof(_TRIERNODE4));   break;
+	case _TRIER_N16:  pn = (_P_TRIERNODE) malloc(sizeof(_TRIERNODE16));  break;
+	case _TRIER_N48:  pn = (_P_TRIERNODE) malloc(sizeof(_TRIERNODE48));  break;
+	default:          pn = (_P_TRIERNODE) malloc(sizeof(_TRIERNODE256)); break;
+	}
+	if (NULL != pn)
+	{
+		pn->kind  = kind;
+		pn->num   = 0;
+		pn->plen  = 0;
+		pn->pterm = NULL;
+		if (_TRIER_N48 == kind)
+		{
+			memset(((_P_TRIERNODE48)pn)->index, 0, UCHAR_MAX + 1);
+			for (i = 0; i < 48; ++i)
+				((_P_TRIERNODE48)pn)->pchild[i] = NULL;
+		}
+		else if (_TRIER_N256 == kind)
+			for (i = 0; i <= UCHAR_MAX; ++i)
+				((_P_TRIERNODE256)pn)->pchild[i] = NULL;
+	}
+	return pn;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treFindChildTrieR
+ * Description:   Find the child of a node for a byte.
+ * Parameters:
+ *         pn Pointer to an inner node.
+ *          c The byte.
+ * Return value:  Pointer to the slot that holds the child. NULL means no child for c.
+ * Tip:           A node with 16 children counts smaller bytes without branches, which compilers could vectorize.
+ */
+void ** _treFindChildTrieR(_P_TRIERNODE pn, UCHART c)
+{
+	REGISTER size_t i, k;
+	switch (pn->kind)
+	{
+	case _TRIER_N4:
+		for (i = 0; i < pn->num; ++i)
+			if (c == ((_P_TRIERNODE4)pn)->keys[i])
+				return &((_P_TRIERNODE4)pn)->pchild[i];
+		break;
+	case _TRIER_N16:
+		for (i = k = 0; i < pn->num; ++i)
+			k += ((_P_TRIERNODE16)pn)->keys[i] < c;
+		if (k < pn->num && c == ((_P_TRIERNODE16)pn)->keys[k])
+			return &((_P_TRIERNODE16)pn)->pchild[k];
+		break;
+	case _TRIER_N48:
+		if (0 != (k = ((_P_TRIERNODE48)pn)->index[c]))
+			return &((_P_TRIERNODE48)pn)->pchild[k - 1];
+		break;
+	default:
+		if (NULL != ((_P_TRIERNODE256)pn)->pchild[c])
+			return &((_P_TRIERNODE256)pn)->pchild[c];
+	}
+	return NULL;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treNextChildTrieR
+ * Description:   Visit children of a node in ascending order of their bytes.
+ * Parameters:
+ *         pn Pointer to an inner node.
+ *         pi Pointer to the state of visiting. Set it to 0 before the first call.
+ *         pc Pointer to a byte that receives the byte of the child.
+ * Return value:  Pointer to the slot that holds the next child. NULL means no more children.
+ */
+void ** _treNextChildTrieR(_P_TRIERNODE pn, size_t * pi, PUCHAR pc)
+{
+	REGISTER size_t i = *pi;
+	switch (pn->kind)
+	{
+	case _TRIER_N4:
+	case _TRIER_N16:
+		if (i < pn->num)
+		{
+			*pi = i + 1;
+			*pc = _TRIER_KEYS(pn)[i];
+			return &_TRIER_KIDS(pn)[i];
+		}
+		break;
+	case _TRIER_N48:
+		for (; i <= UCHAR_MAX; ++i)
+			if (0 != ((_P_TRIERNODE48)pn)->index[i])
+			{
+				*pi = i + 1;
+				*pc = (UCHART)i;
+				return &((_P_TRIERNODE48)pn)->pchild[((_P_TRIERNODE48)pn)->index[i] - 1];
+			}
+		break;
+	default:
+		for (; i <= UCHAR_MAX; ++i)
+			if (NULL != ((_P_TRIERNODE256)pn)->pchild[i])
+			{
+				*pi = i + 1;
+				*pc = (UCHART)i;
+				return &((_P_TRIERNODE256)pn)->pchild[i];
+			}
+	}
+	*pi = i;
+	return NULL;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treIsFullTrieR
+ * Description:   Check whether a node has no room for another child.
+ * Parameter:
+ *         pn Pointer to an inner node.
+ * Return value:  true if the node is full.
+ */
+bool _treIsFullTrieR(_P_TRIERNODE pn)
+{
+	switch (pn->kind)
+	{
+	case _TRIER_N4:  return pn->num >= 4;
+	case _TRIER_N16: return pn->num >= 16;
+	case _TRIER_N48: return pn->num >= 48;
+	}
+	return false;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treAddChildTrieR
+ * Description:   Add a child to a node that has room for it.
+ * Parameters:
+ *         pn Pointer to an inner node.
+ *          c Byte of the child. The node shall not have a child for c.
+ *     pchild Pointer to the child.
+ * Return value:  N/A.
+ */
+void _treAddChildTrieR(_P_TRIERNODE pn, UCHART c, void * pchild)
+{
+	REGISTER size_t i;
+	switch (pn->kind)
+	{
+	case _TRIER_N4:
+	case _TRIER_N16:
+		{
+			REGISTER PUCHAR pkeys = _TRIER_KEYS(pn);
+			REGISTER void ** ppc = _TRIER_KIDS(pn);
+			for (i = pn->num; i > 0 && pkeys[i - 1] > c; --i)
+			{
+				pkeys[i] = pkeys[i - 1];
+				ppc[i] = ppc[i - 1];
+			}
+			pkeys[i] = c;
+			ppc[i] = pchild;
+		}
+		break;
+	case _TRIER_N48:
+		for (i = 0; NULL != ((_P_TRIERNODE48)pn)->pchild[i]; ++i)
+			;
+		((_P_TRIERNODE48)pn)->pchild[i] = pchild;
+		((_P_TRIERNODE48)pn)->index[c] = (UCHART)(i + 1);
+		break;
+	default:
+		((_P_TRIERNODE256)pn)->pchild[c] = pchild;
+	}
+	++pn->num;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treRemoveChildTrieR
+ * Description:   Remove the child of a node for a byte.
+ * Parameters:
+ *         pn Pointer to an inner node.
+ *          c Byte of the child. The node shall have a child for c.
+ * Return value:  N/A.
+ */
+void _treRemoveChildTrieR(_P_TRIERNODE pn, UCHART c)
+{
+	REGISTER size_t i;
+	switch (pn->kind)
+	{
+	case _TRIER_N4:
+	case _TRIER_N16:
+		{
+			REGISTER PUCHAR pkeys = _TRIER_KEYS(pn);
+			REGISTER void ** ppc = _TRIER_KIDS(pn);
+			for (i = 0; pkeys[i] != c; ++i)
+				;
+			for (; i + 1 < pn->num; ++i)
+			{
+				pkeys[i] = pkeys[i + 1];
+				ppc[i] = ppc[i + 1];
+			}
+		}
+		break;
+	case _TRIER_N48:
+		((_P_TRIERNODE48)pn)->pchild[((_P_TRIERNODE48)pn)->index[c] - 1] = NULL;
+		((_P_TRIERNODE48)pn)->index[c] = 0;
+		break;
+	default:
+		((_P_TRIERNODE256)pn)->pchild[c] = NULL;
+	}
+	--pn->num;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treResizeNodeTrieR
+ * Description:   Move a node into a node of another kind.
+ * Parameters:
+ *         pn Pointer to an inner node. It would be freed if function succeeded.
+ *       kind Kind of the new node. It shall have room for every child of pn.
+ * Return value:  Pointer to the new node. NULL indicates an allocation failure and pn is intact.
+ */
+_P_TRIERNODE _treResizeNodeTrieR(_P_TRIERNODE pn, UCHART kind)
+{
+	REGISTER _P_TRIERNODE pnew = _treCreateNodeTrieR(kind);
+	REGISTER void ** ppc;
+	size_t i = 0;
+	UCHART c;
+	if (NULL != pnew)
+	{
+		memcpy(pnew->prefix, pn->prefix, _TRIER_PREFIX);
+		pnew->plen  = pn->plen;
+		pnew->pterm = pn->pterm;
+		while (NULL != (ppc = _treNextChildTrieR(pn, &i, &c)))
+			_treAddChildTrieR(pnew, c, *ppc);
+		free(pn);
+	}
+	return pnew;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treMinLeafTrieR
+ * Description:   Find the leaf of the smallest key under a node.
+ * Parameter:
+ *          p Pointer to a leaf or an inner node.
+ * Return value:  Pointer to the leaf.
+ * Tip:           Every leaf under a node shares the whole prefix of the node.
+ */
+P_TRIER_LEAF _treMinLeafTrieR(void * p)
+{
+	size_t i;
+	UCHART c;
+	while (_TRIER_LEAF != _TRIER_KIND(p))
+	{
+		if (NULL != ((_P_TRIERNODE)p)->pterm)
+			return ((_P_TRIERNODE)p)->pterm;
+		i = 0;
+		p = *_treNextChildTrieR((_P_TRIERNODE)p, &i, &c);
+	}
+	return (P_TRIER_LEAF)p;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _trePrefixMismatchTrieR
+ * Description:   Compare the prefix of a node with a key.
+ * Parameters:
+ *         pn Pointer to an inner node.
+ *       pkey Pointer to the key.
+ *       klen Number of bytes in the key.
+ *      depth Number of bytes of the key consumed above the node.
+ * Return value:  Number of prefix bytes that the key matches.
+ */
+size_t _trePrefixMismatchTrieR(_P_TRIERNODE pn, const UCHART * pkey, size_t klen, size_t depth)
+{
+	REGISTER size_t i, n = pn->plen < _TRIER_PREFIX ? pn->plen : _TRIER_PREFIX;
+	for (i = 0; i < n && depth + i < klen && pn->prefix[i] == pkey[depth + i]; ++i)
+		;
+	if (i == _TRIER_PREFIX && i < pn->plen)
+	{	/* Bytes that are not stored are read from a leaf. */
+		REGISTER PUCHAR pk = _TRIER_LEAFKEY(_treMinLeafTrieR(pn));
+		for (; i < pn->plen && depth + i < klen && pk[depth + i] == pkey[depth + i]; ++i)
+			;
+	}
+	return i;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treHangLeafTrieR
+ * Description:   Hang a leaf on a node either as a child or as the terminal leaf.
+ * Parameters:
+ *         pn Pointer to an inner node that has room for another child.
+ *         pl Pointer to the leaf.
+ *      depth Number of bytes of the key of pl consumed down to the children of pn.
+ * Return value:  N/A.
+ */
+void _treHangLeafTrieR(_P_TRIERNODE pn, P_TRIER_LEAF pl, size_t depth)
+{
+	if (pl->len == depth)
+		pn->pterm = pl;
+	else
+		_treAddChildTrieR(pn, _TRIER_LEAFKEY(pl)[depth], pl);
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treTidyNodeTrieR
+ * Description:   Free, merge or shrink a node that has lost a child or its terminal leaf.
+ * Parameter:
+ *       pref Pointer to the slot that holds the node.
+ * Return value:  N/A.
+ * Tip:           Shrinking is skipped on allocation failure. The node stays valid as it is.
+ */
+void _treTidyNodeTrieR(void ** pref)
+{
+	REGISTER _P_TRIERNODE pn = (_P_TRIERNODE) *pref, pnew;
+	if (0 == pn->num)
+	{	/* The terminal leaf, if any, stands for the node alone. */
+		*pref = pn->pterm;
+		free(pn);
+	}
+	else if (1 == pn->num && NULL == pn->pterm)
+	{
+		size_t i = 0;
+		UCHART c;
+		REGISTER void * pchild = *_treNextChildTrieR(pn, &i, &c);
+		if (_TRIER_LEAF != _TRIER_KIND(pchild))
+		{	/* The child takes over the prefix of the node and the byte that leads to it. */
+			REGISTER _P_TRIERNODE pcn = (_P_TRIERNODE) pchild;
+			UCHART prefix[_TRIER_PREFIX];
+			REGISTER size_t n = pn->plen < _TRIER_PREFIX ? pn->plen : _TRIER_PREFIX;
+			memcpy(prefix, pn->prefix, n);
+			if (n < _TRIER_PREFIX)
+				prefix[n++] = c;
+			if (n < _TRIER_PREFIX)
+				memcpy(prefix + n, pcn->prefix, _TRIER_PREFIX - n);
+			memcpy(pcn->prefix, prefix, _TRIER_PREFIX);
+			pcn->plen += pn->plen + 1;
+		}
+		*pref = pchild;
+		free(pn);
+	}
+	else if ((_TRIER_N16 == pn->kind && pn->num <= 3) ||
+		(_TRIER_N48 == pn->kind && pn->num <= 12) ||
+		(_TRIER_N256 == pn->kind && pn->num <= 40))
+	{
+		if (NULL != (pnew = _treResizeNodeTrieR(pn, (UCHART)(pn->kind - 1))))
+			*pref = pnew;
+	}
+}
+
+/* Function name: treInitTrieR
+ * Description:   Initialize an adaptive radix trie.
+ * Parameter:
+ *      ptrie Pointer to a trie you want to initialize.
+ * Return value:  N/A.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ */
+void treInitTrieR(P_TRIE_R ptrie)
+{
+	ptrie->proot = NULL;
+	ptrie->num   = 0;
+}
+
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treFreeNodesTrieR
+ * Description:   Free a node and all its descendants.
+ * Parameter:
+ *          p Pointer to a leaf or an inner node.
+ * Return value:  N/A.
+ */
+void _treFreeNodesTrieR(void * p)
+{
+	if (_TRIER_LEAF != _TRIER_KIND(p))
+	{
+		REGISTER void ** ppc;
+		size_t i = 0;
+		UCHART c;
+		if (NULL != ((_P_TRIERNODE)p)->pterm)
+			free(((_P_TRIERNODE)p)->pterm);
+		while (NULL != (ppc = _treNextChildTrieR((_P_TRIERNODE)p, &i, &c)))
+			_treFreeNodesTrieR(*ppc);
+	}
+	free(p);
+}
+
+/* Function name: treFreeTrieR
+ * Description:   Retract an adaptive radix trie which is allocated by function treInitTrieR.
+ * Parameter:
+ *      ptrie Pointer to a trie you want to release.
+ * Return value:  N/A.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ */
+void treFreeTrieR(P_TRIE_R ptrie)
+{
+	if (NULL != ptrie->proot)
+		_treFreeNodesTrieR(ptrie->proot);
+	treInitTrieR(ptrie);
+}
+
+/* Function name: treCreateTrieR
+ * Description:   Allocate a new adaptive radix trie dynamically.
+ * Parameters:    N/A.
+ * Return value:  Pointer to the new allocated trie.
+ */
+P_TRIE_R treCreateTrieR(void)
+{
+	REGISTER P_TRIE_R ptrie = (P_TRIE_R) malloc(sizeof(TRIE_R));
+	if (NULL != ptrie)
+		treInitTrieR(ptrie);
+	return ptrie;
+}
+
+/* Function name: treDeleteTrieR
+ * Description:   Delete an adaptive radix trie which is allocated by function treCreateTrieR.
+ * Parameter:
+ *      ptrie Pointer to a trie you want to delete.
+ * Return value:  N/A.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ */
+void treDeleteTrieR(P_TRIE_R ptrie)
+{
+	treFreeTrieR(ptrie);
+	free(ptrie);
+}
+
+/* Function name: treSearchTrieR
+ * Description:   Search a string in an adaptive radix trie.
+ * Parameters:
+ *      ptrie Pointer to a trie of which you want to operate on.
+ *       pstr Pointer to the first element to a string and cast it into (const void *).
+ *        num Number of elements in the string.
+ *       size Size of each element in the string.
+ * Return value:  Pointer to the value that contains vapdx stored in the trie.
+ *                NULL indicates that the string cannot be found in the trie.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ * Tip:           Strings are compared as bytes, so that elements need no comparison function.
+ */
+size_t * treSearchTrieR(P_TRIE_R ptrie, const void * pstr, size_t num, size_t size)
+{
+	REGISTER void * p = ptrie->proot;
+	REGISTER const UCHART * pkey = (const UCHART *) pstr;
+	REGISTER size_t depth = 0;
+	const size_t klen = num * size;
+	while (NULL != p)
+	{
+		REGISTER _P_TRIERNODE pn;
+		if (_TRIER_LEAF == _TRIER_KIND(p))
+			return _treMatchLeafTrieR((P_TRIER_LEAF)p, pkey, klen) ? &((P_TRIER_LEAF)p)->vapdx : NULL;
+		pn = (_P_TRIERNODE)p;
+		if (pn->plen > 0)
+		{	/* Compare stored bytes of the prefix only. The leaf checks the whole key at last. */
+			if (depth + pn->plen > klen ||
+				0 != memcmp(pn->prefix, pkey + depth, pn->plen < _TRIER_PREFIX ? pn->plen : _TRIER_PREFIX))
+				return NULL;
+			depth += pn->plen;
+		}
+		if (depth == klen)
+			p = pn->pterm;
+		else
+		{
+			REGISTER void ** ppc = _treFindChildTrieR(pn, pkey[depth++]);
+			p = NULL != ppc ? *ppc : NULL;
+		}
+	}
+	return NULL;
+}
+
+/* Function name: treInsertTrieR
+ * Description:   Insert a string into an adaptive radix trie.
+ * Parameters:
+ *      ptrie Pointer to a trie of which you want to operate on.
  *       pstr Pointer to the first element to a string and cast the pointer into (const void *).
  *        num Number of elements in the string.
  *       size Size of each element in the string.
  *      vapdx An integer in size_t as an appendix that can store a pointer in a trie.
- *            You may get a pointer to the value that contains vapdx stored in a trie after calling function treSearchTrieA.
- *     cbfcmp Pointer to a callback comparison function.
- *            Two parameters of this callback function may point to any element in the string and in the trie.
- *            Please refer to the prototype of callback function CBF_COMPARE in file svdef.h.
  * Return value:  true  Insertion succeeded.
- *                false Insertion failed.
- * Caution:       ptrie must be allocated first.
+ *                false Allocation failure. The trie would not be altered.
+ * Caution:       Address of ptrie Must Be Allocated first.
  *                Value vapdx that stored with a string in trie will be replaced if users insert the same string repeatedly.
- * Tip:           Inserting the same string in multiple times is allowed for this trie implementation;
- *                Then deletion of the same string needs to be perform on the same trie in the same times.
  */
-bool treInsertTrieA(P_TRIE_A ptrie, const void * pstr, size_t num, size_t size, size_t vapdx, CBF_COMPARE cbfcmp)
+bool treInsertTrieR(P_TRIE_R ptrie, const void * pstr, size_t num, size_t size, size_t vapdx)
 {
-	REGISTER size_t j;
-	REGISTER PUCHAR pdat;
-	REGISTER PUCHAR pbase = (PUCHAR) pstr;
-	for (j = 0; j < num; ++j, pbase += size, ptrie = (P_TRIE_A) &pdat[size])
+	REGISTER void ** pref = &ptrie->proot;
+	REGISTER const UCHART * pkey = (const UCHART *) pstr;
+	REGISTER size_t depth = 0, m;
+	REGISTER _P_TRIERNODE pn;
+	const size_t klen = num * size;
+	P_TRIER_LEAF pnew;
+	size_t * pv;
+	if (NULL != (pv = treSearchTrieR(ptrie, pstr, num, size)))
 	{
-		if (NULL != *ptrie)
+		*pv = vapdx;
+		return true;
+	}
+	if (NULL == (pnew = _treCreateLeafTrieR(pkey, klen, vapdx)))
+		return false;
+	for (;;)
+	{
+		REGISTER void * p = *pref;
+		if (NULL == p)
 		{
-			if (NULL != (pdat = (PUCHAR) strBinarySearchArrayZ(*ptrie, pbase, _ELESIZ(size), cbfcmp)))
-			{
-				++ *(size_t *) &pdat[size + sizeof(TRIE_A)]; /* Increase reference counter. */
-				continue; /* Found, then search the next element in string. */
+			*pref = pnew;
+			break;
+		}
+		if (_TRIER_LEAF == _TRIER_KIND(p))
+		{	/* Expand the leaf into a node where the two keys depart. */
+			REGISTER P_TRIER_LEAF pl = (P_TRIER_LEAF) p;
+			REGISTER PUCHAR pk = _TRIER_LEAFKEY(pl);
+			for (m = depth; m < klen && m < pl->len && pk[m] == pkey[m]; ++m)
+				;
+			if (NULL == (pn = _treCreateNodeTrieR(_TRIER_N4)))
+				goto Lbl_Allocation_Failure;
+			pn->plen = m - depth;
+			memcpy(pn->prefix, pkey + depth, pn->plen < _TRIER_PREFIX ? pn->plen : _TRIER_PREFIX);
+			_treHangLeafTrieR(pn, pl, m);
+			_treHangLeafTrieR(pn, pnew, m);
+			*pref = pn;
+			break;
+		}
+		pn = (_P_TRIERNODE) p;
+		if (pn->plen > 0)
+		{
+			if ((m = _trePrefixMismatchTrieR(pn, pkey, klen, depth)) < pn->plen)
+			{	/* Split the prefix. A new node takes the matched part and the old node keeps the part after the branch. */
+				REGISTER _P_TRIERNODE pup;
+				REGISTER PUCHAR pfull = pn->plen > _TRIER_PREFIX ? _TRIER_LEAFKEY(_treMinLeafTrieR(pn)) + depth : pn->prefix;
+				if (NULL == (pup = _treCreateNodeTrieR(_TRIER_N4)))
+					goto Lbl_Allocation_Failure;
+				pup->plen = m;
+				memcpy(pup->prefix, pfull, m < _TRIER_PREFIX ? m : _TRIER_PREFIX);
+				_treAddChildTrieR(pup, pfull[m], pn);
+				pn->plen -= m + 1;
+				memmove(pn->prefix, pfull + m + 1, pn->plen < _TRIER_PREFIX ? pn->plen : _TRIER_PREFIX);
+				_treHangLeafTrieR(pup, pnew, depth + m);
+				*pref = pup;
+				break;
 			}
-			else
-			{	/* Find the maximal value that is less than (*pbase) to index i.
-				 * This procedure would reduce the worst case of searching complexity to approximately O(log n),
-				 * but not restrict to the worst case of O(n) by using linear search.
-				 */
-				REGISTER PUCHAR p = (PUCHAR)svBinarySearchDispatch
-				(
-					pbase,
-					(*ptrie)->pdata,
-					strLevelArrayZ(*ptrie),
-					_ELESIZ(size),
-					cbfcmp,
-					EBS_LAST_LESS_THAN_OR_EQUAL_TO_KEY
-				);
-				REGISTER size_t i = NULL == p ? 0 : (size_t)svIndexOf((*ptrie)->pdata, p, _ELESIZ(size)) + 1;
-				if (NULL == strResizeArrayZ(*ptrie, strLevelArrayZ(*ptrie) + 1, _ELESIZ(size)))
-					return false; /* Allocation failure. */
-				else
-				{	/* Insert new item. */
-					pdat = (PUCHAR)memcpy
-					(	/* Leave spaces to the new element. */
-						(PUCHAR)memmove
-						(
-							(*ptrie)->pdata + (i + 1) * _ELESIZ(size),
-							(*ptrie)->pdata + i * _ELESIZ(size),
-							(strLevelArrayZ(*ptrie) - 1 - i) * _ELESIZ(size)
-						) - _ELESIZ(size),
-						pbase,
-						size
-					);
-				}
+			depth += pn->plen;
+		}
+		if (depth == klen)
+		{	/* A terminal leaf here would have been found by the search above. */
+			pn->pterm = pnew;
+			break;
+		}
+		{
+			REGISTER void ** ppc = _treFindChildTrieR(pn, pkey[depth]);
+			if (NULL != ppc)
+			{
+				pref = ppc;
+				++depth;
+				continue;
 			}
 		}
-		else
+		if (_treIsFullTrieR(pn))
 		{
-			if (NULL == (*ptrie = strCreateArrayZ(1, _ELESIZ(size))))
-				return false; /* Allocation failure. */
-			else
-				pdat = (PUCHAR) memcpy((*ptrie)->pdata, pbase, size);
+			if (NULL == (pn = _treResizeNodeTrieR(pn, (UCHART)(pn->kind + 1))))
+				goto Lbl_Allocation_Failure;
+			*pref = pn;
 		}
-		/* Initialize new block. */
-		*(P_TRIE_A)  &pdat[size] = NULL; /* pnext. */
-		*(size_t *)  &pdat[size + sizeof(TRIE_A)] = 1; /* Reference counter. */
-		*((size_t *) &pdat[size + sizeof(TRIE_A) + sizeof(size_t)]) = 0; /* Appendix. */
-		*((size_t *) &pdat[size + sizeof(TRIE_A) + sizeof(size_t) + sizeof(size_t)]) = false; /* Flag. */
+		_treAddChildTrieR(pn, pkey[depth], pnew);
+		break;
 	}
-	/* Bypass reference counter and assign appendix onto the right position. */
-	*((size_t *) &(sizeof(TRIE_A) + sizeof(size_t))[(PUCHAR) ptrie]) = vapdx;
-	/* Set the flag on the tail of string in trie into valid. */
-	*((size_t *) &(sizeof(TRIE_A) + sizeof(size_t) + sizeof(size_t))[(PUCHAR) ptrie]) = true;
+	++ptrie->num;
 	return true;
+Lbl_Allocation_Failure:
+	free(pnew);
+	return false;
 }
 
-/* Function name: treRemoveTrieA
- * Description:   Remove a string from a trie.
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treRemoveNodeTrieR
+ * Description:   Remove a key under a node.
+ * Parameters:
+ *       pref Pointer to the slot that holds the node.
+ *       pkey Pointer to the key.
+ *       klen Number of bytes in the key.
+ *      depth Number of bytes of the key consumed above the node.
+ * Return value:  true if the key has been removed.
+ */
+bool _treRemoveNodeTrieR(void ** pref, const UCHART * pkey, size_t klen, size_t depth)
+{
+	REGISTER void * p = *pref;
+	REGISTER _P_TRIERNODE pn;
+	if (NULL == p)
+		return false;
+	if (_TRIER_LEAF == _TRIER_KIND(p))
+	{
+		if (! _treMatchLeafTrieR((P_TRIER_LEAF)p, pkey, klen))
+			return false;
+		free(p);
+		*pref = NULL;
+		return true;
+	}
+	pn = (_P_TRIERNODE)p;
+	if (pn->plen > 0)
+	{
+		if (depth + pn->plen > klen ||
+			0 != memcmp(pn->prefix, pkey + depth, pn->plen < _TRIER_PREFIX ? pn->plen : _TRIER_PREFIX))
+			return false;
+		depth += pn->plen;
+	}
+	if (depth == klen)
+	{
+		if (NULL == pn->pterm || ! _treMatchLeafTrieR(pn->pterm, pkey, klen))
+			return false;
+		free(pn->pterm);
+		pn->pterm = NULL;
+	}
+	else
+	{
+		REGISTER void ** ppc = _treFindChildTrieR(pn, pkey[depth]);
+		if (NULL == ppc || ! _treRemoveNodeTrieR(ppc, pkey, klen, depth + 1))
+			return false;
+		if (NULL == *ppc)
+			_treRemoveChildTrieR(pn, pkey[depth]);
+	}
+	_treTidyNodeTrieR(pref);
+	return true;
+}
+
+/* Function name: treRemoveTrieR
+ * Description:   Remove a string from an adaptive radix trie.
  * Parameters:
  *      ptrie Pointer to a trie that you want to operate on.
  *       pstr Pointer to the first element to a string and cast the pointer into (const void *).
  *        num Number of elements in the string.
  *       size Size of each element in the string.
- *     cbfcmp Pointer to a callback comparison function.
- *            Two parameters of this callback function may point to any element in the string and in the trie.
- *            Please refer to the prototype of callback function CBF_COMPARE in file svdef.h.
  * Return value:  true  Removal succeeded.
- *                false Removal failed.
- * Caution:       ptrie must be allocated first.
+ *                false Cannot find the string.
+ * Caution:       Address of ptrie Must Be Allocated first.
  */
-bool treRemoveTrieA(P_TRIE_A ptrie, const void * pstr, size_t num, size_t size, CBF_COMPARE cbfcmp)
+bool treRemoveTrieR(P_TRIE_R ptrie, const void * pstr, size_t num, size_t size)
 {
-	bool r = false;
-	P_STACK_L pstk; /* Stores every data to be erased. */
-	const P_TRIE_A pot = ptrie; /* Stores the original header of trie. */
-	REGISTER PUCHAR pbase = (PUCHAR) pstr;
-	/* In the following structure, pdat is the pointer that leads data in array (*trie). */
-	struct { TRIE_A trie; PUCHAR pdat; } eleset;
-	if ((0 == num || 0 == size) || NULL == (pstk = stkCreateL()))
-		return false; /* Allocation failure. */
-	/* Traverse trie to pick elements that to be deleted into a stack. */
-	while (NULL != *ptrie && 0 != num)
-	{
-		REGISTER PUCHAR pdat = (PUCHAR) strBinarySearchArrayZ(*ptrie, pbase, _ELESIZ(size), cbfcmp);
-		if (NULL == pdat)
-			goto Lbl_Clear;
-		else
-		{
-			eleset.trie = *ptrie;
-			eleset.pdat = pdat;
-			if (NULL == stkPushL(pstk, &eleset, sizeof(eleset)))
-				goto Lbl_Clear;
-		}
-		ptrie = (P_TRIE_A) &pdat[size];
-		--num;
-		pbase += size;
-	}
-	if (0 == num)
-	{
-		size_t * pflag = ((size_t *) &(sizeof(TRIE_A) + sizeof(size_t) + sizeof(size_t))[(PUCHAR) ptrie]);
-		if (! (*pflag)) /* Avoid to delete a found sub string. false == *pflag */
-			goto Lbl_Clear;
-		else
-		{
-			REGISTER TRIE_A tprev = NULL; /* Previous trie record. */
-			if (*((size_t *) &(sizeof(TRIE_A))[(PUCHAR) ptrie]) < 2)
-				*pflag = false; /* Unflag. */
-			while (! stkIsEmptyL(pstk))
-			{	/* Pop elements to be deleted one by one that previously collected in the stack. */
-				stkPopL(&eleset, sizeof(eleset), pstk);
-				/* Erase the previous child pointer in parent node. */
-				if (NULL != tprev)
-				{
-					*(P_TRIE_A)&eleset.pdat[size] = NULL;
-					tprev = NULL;
-				}
-				/* Pick an element in array away by reducing reference counter. */
-				if (0 == --*(size_t *)&eleset.pdat[size + sizeof(TRIE_A)])
-				{
-					strRemoveItemArrayZ
-					(
-						eleset.trie,
-						_ELESIZ(size),
-						(size_t)svIndexOf(eleset.trie->pdata, eleset.pdat, _ELESIZ(size)),
-						true
-					);
-					/* If there are not exist elements in the set, then remove array entity either. */
-					if (0 == strLevelArrayZ(eleset.trie))
-					{
-						tprev = eleset.trie; /* Save a deleted pointer and remove it in its parent later. */
-						strDeleteArrayZ(eleset.trie);
-						if (*pot == tprev)
-							*pot = NULL; /* Removal reaches at the root of trie. */
-					}
-				}
-			}
-			r = true;
-		}
-	}
-Lbl_Clear:
-	stkDeleteL(pstk);
-	return r;
+	if (! _treRemoveNodeTrieR(&ptrie->proot, (const UCHART *) pstr, num * size, 0))
+		return false;
+	--ptrie->num;
+	return true;
 }
 
-#undef _ELESIZ /* Undefine a used macro here to avert users mistakenly touching it. */
+/* Attention:     This Is An Internal Function. No Interface for Library Users.
+ * Function name: _treTraverseNodeTrieR
+ * Description:   Traverse leaves under a node in ascending order of keys.
+ * Parameters:
+ *          p Pointer to a leaf or an inner node.
+ *     cbftvs Pointer to a callback function to traverse.
+ *      param A size_t value which can be transferred into callback function.
+ * Return value:  The same value as callback function returns.
+ */
+int _treTraverseNodeTrieR(void * p, CBF_TRAVERSE cbftvs, size_t param)
+{
+	REGISTER void ** ppc;
+	size_t i = 0;
+	UCHART c;
+	if (_TRIER_LEAF == _TRIER_KIND(p))
+		return cbftvs(p, param);
+	/* A key that ends at a node is less than every key under its children. */
+	if (NULL != ((_P_TRIERNODE)p)->pterm && CBF_CONTINUE != cbftvs(((_P_TRIERNODE)p)->pterm, param))
+		return CBF_TERMINATE;
+	while (NULL != (ppc = _treNextChildTrieR((_P_TRIERNODE)p, &i, &c)))
+		if (CBF_CONTINUE != _treTraverseNodeTrieR(*ppc, cbftvs, param))
+			return CBF_TERMINATE;
+	return CBF_CONTINUE;
+}
+
+/* Function name: treTraverseTrieR
+ * Description:   Traverse each key in an adaptive radix trie in ascending order of bytes.
+ * Parameters:
+ *      ptrie Pointer to the trie.
+ *     cbftvs Pointer to a callback function to traverse.
+ *            Parameter pitem of callback function points to a TRIER_LEAF structure.
+ *            Bytes of the key follow the structure, that is (PUCHAR)((P_TRIER_LEAF)pitem + 1).
+ *      param A size_t value which can be transferred into callback function.
+ * Return value:  The same value as callback function returns.
+ * Caution:       Address of ptrie Must Be Allocated first.
+ *                Do not insert keys into or remove keys from the trie in callback function.
+ */
+int treTraverseTrieR(P_TRIE_R ptrie, CBF_TRAVERSE cbftvs, size_t param)
+{
+	if (NULL == ptrie->proot)
+		return CBF_CONTINUE;
+	return _treTraverseNodeTrieR(ptrie->proot, cbftvs, param);
+}
+
+#undef _TRIER_PREFIX
+#undef _TRIER_LEAF
+#undef _TRIER_N4
+#undef _TRIER_N16
+#undef _TRIER_N48
+#undef _TRIER_N256
+#undef _TRIER_KIND
+#undef _TRIER_LEAFKEY
+#undef _TRIER_KEYS
+#undef _TRIER_KIDS
+/* Undefine used macros for this section. */
 
@@ -2,7 +2,7 @@
  * Name:        svstring.h
  * Description: Strings interface.
  * Author:      cosh.cage#hotmail.com
- * File ID:     0306170921Y0821260552L00536
+ * File ID:     0306170921Y1018262226L00587
  * License:     LGPLv3
  * Copyright (C) 2017-2026 John Cage
  *
@@ -123,6 +123,30 @@ typedef struct st_SPAMAT {
 	LIST_S  datlst; /* Data list. */
 } SPAMAT, * P_SPAMAT;
 
+/* Vector. A sized array that tracks its capacity, so that appending costs amortized O(1) time.
+ * arrz.num is the number of elements in use and arrz can be passed wherever a P_ARRAY_Z is accepted,
+ * except to functions that reallocate the array, such as strResizeArrayZ, or cap would be stale.
+ */
+typedef struct st_VECTOR {
+	ARRAY_Z arrz; /* Elements of the vector. */
+	size_t  cap;  /* Number of elements that the buffer can hold. */
+} VECTOR, * P_VECTOR;
+
+/* Aho-Corasick automaton that matches a set of byte string patterns in a single pass. */
+typedef struct st_AHOCORASICK {
+	ARRAY_Z trans; /* Dense transition table. Each state owns a row of (UCHAR_MAX + 1) next states of type size_t. */
+	ARRAY_Z outs;  /* Three size_t values for each state: the pattern ending at it, its dictionary suffix link and its depth. */
+	size_t  nstat; /* Number of states. */
+	size_t  state; /* Current state of the stream. */
+	size_t  pos;   /* Number of bytes fed into the stream. */
+} AHOCORASICK, * P_AHOCORASICK;
+
+/* A match that an Aho-Corasick automaton reports to callback functions. */
+typedef struct st_ACMATCH {
+	size_t index;  /* Index of the pattern in the array of patterns. */
+	size_t offset; /* Offset of the first byte of the match in the stream. */
+} ACMATCH, * P_ACMATCH;
+
 /* A structure describes finding information for nodes. */
 typedef struct st_FindingInfo {
 	void *       result; /* Finding result. */
@@ -142,9 +166,19 @@ int         svCBFCompareSignedCharacter    (const void * px,       const void *
 void        svShellSort                    (void *       pbase,    void *       ptemp,     size_t       num,     size_t       size,   CBF_COMPARE cbfcmp);
 void *      svQuickSort                    (void *       pbase,    size_t       num,       size_t       size,    CBF_COMPARE  cbfcmp);
 void *      svMergeSort                    (void *       pbase,    size_t       num,       size_t       size,    CBF_COMPARE  cbfcmp);
+void *      svTimSort                      (void *       pbase,    size_t       num,       size_t       size,    CBF_COMPARE  cbfcmp);
 void *      svHeapSort                     (void *       pbase,    size_t       num,       size_t       size,    CBF_COMPARE  cbfcmp);
+void *      svIntroSort                    (void *       pbase,    size_t       num,       size_t       size,    CBF_COMPARE  cbfcmp);
+void *      svNthElement                   (void *       pbase,    size_t       num,       size_t       size,    CBF_COMPARE  cbfcmp, size_t      n);
+void *      svPartialSort                  (void *       pbase,    size_t       num,       size_t       size,    CBF_COMPARE  cbfcmp, size_t      k);
+void *      svRadixSortInteger             (void *       pbase,    size_t       num,       size_t       size,    size_t       offset, size_t      width, bool bsigned);
+void *      svRadixSortBytes               (void *       pbase,    size_t       num,       size_t       size,    size_t       offset, size_t      width);
+void *      svParallelSort                 (void *       pbase,    size_t       num,       size_t       size,    CBF_COMPARE  cbfcmp, size_t      nthread, bool bstable);
+size_t *    svArgSort                      (const void * pbase,    size_t       num,       size_t       size,    CBF_COMPARE  cbfcmp, size_t *    pidx);
+void *      svPermute                      (void *       pbase,    size_t       num,       size_t       size,    size_t *     pidx);
 void *      svBinarySearch                 (const void * pkey,     const void * pbase,     size_t       num,     size_t       size,   CBF_COMPARE cbfcmp);
 void *      svBinarySearchDispatch         (const void * pkey,     const void * pbase,     size_t       num,     size_t       size,   CBF_COMPARE cbfcmp, BSearch method);
+bool        svBatchBinarySearch            (const void * pkeys,    size_t       nkey,      size_t       ksize,   const void * pbase,  size_t      num,    size_t size, CBF_COMPARE cbfcmp, BSearch method, void ** presult);
 ptrdiff_t   svIndexOf_O                    (const void * pbase,    const void * pitem,     size_t       size);
 /* Atomic element function declarations here. */
 void *      strInitArrayZ                  (P_ARRAY_Z    parrz,    size_t       num,       size_t       size);
@@ -178,14 +212,31 @@ void        strRemoveItemArrayZ            (P_ARRAY_Z    parrz,    size_t
 void *      strSortArrayZ                  (P_ARRAY_Z    parrz,    size_t       size,      CBF_COMPARE  cbfcmp,  bool         bstable);
 void *      strMergeSortedArrayZ           (P_ARRAY_Z    pdest,    P_ARRAY_Z    psrc,      size_t       size,    CBF_COMPARE  cbfcmp);
 void *      strBinarySearchArrayZ_O        (P_ARRAY_Z    parrz,    const void * pkey,      size_t       size,    CBF_COMPARE  cbfcmp);
+void *      strEytzingerArrayZ             (P_ARRAY_Z    pdest,    P_ARRAY_Z    psrc,      size_t       size);
+void *      strSearchEytzingerArrayZ       (P_ARRAY_Z    parrz,    const void * pkey,      size_t       size,    CBF_COMPARE  cbfcmp, BSearch     method);
 void        strReverseArrayZ               (P_ARRAY_Z    parrz,    void *       ptemp,     size_t       size);
 void *      strGetLimitationArrayZ         (P_ARRAY_Z    parrz,    size_t       size,      CBF_COMPARE  cbfcmp,  bool         bmax,   bool        brev);
 void        strUniqueArrayZ                (P_ARRAY_Z    parrz,    void *       ptemp,     size_t       size,    CBF_COMPARE  cbfmch, bool        bshrink);
+void *      strSortUniqueArrayZ            (P_ARRAY_Z    parrz,    size_t       size,      CBF_COMPARE  cbfcmp,  bool         bshrink);
+void *      strStableUniqueArrayZ          (P_ARRAY_Z    parrz,    size_t       size,      CBF_COMPARE  cbfcmp,  bool         bshrink);
 bool        strPermuteArrayZ               (P_ARRAY_Z    parrz,    void *       ptemp,     size_t       size,    CBF_COMPARE  cbfcmp, bool        bnext);
 bool        strCombineNextArrayZ           (P_ARRAY_Z    parrzr,   P_ARRAY_Z    parrzn,    size_t       size,    CBF_COMPARE  cbfcmp);
 void        strShuffleArrayZ               (P_ARRAY_Z    parrz,    void *       ptemp,     size_t       size,    size_t     (*nxtrnd)(void));
 int         strKMPSearchArrayZ             (P_ARRAY_Z    parrtxt,  P_ARRAY_Z    parrptn,   size_t       size,    CBF_TRAVERSE cbftvs, size_t      param);
 int         strZSearchArrayZ               (P_ARRAY_Z    parrtxt,  P_ARRAY_Z    parrptn,   size_t       size,    CBF_TRAVERSE cbftvs, size_t      param);
+/* Functions for vectors. */
+void *      strInitVector                  (P_VECTOR     pvec,     size_t       cap,       size_t       size);
+void        strFreeVector                  (P_VECTOR     pvec);
+void *      strReserveVector               (P_VECTOR     pvec,     size_t       cap,       size_t       size);
+void *      strResizeVector                (P_VECTOR     pvec,     size_t       num,       size_t       size);
+void *      strShrinkVector                (P_VECTOR     pvec,     size_t       size);
+void *      strPushVector                  (P_VECTOR     pvec,     const void * pitem,     size_t       size);
+bool        strPopVector                   (P_VECTOR     pvec,     void *       pitem,     size_t       size);
+/* Functions for Aho-Corasick automata. */
+bool        strInitAhoCorasick             (P_AHOCORASICK pac,     P_ARRAY_Z    parrptn);
+void        strFreeAhoCorasick             (P_AHOCORASICK pac);
+void        strResetAhoCorasick            (P_AHOCORASICK pac);
+int         strFeedAhoCorasick             (P_AHOCORASICK pac,     const void * pbuf,      size_t       num,     CBF_TRAVERSE cbftvs, size_t      param);
 /* Functions for singular pointer linked lists. */
 int         strTraverseLinkedListSC_R      (LIST_S       list,     P_NODE_S     pnil,      CBF_TRAVERSE cbftvs,  size_t       param);
 int         strTraverseLinkedListSC_A      (LIST_S       list,     P_NODE_S     pnil,      CBF_TRAVERSE cbftvs,  size_t       param);
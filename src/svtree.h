@@ -2,7 +2,7 @@
  * Name:        svtree.h
  * Description: Trees interface.
  * Author:      cosh.cage#hotmail.com
- * File ID:     0809171737V0820260949L00539
+ * File ID:     0809171737V1018262351L00777
  * License:     LGPLv3
  * Copyright (C) 2017-2026 John Cage
  *
@@ -24,6 +24,7 @@
 #ifndef _SVTREE_H_
 #define _SVTREE_H_
 
+#include <stdio.h> /* Using type FILE. */
 #include "svstring.h"
 
 /* The following two macros are used to direct nodes for TNODE_BY structures in binary trees. */
@@ -60,9 +61,31 @@ typedef struct st_RBTNODE {
 	struct st_RBTNODE * parent; /* A pointer to parent node. */
 } RBTNODE, * P_RBTNODE, * RBT, ** P_RBT;
 
+/* Depth of the ancestor stack in a BST cursor.
+ * It covers any AA, AVL or red black tree that could ever be addressed by a size_t.
+ */
+#define BST_CURSOR_DEPTH (2 * CHAR_BIT * sizeof(size_t))
+
+/* A cursor that walks through a binary search tree in order without recursion and callbacks. */
+typedef struct st_BSTCURSOR {
+	P_BSTNODE proot;                    /* Root node of the tree to iterate. */
+	P_BSTNODE pnode;                    /* Current node. NULL means the cursor is off the tree. */
+	size_t    depth;                    /* Number of ancestors of pnode in pstack. */
+	P_BSTNODE pstack[BST_CURSOR_DEPTH]; /* Ancestors of the current node from root to parent. */
+} BSTCURSOR, * P_BSTCURSOR;
+
+/* Binary search tree node with a reference counter for persistent AA-trees.
+ * Unchanged subtrees are shared among versions of a tree.
+ */
+typedef struct st_PSTNODE {
+	BSTNODE bstn; /* Binary search tree block. Parameter is the level of an AA-tree node. */
+	size_t  refc; /* Reference counter. Number of parents and snapshots that refer to this node. */
+} PSTNODE, * P_PSTNODE, * PST, ** P_PST;
+
 #define P2P_TNODE_BY(pnode) ((P_TNODE_BY) (pnode)) /* Cast a pointer to P_TNODE_BY. */
 #define P2P_BSTNODE(pnode)  ((P_BSTNODE)  (pnode)) /* Cast a pointer to P_BSTNODE. */
 #define P2P_RBTNODE(pnode)  ((P_RBTNODE)  (pnode)) /* Cast a pointer to P_RBTNODE. */
+#define P2P_PSTNODE(pnode)  ((P_PSTNODE)  (pnode)) /* Cast a pointer to P_PSTNODE. */
 
 /* Types for generic tree nodes. */
 typedef struct st_TNODE_G {
@@ -76,12 +99,108 @@ typedef struct st_HEAP_A {
 	size_t  irear; /* Index of the last element. */
 } HEAP_A, * P_HEAP_A;
 
+/* A bounded heap that keeps the top k elements of a stream. */
+typedef struct st_TOPK_A {
+	HEAP_A      heap;   /* Kept elements. The root is the worst one that is kept. */
+	PUCHAR      ptemp;  /* A buffer to swap elements. */
+	size_t      size;   /* Size of each element. */
+	CBF_COMPARE cbfcmp; /* Comparison function. */
+	bool        bmax;   /* true to keep the greatest elements, false to keep the least. */
+} TOPK_A, * P_TOPK_A;
+
 /* Types for in-memory B-plus trees. */
 typedef NODE_D     BPTNODE;
 typedef P_NODE_D   P_BPTNODE;
 typedef P_NODE_D   BPT;
 typedef P_NODE_D * P_BPT;
 
+/* Number of cache lines that keys of a node occupy in a B-plus tree with inline keys by default. */
+#define BPTF_NODE_LINES (4)
+
+/* Node of in-memory B-plus trees that store fixed-size keys inline.
+ * Keys follow this header in the same block and child pointers of an internal node follow keys.
+ */
+typedef struct st_BPTNODE_F {
+	size_t                num;   /* Number of keys in the node. */
+	size_t                ver;   /* Version. It is odd while a writer is altering the node. */
+	struct st_BPTNODE_F * pnext; /* Next leaf in key chain for leaves. Next node in retired list for retired nodes. */
+	bool                  bleaf; /* true for leaves. */
+} BPTNODE_F, * P_BPTNODE_F;
+
+/* Types for in-memory B-plus trees that store fixed-size keys inline. */
+typedef struct st_BPT_F {
+	P_BPTNODE_F proot;    /* Root node. */
+	size_t      size;     /* Size of each key. */
+	size_t      degree;   /* Maximum number of keys in a node. */
+	P_BPTNODE_F pretired; /* Nodes that left the tree but might still be read by readers. */
+	bool        bshared;  /* true if readers may run alongside a writer. Nodes would be retired instead of freed. */
+} BPT_F, * P_BPT_F;
+
+/* A cursor that scans keys along the key chain of a B-plus tree. */
+typedef struct st_BPTCURSOR {
+	P_BPTNODE pnode; /* Current leaf. NULL means the scan is over. */
+	size_t    index; /* Index of the next key in the current leaf. */
+} BPTCURSOR, * P_BPTCURSOR;
+
+/* A cursor that scans keys along the key chain of a B-plus tree with inline keys. */
+typedef struct st_BPTCURSOR_F {
+	P_BPT_F     pbpt;  /* The tree being scanned. */
+	P_BPTNODE_F pnode; /* Current leaf. NULL means the scan is over. */
+	size_t      index; /* Index of the next key in the current leaf. */
+} BPTCURSOR_F, * P_BPTCURSOR_F;
+
+/* A frame in the buffer pool of a paged B-plus tree. */
+typedef struct st_BPTP_FRAME {
+	size_t page;   /* Number of the page held in this frame. 0 means the frame is empty. */
+	size_t pin;    /* Number of users that are holding this frame. */
+	size_t hnext;  /* Next frame in the same hash bucket. */
+	bool   bdirty; /* true if the frame has not been written back. */
+	bool   bref;   /* Reference bit for clock replacement. */
+	PUCHAR pdata;  /* Content of the page. */
+} BPTP_FRAME, * P_BPTP_FRAME;
+
+/* B-plus trees that store fixed-size keys in fixed-size pages of a file. */
+typedef struct st_BPT_P {
+	FILE *       fp;       /* The file that holds pages. */
+	size_t       size;     /* Size of each key. */
+	size_t       pagesize; /* Size of each page. */
+	size_t       degree;   /* Maximum number of keys in a leaf page. */
+	size_t       fanout;   /* Maximum number of keys in an internal page. */
+	size_t       root;     /* Page number of the root. 0 means the tree is empty. */
+	size_t       pages;    /* Number of pages in the file including the header page. */
+	size_t       freelist; /* The first page in free page list. 0 means the list is empty. */
+	size_t       gen;      /* Generation of the last commit. */
+	size_t       num;      /* Number of keys in the tree. */
+	size_t       frames;   /* Number of frames in the buffer pool. */
+	size_t       hand;     /* Clock hand of the buffer pool. */
+	P_BPTP_FRAME pframe;   /* Frames. */
+	size_t *     pbucket;  /* Hash buckets that map page numbers to frames. */
+	ARRAY_Z      limbo;    /* Pages released since the last commit. */
+	size_t       nlimbo;   /* Number of pages in limbo. */
+} BPT_P, * P_BPT_P;
+
+/* Number of bytes that keys of a node occupy in a B-plus tree with string keys by default. */
+#define BPTS_NODE_BYTES (16 * SV_CACHE_LINE)
+
+/* Node of in-memory B-plus trees that store string keys with prefix compression.
+ * Keys are front coded in a byte area that follows this header and child pointers of an internal node follow the area.
+ */
+typedef struct st_BPTNODE_S {
+	size_t num;   /* Number of keys in the node. */
+	size_t plen;  /* Length of the prefix that every key in the node shares. */
+	size_t used;  /* Number of bytes used in the byte area. */
+	bool   bleaf; /* true for leaves. */
+} BPTNODE_S, * P_BPTNODE_S;
+
+/* Types for in-memory B-plus trees that store string keys with prefix compression. */
+typedef struct st_BPT_S {
+	P_BPTNODE_S proot;     /* Root node. */
+	size_t      nodesize;  /* Size of the byte area of each node. */
+	size_t      num;       /* Number of keys in the tree. */
+	P_BPTNODE_S pspare[2]; /* Spare internal nodes[0] and leaves[1] kept for splitting. */
+	PUCHAR      pwork;     /* Work area for key buffers and a node being rebuilt. */
+} BPT_S, * P_BPT_S;
+
 /* An enumeration for tree traversal methods. */
 typedef enum en_TvsMtd {
 	ETM_PREORDER        = 001, /* Pre-order. */
@@ -111,6 +230,42 @@ typedef struct st_HFM_SYMBOL {
 /* Types for array implemented tries. */
 typedef P_ARRAY_Z TRIE_A, * P_TRIE_A;
 
+/* A string that a trie reports to callback functions. */
+typedef struct st_TRIE_ITEM {
+	const void * pstr;  /* Elements of the string. */
+	size_t       num;   /* Number of elements in the string. */
+	size_t       vapdx; /* Appendix of the string. */
+	size_t       dist;  /* Edit distance from a queried string. 0 for exact queries. */
+} TRIE_ITEM, * P_TRIE_ITEM;
+
+/* A cell of double-array tries. Child of a cell for symbol c lies at base + c and its check is the index of the cell. */
+typedef struct st_TRIED_CELL {
+	size_t base;  /* Base index of children. 0 means no children. */
+	size_t check; /* Index of the parent cell. */
+	size_t vapdx; /* Appendix of a string that ends at this cell. */
+} TRIED_CELL, * P_TRIED_CELL;
+
+/* Types for double-array tries over bytes. */
+typedef struct st_TRIE_D {
+	ARRAY_Z cells; /* Cells. Cell 0 is the root. */
+	size_t  hopen; /* Head of the circular list of free cells that have not failed a base search. */
+	size_t  hshut; /* Head of the circular list of free cells that are left for single children. */
+	size_t  num;   /* Number of strings in the trie. */
+} TRIE_D, * P_TRIE_D;
+
+/* Leaf of adaptive radix tries. Bytes of the key follow this structure. */
+typedef struct st_TRIER_LEAF {
+	UCHART kind;  /* Kind of node. It is always 0 for leaves. */
+	size_t vapdx; /* Appendix. */
+	size_t len;   /* Number of bytes in the key. */
+} TRIER_LEAF, * P_TRIER_LEAF;
+
+/* Types for adaptive radix tries. */
+typedef struct st_TRIE_R {
+	void * proot; /* Root. It points to either a leaf or an inner node. */
+	size_t num;   /* Number of keys in the trie. */
+} TRIE_R, * P_TRIE_R;
+
 /* Functions for binary trees. */
 int             treTraverseBYPre       (P_TNODE_BY      pnode,    CBF_TRAVERSE cbftvs, size_t       param);
 int             treTraverseBYIn        (P_TNODE_BY      pnode,    CBF_TRAVERSE cbftvs, size_t       param);
@@ -165,6 +320,11 @@ void            treMakeEmptyHeapA_O    (P_HEAP_A        pheap);
 bool            treInsertHeapA         (P_HEAP_A        pheap,    const void * pitem,  void *       ptemp,   size_t       size,    CBF_COMPARE  cbfcmp,  bool        bmax);
 bool            treRemoveHeapA         (void *          pitem,    void *       ptemp,  size_t       size,    P_HEAP_A     pheap,   CBF_COMPARE  cbfcmp,  bool        bmax);
 bool            trePeepHeapA           (void *          pitem,    size_t       size,   P_HEAP_A     pheap);
+bool            treInitTopKA           (P_TOPK_A        ptopk,    size_t       k,      size_t       size,    CBF_COMPARE  cbfcmp,  bool        bmax);
+void            treFreeTopKA           (P_TOPK_A        ptopk);
+bool            treOfferTopKA          (P_TOPK_A        ptopk,    const void * pitem);
+int             treCBFOfferTopKA       (void *          pitem,    size_t       param);
+size_t          treDrainTopKA          (P_TOPK_A        ptopk,    void *       pbuf);
 /* Functions for binary search trees(BSTs). */
 void *          treInitBSTNode         (P_BSTNODE       pnode,    const void * pitem,  size_t       size,    size_t       param);
 void            treFreeBSTNode_O       (P_BSTNODE       pnode);
@@ -181,6 +341,15 @@ P_BSTNODE       treBSTInsertAA         (P_BSTNODE       pnode,   const void * pi
 P_BSTNODE       treBSTRemoveAA         (P_BSTNODE       pnode,   const void * pitem,   size_t       size,    CBF_COMPARE  cbfcmp);
 P_BSTNODE       treBSTInsertAVL        (P_BSTNODE       pnode,   const void * pitem,   size_t       size,    CBF_COMPARE  cbfcmp);
 P_BSTNODE       treBSTRemoveAVL        (P_BSTNODE       pnode,   const void * pitem,   size_t       size,    CBF_COMPARE  cbfcmp);
+P_BSTNODE       treBulkBuildAA         (P_ARRAY_Z       parrz,   size_t       size,    bool         bslab);
+P_BSTNODE       treBulkBuildAVL        (P_ARRAY_Z       parrz,   size_t       size,    bool         bslab);
+/* Functions for BST cursors. */
+void            treInitBSTCursor       (P_BSTCURSOR     pcur,    P_BSTNODE    proot);
+void *          treBSTCursorFirst      (P_BSTCURSOR     pcur);
+void *          treBSTCursorLast       (P_BSTCURSOR     pcur);
+void *          treBSTCursorNext       (P_BSTCURSOR     pcur);
+void *          treBSTCursorPrev       (P_BSTCURSOR     pcur);
+void *          treBSTCursorSeek       (P_BSTCURSOR     pcur,    const void * pitem,   CBF_COMPARE  cbfcmp);
 /* Functions for red black trees. */
 void *          treInitRBTNode         (P_RBTNODE       pnode,   const void * pitem,   size_t       size,    RBTColor     color,   P_RBTNODE    parent);
 void            treFreeRBTNode_O       (P_RBTNODE       pnode);
@@ -193,6 +362,15 @@ void            treDeleteRBT_O         (P_RBT           prbt);
 P_RBTNODE       treCopyRBT             (P_RBTNODE       proot,   size_t       size);
 void            treInsertRBT           (P_RBT           prbt,    const void * pitem,   size_t       size,    CBF_COMPARE  cbfcmp);
 void            treRemoveRBT           (P_RBT           prbt,    const void * pitem,   CBF_COMPARE  cbfcmp);
+P_RBTNODE       treRBTExtremum         (P_RBTNODE       proot,   bool         bmax);
+P_RBTNODE       treRBTNeighbor         (P_RBTNODE       pnode,   bool         bnext);
+P_RBTNODE       treRBTLowerBound       (P_RBTNODE       proot,   const void * pitem,   CBF_COMPARE  cbfcmp);
+P_RBTNODE       treBulkBuildRBT        (P_ARRAY_Z       parrz,   size_t       size,    bool         bslab);
+/* Functions for persistent AA-trees. */
+P_PSTNODE       treSnapshotPST         (P_PST           ppst);
+void            treReleasePST          (P_PSTNODE       proot);
+bool            treInsertPST           (P_PST           ppst,    const void * pitem,   size_t       size,    CBF_COMPARE  cbfcmp);
+bool            treRemovePST           (P_PST           ppst,    const void * pitem,   size_t       size,    CBF_COMPARE  cbfcmp);
 /* Functions for B-plus trees. */
 void *          treInitBPTNode         (P_BPTNODE       pnode,   P_TNODE_BY   parent,  P_TNODE_BY   pnext);
 void            treFreeBPTNode         (P_BPTNODE       pnode);
@@ -206,7 +384,43 @@ int             treTraverseKeyBPT      (P_BPT           pbpt,    CBF_TRAVERSE cb
 void *          treSearchDataBPT       (P_BPT           pbpt,    const void * pkey,   CBF_COMPARE   cbfcmp);
 bool            treInsertBPT           (P_BPT           pbpt,    const size_t degree, const void *  pkey,    CBF_COMPARE  cbfcmp);
 bool            treBulkLoadBPT         (P_BPT           pbpt,    const size_t degree, PUCHAR        pkeys[], size_t       num);
+bool            treBatchInsertBPT      (P_BPT           pbpt,    const size_t degree, PUCHAR        pkeys[], size_t       num,     CBF_COMPARE  cbfcmp);
 bool            treRemoveBPT           (P_BPT           pbpt,    const size_t degree, const void *  pkey,    CBF_COMPARE  cbfcmp);
+bool            treBPTCursorSeek       (P_BPTCURSOR     pcur,    P_BPT        pbpt,   const void *  pkey,    CBF_COMPARE  cbfcmp);
+size_t          treBPTCursorFetch      (P_BPTCURSOR     pcur,    PUCHAR       pkeys[], size_t       num,     const void * pupper,  CBF_COMPARE  cbfcmp);
+/* Functions for B-plus trees with inline keys. */
+bool            treInitBPTF            (P_BPT_F         pbpt,    size_t       size,   size_t        degree);
+void            treFreeBPTF            (P_BPT_F         pbpt);
+P_BPT_F         treCreateBPTF          (size_t          size,    size_t       degree);
+void            treDeleteBPTF          (P_BPT_F         pbpt);
+int             treTraverseKeyBPTF     (P_BPT_F         pbpt,    CBF_TRAVERSE cbftvs, size_t        param);
+void *          treSearchBPTF          (P_BPT_F         pbpt,    const void * pkey,   CBF_COMPARE   cbfcmp);
+bool            treInsertBPTF          (P_BPT_F         pbpt,    const void * pkey,   CBF_COMPARE   cbfcmp);
+bool            treRemoveBPTF          (P_BPT_F         pbpt,    const void * pkey,   CBF_COMPARE   cbfcmp);
+#ifdef SV_MEMORY_FENCE
+bool            treSearchSharedBPTF    (P_BPT_F         pbpt,    const void * pkey,   void *        pbuf,    CBF_COMPARE  cbfcmp);
+#endif
+void            treReclaimBPTF         (P_BPT_F         pbpt);
+bool            treBPTFCursorSeek      (P_BPTCURSOR_F   pcur,    P_BPT_F      pbpt,   const void *  pkey,    CBF_COMPARE  cbfcmp);
+size_t          treBPTFCursorFetch     (P_BPTCURSOR_F   pcur,    PUCHAR       pkeys[], size_t       num,     const void * pupper,  CBF_COMPARE  cbfcmp);
+/* Functions for paged B-plus trees. */
+bool            treOpenBPTP            (P_BPT_P         pbpt,    const char * name,   size_t        size,    size_t       pagesize, size_t      frames);
+bool            treCloseBPTP           (P_BPT_P         pbpt);
+bool            treCommitBPTP          (P_BPT_P         pbpt);
+int             treTraverseKeyBPTP     (P_BPT_P         pbpt,    CBF_TRAVERSE cbftvs, size_t        param);
+bool            treSearchBPTP          (P_BPT_P         pbpt,    void *       pkey,   CBF_COMPARE   cbfcmp);
+bool            treInsertBPTP          (P_BPT_P         pbpt,    const void * pkey,   CBF_COMPARE   cbfcmp);
+bool            treRemoveBPTP          (P_BPT_P         pbpt,    const void * pkey,   CBF_COMPARE   cbfcmp);
+bool            treBulkLoadBPTP        (P_BPT_P         pbpt,    const void * pkeys,  size_t        num);
+/* Functions for B-plus trees with string keys. */
+void            treInitBPTS            (P_BPT_S         pbpt,    size_t       nodesize);
+void            treFreeBPTS            (P_BPT_S         pbpt);
+P_BPT_S         treCreateBPTS          (size_t          nodesize);
+void            treDeleteBPTS          (P_BPT_S         pbpt);
+int             treTraverseKeyBPTS     (P_BPT_S         pbpt,    CBF_TRAVERSE cbftvs, size_t        param);
+bool            treSearchBPTS          (P_BPT_S         pbpt,    const char * pstr);
+bool            treInsertBPTS          (P_BPT_S         pbpt,    const char * pstr);
+bool            treRemoveBPTS          (P_BPT_S         pbpt,    const char * pstr);
 /* Functions for tries. */
 void            treInitTrieA_O         (P_TRIE_A        ptrie);
 void            treFreeTrieA_O         (P_TRIE_A        ptrie,   size_t       size);
@@ -215,6 +429,30 @@ void            treDeleteTrieA_O       (P_TRIE_A        ptrie,   size_t       si
 size_t *        treSearchTrieA         (P_TRIE_A        ptrie,   const void * pstr,   size_t        num,     size_t       size,    CBF_COMPARE  cbfcmp);
 bool            treInsertTrieA         (P_TRIE_A        ptrie,   const void * pstr,   size_t        num,     size_t       size,    size_t       vapdx,   CBF_COMPARE cbfcmp);
 bool            treRemoveTrieA         (P_TRIE_A        ptrie,   const void * pstr,   size_t        num,     size_t       size,    CBF_COMPARE  cbfcmp);
+P_TRIE_A        treSeekPrefixTrieA     (P_TRIE_A        ptrie,   const void * pstr,   size_t        num,     size_t       size,    CBF_COMPARE  cbfcmp);
+size_t          treCompleteTrieA       (P_TRIE_A        ptrie,   const void * pstr,   size_t        num,     size_t       size,    size_t       limit,   CBF_COMPARE cbfcmp, CBF_TRAVERSE cbftvs, size_t param);
+size_t          treTopKTrieA           (P_TRIE_A        ptrie,   const void * pstr,   size_t        num,     size_t       size,    size_t       k,       CBF_COMPARE cbfcmp, CBF_TRAVERSE cbftvs, size_t param);
+size_t          treFuzzySearchTrieA    (P_TRIE_A        ptrie,   const void * pstr,   size_t        num,     size_t       size,    size_t       bound,   CBF_COMPARE cbfcmp, CBF_TRAVERSE cbftvs, size_t param);
+void *          treFlattenTrieA        (P_TRIE_A        ptrie,   size_t       size,   size_t *      plen);
+const size_t *  treSearchFlatTrieA     (const void *    pflat,   const void * pstr,   size_t        num,     CBF_COMPARE  cbfcmp);
+/* Functions for double-array tries. */
+void            treInitTrieD           (P_TRIE_D        ptrie);
+void            treFreeTrieD           (P_TRIE_D        ptrie);
+P_TRIE_D        treCreateTrieD         (void);
+void            treDeleteTrieD         (P_TRIE_D        ptrie);
+size_t *        treSearchTrieD         (P_TRIE_D        ptrie,   const void * pstr,   size_t        num);
+bool            treInsertTrieD         (P_TRIE_D        ptrie,   const void * pstr,   size_t        num,     size_t       vapdx);
+bool            treRemoveTrieD         (P_TRIE_D        ptrie,   const void * pstr,   size_t        num);
+bool            treBuildTrieD          (P_TRIE_D        ptrie,   const void * pstrs[], const size_t  lens[],  const size_t vapdx[], size_t      num);
+/* Functions for adaptive radix tries. */
+void            treInitTrieR           (P_TRIE_R        ptrie);
+void            treFreeTrieR           (P_TRIE_R        ptrie);
+P_TRIE_R        treCreateTrieR         (void);
+void            treDeleteTrieR         (P_TRIE_R        ptrie);
+size_t *        treSearchTrieR         (P_TRIE_R        ptrie,   const void * pstr,   size_t        num,     size_t       size);
+bool            treInsertTrieR         (P_TRIE_R        ptrie,   const void * pstr,   size_t        num,     size_t       size,    size_t       vapdx);
+bool            treRemoveTrieR         (P_TRIE_R        ptrie,   const void * pstr,   size_t        num,     size_t       size);
+int             treTraverseTrieR       (P_TRIE_R        ptrie,   CBF_TRAVERSE cbftvs, size_t        param);
 /* Functions for Huffman coding trees. */
 P_ARRAY_Z       treCreateHuffmanTable  (const char *    str,     size_t       num);
 P_BITSTREAM     treHuffmanEncoding     (P_ARRAY_Z       ptable,  const char * str,    size_t        num);